@@ -0,0 +1,936 @@
+///////////////////////////////////////////////////////////////////////////////
+///  Copyright 2012 Garnel
+///
+///  Licensed under the Apache License, Version 2.0 (the "License");
+///  you may not use this file except in compliance with the License.
+///  You may obtain a copy of the License at
+///
+///    http://www.apache.org/licenses/LICENSE-2.0
+///
+///  Unless required by applicable law or agreed to in writing, software
+///  distributed under the License is distributed on an "AS IS" BASIS,
+///  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///////////////////////////////////////////////////////////////////////////////
+
+///
+/// \file       json_bench.cpp
+/// The benchmark of parse, serialization and lookup
+/// \author     Garnel
+/// \date       2026/10/15
+/// \version    2.3
+/// \copyright  Apache License, Version 2.0
+///
+/// The corpus is generated in memory, in the shapes of the usual json
+/// benchmarks: string-heavy (like twitter.json), float-heavy (like
+/// canada.json), records of ids (like citm_catalog.json), deep, wide and
+/// NDJSON. Every corpus is parsed with run() (next_document for NDJSON),
+/// printed with output(), and searched with get_child_by_label,
+/// get_member and compiled json_pointer. The pointers are also extracted
+/// straight from the text by json_projection, from the first record of a
+/// collection.
+///
+/// The results are printed as json on stdout, or into the file of
+/// --output, and as a table on stderr:
+///
+///     json_bench [--iterations N] [--scale X] [--corpus NAME] [--output FILE]
+///
+/// peak_rss_kb is the peak of the process when the measure ends, so it
+/// grows along the run and the first corpus gives the lowest bound.
+///
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+#include "json_lite.h"
+#include "json_pointer.h"
+#include "json_projection.h"
+#include "json_serializer.h"
+#include "json_writer.h"
+
+using namespace json_lite;
+
+namespace
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // the corpus
+    ///////////////////////////////////////////////////////////////////////////
+
+    ///
+    /// \class  random_text
+    /// \brief  Numbers and words from a fixed seed, so every run parses the same text
+    ///
+    class random_text
+    {
+    public:
+        random_text()
+            :state(0x9E3779B97F4A7C15ULL)
+        {
+        }
+
+        // a number in [0, bound)
+        uint64_t next(uint64_t bound)
+        {
+            state ^= state << 13;
+            state ^= state >> 7;
+            state ^= state << 17;
+            return state % bound;
+        }
+
+        // a number in [low, high), with 15 significant digits like measured coordinates
+        double real(double low, double high)
+        {
+            return low + (high - low) * (double)this->next(1000000000000000ULL) / 1e15;
+        }
+
+        std::string word()
+        {
+            static const char *words[] = {
+                "json", "lite", "parse", "the", "stream", "of", "value", "caf\xC3\xA9",
+                "\xE6\x97\xA5\xE6\x9C\xAC", "quote\"d", "tab\there", "array", "object", "number",
+                "\xF0\x9F\x98\x80", "line\nbreak", "and", "a", "fast", "slow"
+            };
+            return words[this->next(sizeof(words) / sizeof(words[0]))];
+        }
+
+        std::string sentence(size_t count)
+        {
+            std::string text = this->word();
+            for (size_t i = 1; i < count; i++)
+                text += " " + this->word();
+            return text;
+        }
+
+    private:
+        uint64_t state;     ///< the state of xorshift64
+    };
+
+    ///
+    /// \struct bench_corpus
+    /// \brief  A json text and the lookups in it
+    ///
+    struct bench_corpus
+    {
+        std::string name;                   ///< the name in the results
+        std::string text;                   ///< the json, or a json per line
+        bool ndjson;                        ///< parsed with next_document
+        std::string collection;             ///< the member of the root holding the records, empty for the root
+        std::vector<std::string> labels;    ///< the labels looked up in every record
+        std::vector<std::string> pointers;  ///< the pointers resolved from every record
+    };
+
+    // generate_twitter
+    void generate_twitter(bench_corpus &corpus, size_t count, random_text &random)
+    {
+        json_buffer buffer;
+        json_writer writer(buffer, json_format(false));
+        writer.begin_object();
+        writer.key("statuses");
+        writer.begin_array();
+        for (size_t i = 0; i < count; i++)
+        {
+            writer.begin_object();
+            writer.key("created_at");
+            writer.value("Sun Aug 31 00:29:15 +0000 2014");
+            writer.key("id");
+            writer.value((int64_t)(505874924095815681LL + i));
+            writer.key("id_str");
+            writer.value(std::to_string(505874924095815681LL + i));
+            writer.key("text");
+            writer.value(random.sentence(8 + random.next(16)));
+            writer.key("user");
+            writer.begin_object();
+            writer.key("id");
+            writer.value((int64_t)random.next(3000000000ULL));
+            writer.key("name");
+            writer.value(random.sentence(2));
+            writer.key("screen_name");
+            writer.value("user_" + std::to_string(random.next(100000)));
+            writer.key("description");
+            writer.value(random.sentence(4 + random.next(12)));
+            writer.key("followers_count");
+            writer.value((int)random.next(100000));
+            writer.key("verified");
+            writer.value(random.next(10) == 0);
+            writer.key("profile_image_url");
+            writer.null();
+            writer.end_object();
+            writer.key("entities");
+            writer.begin_object();
+            writer.key("hashtags");
+            writer.begin_array();
+            for (uint64_t k = random.next(4); k > 0; k--)
+            {
+                writer.begin_object();
+                writer.key("text");
+                writer.value(random.word());
+                writer.key("indices");
+                writer.begin_array();
+                writer.value((int)random.next(70));
+                writer.value((int)random.next(70) + 70);
+                writer.end_array();
+                writer.end_object();
+            }
+            writer.end_array();
+            writer.key("urls");
+            writer.begin_array();
+            writer.end_array();
+            writer.end_object();
+            writer.key("retweet_count");
+            writer.value((int)random.next(1000));
+            writer.key("favorited");
+            writer.value(false);
+            writer.key("lang");
+            writer.value("ja");
+            writer.end_object();
+        }
+        writer.end_array();
+        writer.key("search_metadata");
+        writer.begin_object();
+        writer.key("count");
+        writer.value((int)count);
+        writer.key("completed_in");
+        writer.value(0.087);
+        writer.end_object();
+        writer.end_object();
+
+        corpus.name = "twitter";
+        corpus.text = buffer.get_string();
+        corpus.ndjson = false;
+        corpus.collection = "statuses";
+        corpus.labels.push_back("id");
+        corpus.labels.push_back("text");
+        corpus.labels.push_back("screen_name");
+        corpus.labels.push_back("hashtags");
+        corpus.pointers.push_back("/id");
+        corpus.pointers.push_back("/user/screen_name");
+        corpus.pointers.push_back("/entities/hashtags/0/text");
+    }
+
+    // generate_canada
+    void generate_canada(bench_corpus &corpus, size_t count, random_text &random)
+    {
+        json_buffer buffer;
+        json_writer writer(buffer, json_format(false));
+        writer.begin_object();
+        writer.key("type");
+        writer.value("FeatureCollection");
+        writer.key("features");
+        writer.begin_array();
+        for (size_t i = 0; i < count; i++)
+        {
+            writer.begin_object();
+            writer.key("type");
+            writer.value("Feature");
+            writer.key("properties");
+            writer.begin_object();
+            writer.key("name");
+            writer.value("Canada");
+            writer.end_object();
+            writer.key("geometry");
+            writer.begin_object();
+            writer.key("type");
+            writer.value("Polygon");
+            writer.key("coordinates");
+            writer.begin_array();
+            for (int ring = 0; ring < 4; ring++)
+            {
+                writer.begin_array();
+                for (int point = 0; point < 64; point++)
+                {
+                    writer.begin_array();
+                    writer.value(random.real(-141.0, -52.0));
+                    writer.value(random.real(41.0, 83.0));
+                    writer.end_array();
+                }
+                writer.end_array();
+            }
+            writer.end_array();
+            writer.end_object();
+            writer.end_object();
+        }
+        writer.end_array();
+        writer.end_object();
+
+        corpus.name = "canada";
+        corpus.text = buffer.get_string();
+        corpus.ndjson = false;
+        corpus.collection = "features";
+        corpus.labels.push_back("type");
+        corpus.labels.push_back("name");
+        corpus.labels.push_back("coordinates");
+        corpus.pointers.push_back("/properties/name");
+        corpus.pointers.push_back("/geometry/coordinates/0/10/1");
+    }
+
+    // generate_citm
+    void generate_citm(bench_corpus &corpus, size_t count, random_text &random)
+    {
+        json_buffer buffer;
+        json_writer writer(buffer, json_format(false));
+        writer.begin_object();
+        writer.key("areaNames");
+        writer.begin_object();
+        for (int i = 0; i < 64; i++)
+        {
+            writer.key(std::to_string(205705993 + i));
+            writer.value(random.sentence(3));
+        }
+        writer.end_object();
+        writer.key("performances");
+        writer.begin_array();
+        for (size_t i = 0; i < count; i++)
+        {
+            writer.begin_object();
+            writer.key("eventId");
+            writer.value((int64_t)(138586341 + random.next(1000)));
+            writer.key("id");
+            writer.value((int64_t)(339887544 + i));
+            writer.key("logo");
+            writer.null();
+            writer.key("name");
+            writer.null();
+            writer.key("prices");
+            writer.begin_array();
+            for (uint64_t k = 1 + random.next(6); k > 0; k--)
+            {
+                writer.begin_object();
+                writer.key("amount");
+                writer.value((int)(random.next(200) * 1000 + 90250));
+                writer.key("audienceSubCategoryId");
+                writer.value((int64_t)337100890);
+                writer.key("seatCategoryId");
+                writer.value((int64_t)(338937295 + random.next(20)));
+                writer.end_object();
+            }
+            writer.end_array();
+            writer.key("seatCategories");
+            writer.begin_array();
+            for (uint64_t k = 1 + random.next(4); k > 0; k--)
+            {
+                writer.begin_object();
+                writer.key("areas");
+                writer.begin_array();
+                for (uint64_t a = 1 + random.next(8); a > 0; a--)
+                {
+                    writer.begin_object();
+                    writer.key("areaId");
+                    writer.value((int64_t)(205705993 + random.next(64)));
+                    writer.key("blockIds");
+                    writer.begin_array();
+                    writer.end_array();
+                    writer.end_object();
+                }
+                writer.end_array();
+                writer.key("seatCategoryId");
+                writer.value((int64_t)(338937295 + random.next(20)));
+                writer.end_object();
+            }
+            writer.end_array();
+            writer.key("start");
+            writer.value((int64_t)(1372615200000LL + (int64_t)i * 3600000));
+            writer.key("venueCode");
+            writer.value("PLEYEL_PLEYEL");
+            writer.end_object();
+        }
+        writer.end_array();
+        writer.end_object();
+
+        corpus.name = "citm";
+        corpus.text = buffer.get_string();
+        corpus.ndjson = false;
+        corpus.collection = "performances";
+        corpus.labels.push_back("eventId");
+        corpus.labels.push_back("seatCategoryId");
+        corpus.labels.push_back("venueCode");
+        corpus.pointers.push_back("/venueCode");
+        corpus.pointers.push_back("/prices/0/amount");
+        corpus.pointers.push_back("/seatCategories/0/areas/0/areaId");
+    }
+
+    // generate_deep
+    void generate_deep(bench_corpus &corpus, size_t depth, random_text &random)
+    {
+        json_buffer buffer;
+        json_writer writer(buffer, json_format(false));
+        writer.begin_object();
+        writer.key("copies");
+        writer.begin_array();
+        for (int copy = 0; copy < 8; copy++)
+        {
+            for (size_t i = 0; i < depth; i++)
+            {
+                writer.begin_object();
+                writer.key("level");
+                writer.value((int)i);
+                writer.key("name");
+                writer.value(random.word());
+                writer.key("next");
+                writer.begin_array();
+            }
+            writer.begin_object();
+            writer.key("leaf");
+            writer.value(true);
+            writer.end_object();
+            for (size_t i = 0; i < depth; i++)
+            {
+                writer.end_array();
+                writer.end_object();
+            }
+        }
+        writer.end_array();
+        writer.end_object();
+
+        corpus.name = "deep";
+        corpus.text = buffer.get_string();
+        corpus.ndjson = false;
+        corpus.collection = "copies";
+        corpus.labels.push_back("name");
+        corpus.labels.push_back("leaf");
+        corpus.pointers.push_back("/name");
+        corpus.pointers.push_back("/next/0/next/0/next/0/name");
+    }
+
+    // generate_wide
+    void generate_wide(bench_corpus &corpus, size_t count, random_text &random)
+    {
+        json_buffer buffer;
+        json_writer writer(buffer, json_format(false));
+        writer.begin_object();
+        for (size_t i = 0; i < count; i++)
+        {
+            writer.key("key_" + std::to_string(i));
+            if (i % 2)
+                writer.value(random.word());
+            else
+                writer.value((int64_t)random.next(1000000));
+        }
+        writer.end_object();
+
+        corpus.name = "wide";
+        corpus.text = buffer.get_string();
+        corpus.ndjson = false;
+        for (size_t i = 0; i < 64; i++)
+        {
+            corpus.labels.push_back("key_" + std::to_string(i * count / 64));
+            corpus.pointers.push_back("/" + corpus.labels.back());
+        }
+    }
+
+    // generate_ndjson
+    void generate_ndjson(bench_corpus &corpus, size_t count, random_text &random)
+    {
+        // a json per line, since the writer is compact
+        json_buffer buffer;
+        json_writer writer(buffer, json_format(false));
+        for (size_t i = 0; i < count; i++)
+        {
+            writer.begin_object();
+            writer.key("id");
+            writer.value((int64_t)i);
+            writer.key("time");
+            writer.value(1409444955.0 + random.real(0, 1000));
+            writer.key("level");
+            writer.value(random.next(4) == 0 ? "error" : "info");
+            writer.key("message");
+            writer.value(random.sentence(4 + random.next(8)));
+            writer.key("tags");
+            writer.begin_array();
+            for (uint64_t k = random.next(4); k > 0; k--)
+                writer.value(random.word());
+            writer.end_array();
+            writer.key("request");
+            writer.begin_object();
+            writer.key("method");
+            writer.value("GET");
+            writer.key("status");
+            writer.value(200 + (int)random.next(4) * 100);
+            writer.key("latency_ms");
+            writer.value(random.real(0.5, 900.0));
+            writer.end_object();
+            writer.end_object();
+        }
+
+        corpus.name = "ndjson";
+        corpus.text = buffer.get_string();
+        corpus.ndjson = true;
+        corpus.labels.push_back("level");
+        corpus.labels.push_back("status");
+        corpus.pointers.push_back("/level");
+        corpus.pointers.push_back("/request/status");
+        corpus.pointers.push_back("/tags/0");
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    // the measures
+    ///////////////////////////////////////////////////////////////////////////
+
+    ///
+    /// \struct bench_result
+    /// \brief  The times of an operation over a corpus
+    ///
+    struct bench_result
+    {
+        std::string corpus;             ///< the name of the corpus
+        std::string operation;          ///< parse, serialize, lookup, member, pointer or project
+        size_t iterations;              ///< the passes over the corpus measured
+        size_t bytes;                   ///< the bytes of json of a pass, 0 for lookup and member
+        size_t documents;               ///< the documents of a pass
+        size_t lookups;                 ///< the lookups of a pass, 0 for parse and serialize
+        size_t found;                   ///< the lookups of a pass finding a value
+        double seconds;                 ///< the time of all the passes
+        std::vector<double> latencies;  ///< the time of every document, in seconds
+        long peak_rss_kb;               ///< the peak resident memory of the process so far
+    };
+
+    // now
+    double now()
+    {
+        return std::chrono::duration<double>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    // peak_rss_kb
+    long peak_rss_kb()
+    {
+#ifdef _WIN32
+        PROCESS_MEMORY_COUNTERS counters;
+        if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+            return (long)(counters.PeakWorkingSetSize / 1024);
+        return 0;
+#else
+        struct rusage usage;
+        if (getrusage(RUSAGE_SELF, &usage) != 0)
+            return 0;
+#ifdef __APPLE__
+        return (long)(usage.ru_maxrss / 1024);  //in bytes
+#else
+        return (long)usage.ru_maxrss;           //in kilobytes
+#endif
+#endif
+    }
+
+    // percentile, by the nearest rank
+    double percentile(std::vector<double> sorted, double p)
+    {
+        if (sorted.empty())
+            return 0;
+        std::sort(sorted.begin(), sorted.end());
+        size_t rank = (size_t)(p * sorted.size() + 0.999999);
+        return sorted[rank ? rank - 1 : 0];
+    }
+
+    // parse_corpus, giving back the documents
+    bool parse_corpus(const bench_corpus &corpus, std::vector<json_value*> &documents,
+        std::vector<double> *latencies)
+    {
+        json_parser parser(corpus.text.data(), corpus.text.size());
+        json_parse_result result;
+        while (true)
+        {
+            double start = now();
+            json_value *doc = corpus.ndjson ? parser.next_document(result) : parser.run(result);
+            if (result.failed)
+            {
+                std::cerr << corpus.name << ": line " << result.line << ", column " << result.column
+                          << ": " << error_value(result.error) << std::endl;
+                return false;
+            }
+            if (!doc)  //the end of the stream
+                break;
+            if (latencies)
+                latencies->push_back(now() - start);
+            documents.push_back(doc);
+            if (!corpus.ndjson)
+                break;
+        }
+        return true;
+    }
+
+    // free_documents
+    void free_documents(std::vector<json_value*> &documents)
+    {
+        for (size_t i = 0; i < documents.size(); i++)
+            delete documents[i];
+        documents.clear();
+    }
+
+    // get_records, the elements searched for the labels
+    void get_records(const bench_corpus &corpus, const std::vector<json_value*> &documents,
+        std::vector<const json_value*> &records)
+    {
+        for (size_t i = 0; i < documents.size(); i++)
+        {
+            const json_value *collection = corpus.collection.empty()
+                ? documents[i] : documents[i]->get_member(corpus.collection);
+            if (!collection)
+                continue;
+            if (corpus.collection.empty() || collection->get_type() != JSON_ARRAY)
+                records.push_back(collection);
+            else
+                for (const json_value *elem = collection->get_first_child(); elem; elem = elem->get_next())
+                    records.push_back(elem);
+        }
+    }
+
+    // measure_parse
+    bool measure_parse(const bench_corpus &corpus, size_t iterations, bench_result &result)
+    {
+        std::vector<json_value*> documents;
+        if (!parse_corpus(corpus, documents, NULL))  //warm up
+            return false;
+        result.documents = documents.size();
+        free_documents(documents);
+
+        result.bytes = corpus.text.size();
+        double start = now();
+        for (size_t i = 0; i < iterations; i++)
+        {
+            parse_corpus(corpus, documents, &result.latencies);
+            free_documents(documents);
+        }
+        result.seconds = now() - start;
+        return true;
+    }
+
+    // measure_serialize
+    bool measure_serialize(const bench_corpus &corpus, size_t iterations, bench_result &result)
+    {
+        std::vector<json_value*> documents;
+        if (!parse_corpus(corpus, documents, NULL))
+            return false;
+        result.documents = documents.size();
+
+        std::ostringstream stream;
+        json_format format(false);
+        for (size_t i = 0; i < documents.size(); i++)  //warm up, and the size of the output
+            documents[i]->output(stream, format);
+        result.bytes = (size_t)stream.tellp();
+
+        double start = now();
+        for (size_t i = 0; i < iterations; i++)
+        {
+            for (size_t k = 0; k < documents.size(); k++)
+            {
+                double doc_start = now();
+                stream.str(std::string());
+                documents[k]->output(stream, format);
+                result.latencies.push_back(now() - doc_start);
+            }
+        }
+        result.seconds = now() - start;
+        free_documents(documents);
+        return true;
+    }
+
+    // measure_lookup, with get_child_by_label (searching the record) or get_member
+    bool measure_lookup(const bench_corpus &corpus, size_t iterations, bool member, bench_result &result)
+    {
+        std::vector<json_value*> documents;
+        if (!parse_corpus(corpus, documents, NULL))
+            return false;
+        std::vector<const json_value*> records;
+        get_records(corpus, documents, records);
+        result.documents = documents.size();
+        result.lookups = records.size() * corpus.labels.size();
+
+        double start = now();
+        for (size_t i = 0; i <= iterations; i++)
+        {
+            if (i == 1)  //the first pass warms up, and builds the member indexes
+                start = now();
+            for (size_t k = 0; k < records.size(); k++)
+            {
+                double record_start = now();
+                for (size_t l = 0; l < corpus.labels.size(); l++)
+                {
+                    const json_value *value = member ? records[k]->get_member(corpus.labels[l])
+                        : records[k]->get_child_by_label(corpus.labels[l]);
+                    if (value && i == 0)
+                        result.found++;
+                }
+                if (i > 0)
+                    result.latencies.push_back(now() - record_start);
+            }
+        }
+        result.seconds = now() - start;
+        free_documents(documents);
+        return true;
+    }
+
+    // measure_pointer, with the pointers compiled before the passes
+    bool measure_pointer(const bench_corpus &corpus, size_t iterations, bench_result &result)
+    {
+        std::vector<json_value*> documents;
+        if (!parse_corpus(corpus, documents, NULL))
+            return false;
+        std::vector<const json_value*> records;
+        get_records(corpus, documents, records);
+        std::vector<json_pointer> pointers;
+        for (size_t l = 0; l < corpus.pointers.size(); l++)
+            pointers.push_back(json_pointer(corpus.pointers[l]));
+        result.documents = documents.size();
+        result.lookups = records.size() * pointers.size();
+
+        double start = now();
+        for (size_t i = 0; i <= iterations; i++)
+        {
+            if (i == 1)  //the first pass warms up, and builds the member indexes
+                start = now();
+            for (size_t k = 0; k < records.size(); k++)
+            {
+                double record_start = now();
+                for (size_t l = 0; l < pointers.size(); l++)
+                {
+                    const json_value *value = pointers[l].resolve(records[k]);
+                    if (value && i == 0)
+                        result.found++;
+                }
+                if (i > 0)
+                    result.latencies.push_back(now() - record_start);
+            }
+        }
+        result.seconds = now() - start;
+        free_documents(documents);
+        return true;
+    }
+
+    // measure_project, extracting the pointers from the text without building the tree
+    bool measure_project(const bench_corpus &corpus, size_t iterations, bench_result &result)
+    {
+        json_projection projection;
+        for (size_t l = 0; l < corpus.pointers.size(); l++)
+            projection.add_path(corpus.collection.empty() ? corpus.pointers[l]
+                : "/" + corpus.collection + "/0" + corpus.pointers[l]);
+        result.bytes = corpus.text.size();
+
+        double start = now();
+        for (size_t i = 0; i <= iterations; i++)
+        {
+            if (i == 1)  //the first pass warms up
+                start = now();
+            json_parser parser(corpus.text.data(), corpus.text.size());
+            json_parse_result parse_result;
+            while (true)
+            {
+                double doc_start = now();
+                bool done = corpus.ndjson ? projection.next_document(parser, parse_result)
+                    : projection.run(parser, parse_result);
+                if (parse_result.failed)
+                {
+                    std::cerr << corpus.name << ": line " << parse_result.line << ", column "
+                              << parse_result.column << ": " << error_value(parse_result.error) << std::endl;
+                    return false;
+                }
+                if (!done)  //the end of the stream
+                    break;
+                if (i > 0)
+                    result.latencies.push_back(now() - doc_start);
+                if (i == 0)
+                {
+                    result.documents++;
+                    result.lookups += projection.size();
+                    for (size_t l = 0; l < projection.size(); l++)
+                        result.found += projection.get_value(l) != NULL;
+                }
+                if (!corpus.ndjson)
+                    break;
+            }
+        }
+        result.seconds = now() - start;
+        return true;
+    }
+
+    // write_results
+    void write_results(std::ostream &stream, const std::vector<bench_corpus> &corpora,
+        const std::vector<bench_result> &results, double scale)
+    {
+        json_buffer buffer(stream);
+        json_writer writer(buffer, json_format(true, ' ', 2));
+        writer.begin_object();
+        writer.key("scale");
+        writer.value(scale);
+        writer.key("corpora");
+        writer.begin_array();
+        for (size_t i = 0; i < corpora.size(); i++)
+        {
+            writer.begin_object();
+            writer.key("name");
+            writer.value(corpora[i].name);
+            writer.key("bytes");
+            writer.value((uint64_t)corpora[i].text.size());
+            writer.end_object();
+        }
+        writer.end_array();
+        writer.key("results");
+        writer.begin_array();
+        for (size_t i = 0; i < results.size(); i++)
+        {
+            const bench_result &result = results[i];
+            double seconds = result.seconds > 0 ? result.seconds : 1e-9;
+            writer.begin_object();
+            writer.key("corpus");
+            writer.value(result.corpus);
+            writer.key("operation");
+            writer.value(result.operation);
+            writer.key("iterations");
+            writer.value((uint64_t)result.iterations);
+            writer.key("bytes");
+            writer.value((uint64_t)result.bytes);
+            writer.key("documents");
+            writer.value((uint64_t)result.documents);
+            writer.key("seconds");
+            writer.value(result.seconds);
+            if (result.bytes)
+            {
+                writer.key("mb_per_s");
+                writer.value(result.bytes * result.iterations / seconds / 1e6);
+            }
+            writer.key("documents_per_s");
+            writer.value(result.documents * result.iterations / seconds);
+            if (result.lookups)
+            {
+                writer.key("lookups");
+                writer.value((uint64_t)result.lookups);
+                writer.key("lookups_per_s");
+                writer.value(result.lookups * result.iterations / seconds);
+                writer.key("found");
+                writer.value((uint64_t)result.found);
+            }
+            writer.key("p50_us");
+            writer.value(percentile(result.latencies, 0.50) * 1e6);
+            writer.key("p99_us");
+            writer.value(percentile(result.latencies, 0.99) * 1e6);
+            writer.key("peak_rss_kb");
+            writer.value((int64_t)result.peak_rss_kb);
+            writer.end_object();
+        }
+        writer.end_array();
+        writer.end_object();
+        buffer.put('\n');
+    }
+
+    // usage
+    int usage()
+    {
+        std::cerr << "usage: json_bench [--iterations N] [--scale X] [--corpus NAME] [--output FILE]\n"
+                  << "  corpora: twitter canada citm deep wide ndjson" << std::endl;
+        return 2;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    size_t iterations = 10;
+    double scale = 1.0;
+    std::string only, output;
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if (i + 1 == argc)
+            return usage();
+        if (arg == "--iterations")
+            iterations = (size_t)atol(argv[++i]);
+        else if (arg == "--scale")
+            scale = atof(argv[++i]);
+        else if (arg == "--corpus")
+            only = argv[++i];
+        else if (arg == "--output")
+            output = argv[++i];
+        else
+            return usage();
+    }
+    if (iterations == 0 || scale <= 0)
+        return usage();
+
+    // about 4MB each at scale 1
+    random_text random;
+    std::vector<bench_corpus> corpora(6);
+    generate_twitter(corpora[0], (size_t)(5000 * scale) + 1, random);
+    generate_canada(corpora[1], (size_t)(500 * scale) + 1, random);
+    generate_citm(corpora[2], (size_t)(5000 * scale) + 1, random);
+    generate_deep(corpora[3], (size_t)(4000 * scale) + 1, random);
+    generate_wide(corpora[4], (size_t)(200000 * scale) + 64, random);
+    generate_ndjson(corpora[5], (size_t)(20000 * scale) + 1, random);
+    if (!only.empty())
+    {
+        size_t i = 0;
+        while (i < corpora.size() && corpora[i].name != only)
+            i++;
+        if (i == corpora.size())
+            return usage();
+        corpora = std::vector<bench_corpus>(1, corpora[i]);
+    }
+
+    const char *operations[] = {"parse", "serialize", "lookup", "member", "pointer", "project"};
+    std::vector<bench_result> results;
+    bool good = true;
+    fprintf(stderr, "%-8s %-10s %10s %12s %12s %10s %10s %10s\n",
+        "corpus", "operation", "MB/s", "docs/s", "lookups/s", "p50 us", "p99 us", "RSS KB");
+    for (size_t c = 0; c < corpora.size(); c++)
+    {
+        for (size_t o = 0; o < sizeof(operations) / sizeof(operations[0]); o++)
+        {
+            bench_result result;
+            result.corpus = corpora[c].name;
+            result.operation = operations[o];
+            result.iterations = iterations;
+            result.bytes = result.documents = result.lookups = result.found = 0;
+            result.seconds = 0;
+
+            bool done;
+            if (o == 0)
+                done = measure_parse(corpora[c], iterations, result);
+            else if (o == 1)
+                done = measure_serialize(corpora[c], iterations, result);
+            else if (o == 4)
+                done = measure_pointer(corpora[c], iterations, result);
+            else if (o == 5)
+                done = measure_project(corpora[c], iterations, result);
+            else
+                done = measure_lookup(corpora[c], iterations, o == 3, result);
+            result.peak_rss_kb = peak_rss_kb();
+            if (!done)
+            {
+                std::cerr << corpora[c].name << ": " << operations[o] << " failed" << std::endl;
+                good = false;
+                continue;
+            }
+
+            double seconds = result.seconds > 0 ? result.seconds : 1e-9;
+            fprintf(stderr, "%-8s %-10s %10.1f %12.1f %12.0f %10.1f %10.1f %10ld\n",
+                result.corpus.c_str(), result.operation.c_str(),
+                result.bytes * result.iterations / seconds / 1e6,
+                result.documents * result.iterations / seconds,
+                result.lookups * result.iterations / seconds,
+                percentile(result.latencies, 0.50) * 1e6,
+                percentile(result.latencies, 0.99) * 1e6, result.peak_rss_kb);
+            results.push_back(result);
+        }
+    }
+
+    if (output.empty())
+        write_results(std::cout, corpora, results, scale);
+    else
+    {
+        std::ofstream file(output.c_str());
+        write_results(file, corpora, results, scale);
+    }
+    return good ? 0 : 1;
+}
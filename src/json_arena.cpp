@@ -0,0 +1,124 @@
+///////////////////////////////////////////////////////////////////////////////
+///  Copyright 2012 Garnel
+///
+///  Licensed under the Apache License, Version 2.0 (the "License");
+///  you may not use this file except in compliance with the License.
+///  You may obtain a copy of the License at
+///
+///    http://www.apache.org/licenses/LICENSE-2.0
+///
+///  Unless required by applicable law or agreed to in writing, software
+///  distributed under the License is distributed on an "AS IS" BASIS,
+///  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///////////////////////////////////////////////////////////////////////////////
+
+///
+/// \file       json_arena.cpp
+/// The implementation of class json_arena
+/// \author     Garnel
+/// \date       2026/10/15
+/// \version    2.3
+/// \copyright  Apache License, Version 2.0
+///
+
+#include "json_arena.h"
+
+#include <cassert>
+
+///
+/// \namespace  json_lite
+///
+namespace json_lite
+{
+    // json_arena
+    json_arena::json_arena(size_t _block_size)
+        :block_size(_block_size),
+         current(0),
+         cursor(NULL),
+         limit(NULL)
+    {
+        assert(block_size > 0);
+    }
+
+    // ~json_arena
+    json_arena::~json_arena()
+    {
+        for (size_t i = 0; i < blocks.size(); i++)
+            delete[] blocks[i].data;
+        blocks.clear();
+    }
+
+    // allocate
+    void* json_arena::allocate(size_t size, size_t align)
+    {
+        assert(align && (align & (align - 1)) == 0);
+        char *p = (char*)(((size_t)cursor + align - 1) & ~(align - 1));
+        if (cursor == NULL || p + size > limit)  //the block in use is full
+        {
+            this->next_block(size + align);
+            p = (char*)(((size_t)cursor + align - 1) & ~(align - 1));
+        }
+        cursor = p + size;
+        return p;
+    }
+
+    // reset
+    void json_arena::reset()
+    {
+        current = 0;
+        if (blocks.empty())
+            return;
+        cursor = blocks[0].data;
+        limit = cursor + blocks[0].size;
+    }
+
+    // adopt
+    void json_arena::adopt(json_arena &other)
+    {
+        assert(&other != this);
+
+        // the blocks used by the other arena go before the block in use, as used,
+        // and its blocks kept by reset() go after all, to be reused
+        size_t used = other.cursor != NULL ? other.current + 1 : 0;
+        blocks.insert(blocks.begin() + current, other.blocks.begin(), other.blocks.begin() + used);
+        current += used;
+        blocks.insert(blocks.end(), other.blocks.begin() + used, other.blocks.end());
+
+        other.blocks.clear();
+        other.current = 0;
+        other.cursor = NULL;
+        other.limit = NULL;
+    }
+
+    // get_capacity
+    size_t json_arena::get_capacity() const
+    {
+        size_t capacity = 0;
+        for (size_t i = 0; i < blocks.size(); i++)
+            capacity += blocks[i].size;
+        return capacity;
+    }
+
+    // next_block
+    void json_arena::next_block(size_t size)
+    {
+        // reuse the blocks kept by reset() first
+        if (cursor != NULL)
+            current++;
+        while (current < blocks.size() && blocks[current].size < size)
+            current++;
+
+        if (current == blocks.size())
+        {
+            block _block;
+            _block.size = size > block_size ? size : block_size;
+            _block.data = new char[_block.size];
+            blocks.push_back(_block);
+        }
+
+        cursor = blocks[current].data;
+        limit = cursor + blocks[current].size;
+    }
+}
@@ -0,0 +1,124 @@
+///////////////////////////////////////////////////////////////////////////////
+///  Copyright 2012 Garnel
+///
+///  Licensed under the Apache License, Version 2.0 (the "License");
+///  you may not use this file except in compliance with the License.
+///  You may obtain a copy of the License at
+///
+///    http://www.apache.org/licenses/LICENSE-2.0
+///
+///  Unless required by applicable law or agreed to in writing, software
+///  distributed under the License is distributed on an "AS IS" BASIS,
+///  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///////////////////////////////////////////////////////////////////////////////
+
+///
+/// \file       json_arena.h
+/// The declaration of json_arena
+/// \author     Garnel
+/// \date       2026/10/15
+/// \version    2.3
+/// \copyright  Apache License, Version 2.0
+///
+
+#ifndef JSON_LITE_ARENA
+#define JSON_LITE_ARENA
+
+#include <cstddef>
+#include <vector>
+
+namespace json_lite
+{
+    const size_t ARENA_BLOCK_SIZE = 64 * 1024;  ///< the default size of arena blocks
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// json_arena
+    ///////////////////////////////////////////////////////////////////////////
+
+    ///
+    /// \class  json_arena
+    /// \brief  A bump-pointer allocator for json trees
+    ///
+    /// Memory is carved from large blocks and never freed one by one.
+    /// reset() releases everything at once but keeps the blocks for the
+    /// next use, the blocks go back to the system only in the destructor.
+    ///
+    class json_arena
+    {
+    public:
+        ///
+        /// \fn         json_arena
+        /// \brief      The constructor of json_arena
+        /// \param      _block_size     The size of each block
+        ///
+        json_arena(size_t _block_size = ARENA_BLOCK_SIZE);
+
+        ///
+        /// \fn         ~json_arena
+        /// \brief      Free all the blocks
+        ///
+        ~json_arena();
+
+        ///
+        /// \fn         allocate
+        /// \brief      Allocate memory from the arena
+        /// \param      size    The size of the memory
+        /// \param      align   The alignment of the memory, must be a power of 2
+        /// \return     The memory, valid until reset() or the arena is destroyed
+        ///
+        void* allocate(size_t size, size_t align = sizeof(void*));
+
+        ///
+        /// \fn         reset
+        /// \brief      Release all the memory allocated at once
+        /// \note       The blocks are kept to be reused
+        ///
+        void reset();
+
+        ///
+        /// \fn         adopt
+        /// \brief      Take all the blocks of another arena, which is left empty
+        /// \param      other   The arena, NOT this one
+        /// \note       The memory allocated from the other arena stays valid until
+        ///             reset() or this arena is destroyed
+        ///
+        void adopt(json_arena &other);
+
+        ///
+        /// \fn         get_capacity
+        /// \brief      Return the total size of the blocks held
+        ///
+        size_t get_capacity() const;
+
+    private:
+        json_arena(const json_arena&);              ///< copy is not allowed
+        json_arena& operator=(const json_arena&);   ///< copy is not allowed
+
+        ///
+        /// \fn         next_block
+        /// \brief      Move to a block having at least size bytes
+        ///
+        void next_block(size_t size);
+
+    private:
+        ///
+        /// \struct block
+        /// \brief  A block of the arena
+        ///
+        struct block
+        {
+            char *data;     ///< the memory of the block
+            size_t size;    ///< the size of the block
+        };
+
+        std::vector<block> blocks;  ///< all the blocks held
+        size_t block_size;          ///< the size of a normal block
+        size_t current;             ///< the index of the block in use
+        char *cursor;               ///< the first free byte in the block in use
+        char *limit;                ///< the end of the block in use
+    };
+}
+
+#endif // JSON_LITE_ARENA
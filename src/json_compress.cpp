@@ -0,0 +1,366 @@
+///////////////////////////////////////////////////////////////////////////////
+///  Copyright 2012 Garnel
+///
+///  Licensed under the Apache License, Version 2.0 (the "License");
+///  you may not use this file except in compliance with the License.
+///  You may obtain a copy of the License at
+///
+///    http://www.apache.org/licenses/LICENSE-2.0
+///
+///  Unless required by applicable law or agreed to in writing, software
+///  distributed under the License is distributed on an "AS IS" BASIS,
+///  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///////////////////////////////////////////////////////////////////////////////
+
+///
+/// \file       json_compress.cpp
+/// The implementation of the gzip and zstd streams
+/// \author     Garnel
+/// \date       2026/10/15
+/// \version    2.3
+/// \copyright  Apache License, Version 2.0
+///
+
+#include "json_compress.h"
+
+#include <cstring>
+
+#ifdef JSON_LITE_ZLIB
+#include <zlib.h>
+#endif
+
+#ifdef JSON_LITE_ZSTD
+#include <zstd.h>
+#endif
+
+///
+/// \namespace  json_lite
+///
+namespace json_lite
+{
+    const size_t MAX_STEP = 1 << 30;    ///< the most bytes given to zlib at once, which counts in uInt
+
+    // detect_compression
+    json_compression detect_compression(const char *data, size_t length)
+    {
+        const unsigned char *p = (const unsigned char*)data;
+        if (length >= 2 && p[0] == 0x1F && p[1] == 0x8B)
+            return COMPRESS_GZIP;
+        if (length >= 4 && p[0] == 0x28 && p[1] == 0xB5 && p[2] == 0x2F && p[3] == 0xFD)
+            return COMPRESS_ZSTD;
+        return COMPRESS_NONE;
+    }
+
+    // is_compression_supported
+    bool is_compression_supported(json_compression compression)
+    {
+        switch (compression)
+        {
+        case COMPRESS_NONE:
+            return true;
+#ifdef JSON_LITE_ZLIB
+        case COMPRESS_GZIP:
+            return true;
+#endif
+#ifdef JSON_LITE_ZSTD
+        case COMPRESS_ZSTD:
+            return true;
+#endif
+        default:
+            return false;
+        }
+    }
+
+#ifdef JSON_LITE_ZLIB
+    ///////////////////////////////////////////////////////////////////////////
+    // gzip
+    ///////////////////////////////////////////////////////////////////////////
+
+    ///
+    /// \class  gzip_decoder
+    /// \brief  Decompress gzip with zlib
+    ///
+    class gzip_decoder : public json_decoder
+    {
+    public:
+        gzip_decoder()
+            :end(false)
+        {
+            memset(&stream, 0, sizeof(stream));
+            good = inflateInit2(&stream, 15 + 16) == Z_OK;  //a gzip header
+        }
+
+        ~gzip_decoder()
+        {
+            if (good)
+                inflateEnd(&stream);
+        }
+
+        bool decode(const char *&in, const char *in_end, char *&out, char *out_end)
+        {
+            while (good && out < out_end)
+            {
+                if (end)  //another member may follow
+                {
+                    if (in == in_end)
+                        break;
+                    inflateReset(&stream);
+                    end = false;
+                }
+
+                stream.next_in = (Bytef*)in;
+                stream.avail_in = (uInt)(in_end - in < (ptrdiff_t)MAX_STEP ? in_end - in : MAX_STEP);
+                stream.next_out = (Bytef*)out;
+                stream.avail_out = (uInt)(out_end - out < (ptrdiff_t)MAX_STEP ? out_end - out : MAX_STEP);
+                int ret = inflate(&stream, Z_NO_FLUSH);
+                bool progress = (const char*)stream.next_in != in || (char*)stream.next_out != out;
+                in = (const char*)stream.next_in;
+                out = (char*)stream.next_out;
+
+                if (ret == Z_STREAM_END)
+                    end = true;
+                else if (ret == Z_BUF_ERROR || (ret == Z_OK && !progress))  //more input is needed
+                    break;
+                else if (ret != Z_OK)
+                    return false;
+            }
+            return good;
+        }
+
+        bool is_end() const
+        {
+            return end;
+        }
+
+    private:
+        z_stream stream;    ///< the state of zlib
+        bool good;          ///< if zlib is initialized
+        bool end;           ///< if a member is decoded to its end
+    };
+
+    ///
+    /// \class  gzip_encoder
+    /// \brief  Compress into gzip with zlib
+    ///
+    class gzip_encoder : public json_encoder
+    {
+    public:
+        gzip_encoder(int level)
+        {
+            memset(&stream, 0, sizeof(stream));
+            good = deflateInit2(&stream, level ? level : Z_DEFAULT_COMPRESSION,
+                Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) == Z_OK;  //a gzip header
+        }
+
+        ~gzip_encoder()
+        {
+            if (good)
+                deflateEnd(&stream);
+        }
+
+        bool encode(const char *&in, const char *in_end, char *&out, char *out_end, json_encode_mode mode)
+        {
+            int flush = mode == ENCODE_END ? Z_FINISH : mode == ENCODE_FLUSH ? Z_SYNC_FLUSH : Z_NO_FLUSH;
+            while (good)
+            {
+                stream.next_in = (Bytef*)in;
+                stream.avail_in = (uInt)(in_end - in < (ptrdiff_t)MAX_STEP ? in_end - in : MAX_STEP);
+                stream.next_out = (Bytef*)out;
+                stream.avail_out = (uInt)(out_end - out < (ptrdiff_t)MAX_STEP ? out_end - out : MAX_STEP);
+                int ret = deflate(&stream, flush);
+                in = (const char*)stream.next_in;
+                out = (char*)stream.next_out;
+
+                if (ret == Z_STREAM_ERROR)
+                    good = false;
+                else if (mode == ENCODE_END ? ret == Z_STREAM_END
+                    : in == in_end && stream.avail_out != 0)  //everything is pushed out
+                    return true;
+                else if (out == out_end)
+                    return false;
+            }
+            return true;
+        }
+
+        bool is_good() const
+        {
+            return good;
+        }
+
+    private:
+        z_stream stream;    ///< the state of zlib
+        bool good;          ///< if no error has happened
+    };
+#endif
+
+#ifdef JSON_LITE_ZSTD
+    ///////////////////////////////////////////////////////////////////////////
+    // zstd
+    ///////////////////////////////////////////////////////////////////////////
+
+    ///
+    /// \class  zstd_decoder
+    /// \brief  Decompress zstd with libzstd
+    ///
+    class zstd_decoder : public json_decoder
+    {
+    public:
+        zstd_decoder()
+            :stream(ZSTD_createDStream()),
+             end(false)
+        {
+            if (stream)
+                ZSTD_initDStream(stream);
+        }
+
+        ~zstd_decoder()
+        {
+            ZSTD_freeDStream(stream);
+        }
+
+        bool decode(const char *&in, const char *in_end, char *&out, char *out_end)
+        {
+            if (!stream)
+                return false;
+
+            ZSTD_inBuffer input = {in, (size_t)(in_end - in), 0};
+            ZSTD_outBuffer output = {out, (size_t)(out_end - out), 0};
+            while (output.pos < output.size)
+            {
+                size_t in_pos = input.pos,
+                       out_pos = output.pos;
+                size_t ret = ZSTD_decompressStream(stream, &output, &input);
+                if (ZSTD_isError(ret))
+                    return false;
+                if (input.pos == in_pos && output.pos == out_pos)  //more input is needed
+                    break;
+                end = ret == 0;
+            }
+            in += input.pos;
+            out += output.pos;
+            return true;
+        }
+
+        bool is_end() const
+        {
+            return end;
+        }
+
+    private:
+        ZSTD_DStream *stream;   ///< the state of libzstd
+        bool end;               ///< if a frame is decoded to its end
+    };
+
+    ///
+    /// \class  zstd_encoder
+    /// \brief  Compress into zstd with libzstd
+    ///
+    class zstd_encoder : public json_encoder
+    {
+    public:
+        zstd_encoder(int level)
+            :context(ZSTD_createCCtx())
+        {
+            good = context != NULL;
+            if (good && level)
+                good = !ZSTD_isError(ZSTD_CCtx_setParameter(context, ZSTD_c_compressionLevel, level));
+        }
+
+        ~zstd_encoder()
+        {
+            ZSTD_freeCCtx(context);
+        }
+
+        bool encode(const char *&in, const char *in_end, char *&out, char *out_end, json_encode_mode mode)
+        {
+            ZSTD_EndDirective directive = mode == ENCODE_END ? ZSTD_e_end
+                : mode == ENCODE_FLUSH ? ZSTD_e_flush : ZSTD_e_continue;
+            ZSTD_inBuffer input = {in, (size_t)(in_end - in), 0};
+            ZSTD_outBuffer output = {out, (size_t)(out_end - out), 0};
+            bool done = true;
+            while (good)
+            {
+                size_t ret = ZSTD_compressStream2(context, &output, &input, directive);
+                if (ZSTD_isError(ret))
+                    good = false;
+                else if (mode == ENCODE_NONE ? input.pos == input.size : ret == 0)  //everything is pushed out
+                    break;
+                else if (output.pos == output.size)
+                {
+                    done = false;
+                    break;
+                }
+            }
+            in += input.pos;
+            out += output.pos;
+            return done;
+        }
+
+        bool is_good() const
+        {
+            return good;
+        }
+
+    private:
+        ZSTD_CCtx *context;     ///< the state of libzstd
+        bool good;              ///< if no error has happened
+    };
+#endif
+
+    ///////////////////////////////////////////////////////////////////////////
+    // json_decoder
+    ///////////////////////////////////////////////////////////////////////////
+
+    // create
+    json_decoder* json_decoder::create(json_compression compression)
+    {
+        switch (compression)
+        {
+#ifdef JSON_LITE_ZLIB
+        case COMPRESS_GZIP:
+            return new gzip_decoder;
+#endif
+#ifdef JSON_LITE_ZSTD
+        case COMPRESS_ZSTD:
+            return new zstd_decoder;
+#endif
+        default:
+            return NULL;
+        }
+    }
+
+    // ~json_decoder
+    json_decoder::~json_decoder()
+    {
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    // json_encoder
+    ///////////////////////////////////////////////////////////////////////////
+
+    // create
+    json_encoder* json_encoder::create(json_compression compression, int level)
+    {
+        switch (compression)
+        {
+#ifdef JSON_LITE_ZLIB
+        case COMPRESS_GZIP:
+            return new gzip_encoder(level);
+#endif
+#ifdef JSON_LITE_ZSTD
+        case COMPRESS_ZSTD:
+            return new zstd_encoder(level);
+#endif
+        default:
+            (void)level;
+            return NULL;
+        }
+    }
+
+    // ~json_encoder
+    json_encoder::~json_encoder()
+    {
+    }
+}
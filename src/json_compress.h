@@ -0,0 +1,164 @@
+///////////////////////////////////////////////////////////////////////////////
+///  Copyright 2012 Garnel
+///
+///  Licensed under the Apache License, Version 2.0 (the "License");
+///  you may not use this file except in compliance with the License.
+///  You may obtain a copy of the License at
+///
+///    http://www.apache.org/licenses/LICENSE-2.0
+///
+///  Unless required by applicable law or agreed to in writing, software
+///  distributed under the License is distributed on an "AS IS" BASIS,
+///  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///////////////////////////////////////////////////////////////////////////////
+
+///
+/// \file       json_compress.h
+/// The gzip and zstd streams of json_reader and json_buffer
+/// \author     Garnel
+/// \date       2026/10/15
+/// \version    2.3
+/// \copyright  Apache License, Version 2.0
+///
+/// gzip is compiled in with JSON_LITE_ZLIB (linking zlib), and zstd with
+/// JSON_LITE_ZSTD (linking libzstd). Without them, compressed input and
+/// output are refused.
+///
+
+#ifndef JSON_LITE_COMPRESS
+#define JSON_LITE_COMPRESS
+
+#include <cstddef>
+
+namespace json_lite
+{
+    ///
+    /// \enum   json_compression
+    /// \brief  The compression of a stream
+    ///
+    enum json_compression
+    {
+        COMPRESS_NONE,          ///< plain text
+        COMPRESS_GZIP,          ///< gzip, magic bytes 1F 8B
+        COMPRESS_ZSTD           ///< zstd, magic bytes 28 B5 2F FD
+    };
+
+    ///
+    /// \enum   json_encode_mode
+    /// \brief  How much of the input json_encoder::encode should push out
+    ///
+    enum json_encode_mode
+    {
+        ENCODE_NONE,            ///< keep what the compressor wants to keep
+        ENCODE_FLUSH,           ///< push out everything, the stream goes on
+        ENCODE_END              ///< push out everything and end the stream
+    };
+
+    ///
+    /// \fn         detect_compression
+    /// \brief      Tell the compression of a stream by its first bytes
+    /// \param      data    The first bytes of the stream
+    /// \param      length  The number of bytes, 4 are enough
+    ///
+    json_compression detect_compression(const char *data, size_t length);
+
+    ///
+    /// \fn         is_compression_supported
+    /// \brief      If the compression is compiled in
+    ///
+    bool is_compression_supported(json_compression compression);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// json_decoder
+    ///////////////////////////////////////////////////////////////////////////
+
+    ///
+    /// \class  json_decoder
+    /// \brief  Decompress a gzip or zstd stream given in pieces
+    ///
+    class json_decoder
+    {
+    public:
+        ///
+        /// \fn         create
+        /// \brief      Return a decoder of a compression, NULL if it is not supported
+        ///
+        static json_decoder* create(json_compression compression);
+
+        ///
+        /// \fn         ~json_decoder
+        /// \brief      The destructor of json_decoder
+        ///
+        virtual ~json_decoder();
+
+        ///
+        /// \fn         decode
+        /// \brief      Decompress as much as the input and output allow
+        /// \param      in      The compressed input, moved past what is consumed
+        /// \param      in_end  One past the last byte of input
+        /// \param      out     The output, moved past what is produced
+        /// \param      out_end One past the last byte of output
+        /// \note       Streams of several members (gzip) or frames (zstd) are decoded
+        ///             as one
+        /// \return     false if the stream is corrupt
+        ///
+        virtual bool decode(const char *&in, const char *in_end, char *&out, char *out_end) = 0;
+
+        ///
+        /// \fn         is_end
+        /// \brief      If the input decoded so far ends a member or frame
+        /// \note       false at the end of input means the stream is truncated
+        ///
+        virtual bool is_end() const = 0;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// json_encoder
+    ///////////////////////////////////////////////////////////////////////////
+
+    ///
+    /// \class  json_encoder
+    /// \brief  Compress a stream given in pieces into gzip or zstd
+    ///
+    class json_encoder
+    {
+    public:
+        ///
+        /// \fn         create
+        /// \brief      Return an encoder of a compression, NULL if it is not supported
+        /// \param      compression     COMPRESS_GZIP or COMPRESS_ZSTD
+        /// \param      level           The level of compression, 0 for the default of the library
+        ///
+        static json_encoder* create(json_compression compression, int level = 0);
+
+        ///
+        /// \fn         ~json_encoder
+        /// \brief      The destructor of json_encoder
+        ///
+        virtual ~json_encoder();
+
+        ///
+        /// \fn         encode
+        /// \brief      Compress as much as the input and output allow
+        /// \param      in      The input, moved past what is consumed
+        /// \param      in_end  One past the last byte of input
+        /// \param      out     The compressed output, moved past what is produced
+        /// \param      out_end One past the last byte of output
+        /// \param      mode    How much to push out
+        /// \return     true if all the input is consumed and the mode is done,
+        ///             false if it should be called again with more output
+        ///
+        virtual bool encode(const char *&in, const char *in_end, char *&out, char *out_end,
+            json_encode_mode mode) = 0;
+
+        ///
+        /// \fn         is_good
+        /// \brief      If no error has happened in the library
+        ///
+        virtual bool is_good() const = 0;
+    };
+}
+
+#endif // JSON_LITE_COMPRESS
@@ -0,0 +1,303 @@
+///////////////////////////////////////////////////////////////////////////////
+///  Copyright 2012 Garnel
+///
+///  Licensed under the Apache License, Version 2.0 (the "License");
+///  you may not use this file except in compliance with the License.
+///  You may obtain a copy of the License at
+///
+///    http://www.apache.org/licenses/LICENSE-2.0
+///
+///  Unless required by applicable law or agreed to in writing, software
+///  distributed under the License is distributed on an "AS IS" BASIS,
+///  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///////////////////////////////////////////////////////////////////////////////
+
+///
+/// \file       json_cursor.cpp
+/// The implementation of class json_cursor
+/// \author     Garnel
+/// \date       2026/10/15
+/// \version    2.3
+/// \copyright  Apache License, Version 2.0
+///
+
+#include "json_cursor.h"
+
+///
+/// \namespace  json_lite
+///
+namespace json_lite
+{
+    // json_cursor
+    json_cursor::json_cursor(json_parser &_parser)
+        :parser(_parser),
+         state(EXPECT_FIRST),
+         token(TOKEN_NONE),
+         pending(false)
+    {
+        parser.parse_result = json_parse_result();
+    }
+
+    // next_token
+    json_token json_cursor::next_token()
+    {
+        if (token == TOKEN_END || token == TOKEN_ERROR)
+            return token;
+
+        // pass over the text not read
+        if (pending)
+        {
+            if (token == TOKEN_NUMBER)
+                parser.parse_number();
+            else
+                parser.skip_string();
+            pending = false;
+            if (parser.parse_result.failed)
+                return this->fail(parser.parse_result.error);
+        }
+        value.clear();
+
+        //escape blank characters
+        char temp_char = parser.escape_blank();
+
+        // the json itself
+        if (stack.empty())
+        {
+            if (token != TOKEN_NONE)
+            {
+                //after the json should be only blank characters
+                if (temp_char != '\0' || !parser.at_end())
+                    return this->fail(EXTRA_CONTENT_AFTER_JSON);
+                return token = TOKEN_END;
+            }
+            if (temp_char != '{' && temp_char != '[')
+                return this->fail(SHOULD_BE_OBJECT_OR_ARRAY);
+            return token = this->read_value(temp_char);
+        }
+
+        bool in_object = stack.back();
+        char close_char = in_object ? '}' : ']';
+        switch (state)
+        {
+        case EXPECT_COLON:
+            //the current char must be ':'
+            if (temp_char != ':')
+                return this->fail(MISSING_COLON);
+            parser.get_char();
+            return token = this->read_value(parser.escape_blank());
+
+        case EXPECT_SEPARATOR:
+            if (temp_char == close_char)
+                return token = this->close();
+            if (temp_char == '\0' && parser.at_end())
+                return this->fail(in_object ? UNCLOSED_OBJECT : UNCLOSED_ARRAY);
+            if (temp_char != ',')  //@todo Detail the error
+                return this->fail(INVALID_CHARACTER);
+            parser.get_char();
+            temp_char = parser.escape_blank();
+            if (temp_char == close_char)  //extra comma (like this: "XXX, }")
+                return this->fail(EXTRA_COMMA);
+            break;
+
+        case EXPECT_FIRST:
+            //the object or array is empty
+            if (temp_char == close_char)
+                return token = this->close();
+            break;
+
+        default:
+            break;
+        }
+
+        if (in_object)
+        {
+            if (temp_char != '\"')
+                return this->fail(MISSING_QUOTATION);
+            //escape the left quotation, the label is read by get_value
+            parser.get_char();
+            pending = true;
+            state = EXPECT_COLON;
+            return token = TOKEN_KEY;
+        }
+        return token = this->read_value(temp_char);
+    }
+
+    // get_token
+    json_token json_cursor::get_token() const
+    {
+        return token;
+    }
+
+    // get_value
+    const std::string& json_cursor::get_value()
+    {
+        if (pending)
+        {
+            value = token == TOKEN_NUMBER ? parser.parse_number() : parser.parse_string();
+            pending = false;
+            if (parser.parse_result.failed)
+                this->fail(parser.parse_result.error);
+        }
+        return value;
+    }
+
+    // skip_value
+    bool json_cursor::skip_value()
+    {
+        // the value of the label
+        if (token == TOKEN_KEY)
+            this->next_token();
+
+        // a string or number not read is passed over by next_token
+        if (token != TOKEN_START_OBJECT && token != TOKEN_START_ARRAY)
+            return token != TOKEN_ERROR;
+
+        // match the brackets, skipping strings which may have brackets in them
+        for (size_t nest = 1; nest; )
+        {
+            switch (parser.get_char())
+            {
+            case '\"':
+                parser.skip_string();
+                break;
+            case '{':
+            case '[':
+                nest++;
+                break;
+            case '}':
+            case ']':
+                nest--;
+                break;
+            case '\0':
+                if (!parser.at_end())  //a '\0' in the text
+                    break;
+                this->fail(stack.back() ? UNCLOSED_OBJECT : UNCLOSED_ARRAY);
+                return false;
+            default:
+                break;
+            }
+        }
+
+        bool in_object = stack.back();
+        stack.pop_back();
+        state = EXPECT_SEPARATOR;
+        token = in_object ? TOKEN_END_OBJECT : TOKEN_END_ARRAY;
+        return true;
+    }
+
+    // enter_object
+    bool json_cursor::enter_object()
+    {
+        if (token == TOKEN_NONE || token == TOKEN_KEY)
+            this->next_token();
+        return token == TOKEN_START_OBJECT;
+    }
+
+    // enter_array
+    bool json_cursor::enter_array()
+    {
+        if (token == TOKEN_NONE || token == TOKEN_KEY)
+            this->next_token();
+        return token == TOKEN_START_ARRAY;
+    }
+
+    // get_depth
+    size_t json_cursor::get_depth() const
+    {
+        return stack.size();
+    }
+
+    // read_value
+    json_token json_cursor::read_value(char temp_char)
+    {
+        state = EXPECT_SEPARATOR;
+        switch (temp_char)
+        {
+        //only strings begin with a quotation, read by get_value
+        case '\"':
+            parser.get_char();
+            pending = true;
+            return TOKEN_STRING;
+
+        //numbers, read by get_value
+        case '+':
+        case '-':
+        case '0':
+        case '1':
+        case '2':
+        case '3':
+        case '4':
+        case '5':
+        case '6':
+        case '7':
+        case '8':
+        case '9':
+            pending = true;
+            return TOKEN_NUMBER;
+
+        case 't':
+            value = parser.parse_true();
+            return parser.parse_result.failed ? this->fail(parser.parse_result.error) : TOKEN_TRUE;
+
+        case 'f':
+            value = parser.parse_false();
+            return parser.parse_result.failed ? this->fail(parser.parse_result.error) : TOKEN_FALSE;
+
+        case 'n':
+            value = parser.parse_null();
+            return parser.parse_result.failed ? this->fail(parser.parse_result.error) : TOKEN_NULL;
+
+        // go into the object or array
+        case '{':
+        case '[':
+            parser.get_char();
+            stack.push_back(temp_char == '{');
+            if (parser.max_depth && stack.size() > parser.max_depth)
+                return this->fail(TOO_DEEP_NESTING);
+            state = EXPECT_FIRST;
+            return temp_char == '{' ? TOKEN_START_OBJECT : TOKEN_START_ARRAY;
+
+        // empty value
+        case ',':
+            return this->fail(stack.back() ? INVALID_CHARACTER : EMPTY_VALUE);
+
+        // unexpected end, or a '\0' in the text
+        case '\0':
+            if (!parser.at_end())
+                return this->fail(INVALID_CHARACTER);
+            return this->fail(stack.back() ? UNCLOSED_OBJECT : UNCLOSED_ARRAY);
+
+        default:
+            return this->fail(INVALID_CHARACTER);
+        }
+    }
+
+    // close
+    json_token json_cursor::close()
+    {
+        // escape the } or ]
+        parser.get_char();
+        bool in_object = stack.back();
+        stack.pop_back();
+        state = EXPECT_SEPARATOR;
+        return in_object ? TOKEN_END_OBJECT : TOKEN_END_ARRAY;
+    }
+
+    // get_result
+    const json_parse_result& json_cursor::get_result() const
+    {
+        return parser.parse_result;
+    }
+
+    // fail
+    json_token json_cursor::fail(json_parse_error error_type)
+    {
+        parser.fail(error_type);
+        stack.clear();
+        pending = false;
+        value.clear();
+        return token = TOKEN_ERROR;
+    }
+}
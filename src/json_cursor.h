@@ -0,0 +1,202 @@
+///////////////////////////////////////////////////////////////////////////////
+///  Copyright 2012 Garnel
+///
+///  Licensed under the Apache License, Version 2.0 (the "License");
+///  you may not use this file except in compliance with the License.
+///  You may obtain a copy of the License at
+///
+///    http://www.apache.org/licenses/LICENSE-2.0
+///
+///  Unless required by applicable law or agreed to in writing, software
+///  distributed under the License is distributed on an "AS IS" BASIS,
+///  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///////////////////////////////////////////////////////////////////////////////
+
+///
+/// \file       json_cursor.h
+/// The declaration of json_cursor, a pull parser over json_parser
+/// \author     Garnel
+/// \date       2026/10/15
+/// \version    2.3
+/// \copyright  Apache License, Version 2.0
+///
+
+#ifndef JSON_LITE_CURSOR
+#define JSON_LITE_CURSOR
+
+#include <string>
+#include <vector>
+
+#include "json_lite.h"
+
+namespace json_lite
+{
+    ///
+    /// \enum   json_token
+    /// \brief  The tokens of json_cursor
+    ///
+    enum json_token
+    {
+        TOKEN_NONE,             ///< nothing is read yet
+        TOKEN_START_OBJECT,
+        TOKEN_END_OBJECT,
+        TOKEN_START_ARRAY,
+        TOKEN_END_ARRAY,
+        TOKEN_KEY,
+        TOKEN_STRING,
+        TOKEN_NUMBER,
+        TOKEN_TRUE,
+        TOKEN_FALSE,
+        TOKEN_NULL,
+        TOKEN_END,              ///< the end of the json
+        TOKEN_ERROR             ///< an error in the json, see json_cursor::get_result
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// json_cursor
+    ///////////////////////////////////////////////////////////////////////////
+
+    ///
+    /// \class  json_cursor
+    /// \brief  Walk a json token by token, in the order chosen by the caller
+    ///
+    /// Nothing is allocated for the elements. Labels, strings and numbers
+    /// are read only when get_value() asks for them, and skip_value() passes
+    /// over a whole object or array by matching its brackets.
+    ///
+    /// \code
+    /// json_cursor cursor(parser);
+    /// if (cursor.enter_object())
+    ///     while (cursor.next_token() == TOKEN_KEY)
+    ///     {
+    ///         if (cursor.get_value() == "id" && cursor.next_token() == TOKEN_NUMBER)
+    ///             id = cursor.get_value();
+    ///         else
+    ///             cursor.skip_value();
+    ///     }
+    /// \endcode
+    ///
+    class json_cursor
+    {
+    public:
+        ///
+        /// \fn         json_cursor
+        /// \brief      The constructor of json_cursor
+        /// \param      _parser     The parser of the json, at its beginning
+        /// \warning    The parser must NOT be used otherwise while the cursor is
+        ///
+        json_cursor(json_parser &_parser);
+
+        ///
+        /// \fn         next_token
+        /// \brief      Move to the next token
+        /// \note       A label, string or number not read is skipped without decoding
+        /// \return     The token, TOKEN_END after the json, or TOKEN_ERROR
+        ///
+        json_token next_token();
+
+        ///
+        /// \fn         get_token
+        /// \brief      Return the token at the cursor
+        ///
+        json_token get_token() const;
+
+        ///
+        /// \fn         get_value
+        /// \brief      Read the value of the token at the cursor
+        /// \note       Escape characters in labels and strings are decoded.
+        ///             The value is read once, and kept until the next token.
+        /// \return     The label, string or text of the number, "true", "false"
+        ///             or "null", or an empty string for other tokens
+        ///
+        const std::string& get_value();
+
+        ///
+        /// \fn         skip_value
+        /// \brief      Pass over the value at the cursor
+        /// \note       On a label its value is passed over. On '{' or '[' the
+        ///             brackets are matched up to the closing one, where the
+        ///             cursor stops; what is inside is NOT checked.
+        /// \return     false for an error
+        ///
+        bool skip_value();
+
+        ///
+        /// \fn         enter_object
+        /// \brief      Move to the '{' of the json, or of the value of the label
+        ///             at the cursor
+        /// \return     true if there is an object, then next_token() returns
+        ///             its first label or its end
+        ///
+        bool enter_object();
+
+        ///
+        /// \fn         enter_array
+        /// \brief      Move to the '[' of the json, or of the value of the label
+        ///             at the cursor
+        /// \return     true if there is an array, then next_token() returns
+        ///             its first element or its end
+        ///
+        bool enter_array();
+
+        ///
+        /// \fn         get_depth
+        /// \brief      Return the number of objects and arrays the cursor is in
+        ///
+        size_t get_depth() const;
+
+        ///
+        /// \fn         get_result
+        /// \brief      Return the error and its position after TOKEN_ERROR
+        /// \note       Nothing is printed for an error, like json_parser::run(json_parse_result &result)
+        ///
+        const json_parse_result& get_result() const;
+
+    private:
+        json_cursor(const json_cursor&);              ///< copy is not allowed
+        json_cursor& operator=(const json_cursor&);   ///< copy is not allowed
+
+        ///
+        /// \fn         read_value
+        /// \brief      Start reading the value beginning with a character
+        /// \return     The token of the value, TOKEN_ERROR for an error
+        ///
+        json_token read_value(char temp_char);
+
+        ///
+        /// \fn         close
+        /// \brief      Escape the closing '}' or ']' at the cursor
+        ///
+        json_token close();
+
+        ///
+        /// \fn         fail
+        /// \brief      Record the error, and stop the cursor
+        ///
+        json_token fail(json_parse_error error_type);
+
+    private:
+        ///
+        /// \enum   expect
+        /// \brief  What comes next in the open object or array
+        ///
+        enum expect
+        {
+            EXPECT_FIRST,       ///< the first element or the end
+            EXPECT_ELEMENT,     ///< an element after ','
+            EXPECT_SEPARATOR,   ///< ',' or the end
+            EXPECT_COLON        ///< ':' after a label
+        };
+
+        json_parser &parser;        ///< the parser of the json
+        std::vector<bool> stack;    ///< the open objects and arrays, true for objects
+        expect state;               ///< what comes next
+        json_token token;           ///< the token at the cursor
+        bool pending;               ///< if the text of the token is not read yet
+        std::string value;          ///< the value read of the token
+    };
+}
+
+#endif // JSON_LITE_CURSOR
@@ -0,0 +1,91 @@
+///////////////////////////////////////////////////////////////////////////////
+///  Copyright 2012 Garnel
+///
+///  Licensed under the Apache License, Version 2.0 (the "License");
+///  you may not use this file except in compliance with the License.
+///  You may obtain a copy of the License at
+///
+///    http://www.apache.org/licenses/LICENSE-2.0
+///
+///  Unless required by applicable law or agreed to in writing, software
+///  distributed under the License is distributed on an "AS IS" BASIS,
+///  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///////////////////////////////////////////////////////////////////////////////
+
+///
+/// \file       json_handler.cpp
+/// The default events of json_handler, all ignored
+/// \author     Garnel
+/// \date       2026/10/15
+/// \version    2.3
+/// \copyright  Apache License, Version 2.0
+///
+
+#include "json_handler.h"
+
+///
+/// \namespace  json_lite
+///
+namespace json_lite
+{
+    // ~json_handler
+    json_handler::~json_handler()
+    {
+    }
+
+    // on_start_object
+    bool json_handler::on_start_object()
+    {
+        return true;
+    }
+
+    // on_end_object
+    bool json_handler::on_end_object()
+    {
+        return true;
+    }
+
+    // on_start_array
+    bool json_handler::on_start_array()
+    {
+        return true;
+    }
+
+    // on_end_array
+    bool json_handler::on_end_array()
+    {
+        return true;
+    }
+
+    // on_key
+    bool json_handler::on_key(const std::string&)
+    {
+        return true;
+    }
+
+    // on_string
+    bool json_handler::on_string(const std::string&)
+    {
+        return true;
+    }
+
+    // on_number
+    bool json_handler::on_number(const std::string&)
+    {
+        return true;
+    }
+
+    // on_bool
+    bool json_handler::on_bool(bool)
+    {
+        return true;
+    }
+
+    // on_null
+    bool json_handler::on_null()
+    {
+        return true;
+    }
+}
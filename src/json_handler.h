@@ -0,0 +1,113 @@
+///////////////////////////////////////////////////////////////////////////////
+///  Copyright 2012 Garnel
+///
+///  Licensed under the Apache License, Version 2.0 (the "License");
+///  you may not use this file except in compliance with the License.
+///  You may obtain a copy of the License at
+///
+///    http://www.apache.org/licenses/LICENSE-2.0
+///
+///  Unless required by applicable law or agreed to in writing, software
+///  distributed under the License is distributed on an "AS IS" BASIS,
+///  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///////////////////////////////////////////////////////////////////////////////
+
+///
+/// \file       json_handler.h
+/// The declaration of json_handler, the events of json_parser
+/// \author     Garnel
+/// \date       2026/10/15
+/// \version    2.3
+/// \copyright  Apache License, Version 2.0
+///
+
+#ifndef JSON_LITE_HANDLER
+#define JSON_LITE_HANDLER
+
+#include <string>
+
+namespace json_lite
+{
+    ///////////////////////////////////////////////////////////////////////////
+    /// json_handler
+    ///////////////////////////////////////////////////////////////////////////
+
+    ///
+    /// \class  json_handler
+    /// \brief  The receiver of the events of json_parser::run(json_handler&)
+    ///
+    /// Events come in the order of the text. Every event returns true to go
+    /// on or false to stop the parse at once. By default every event is
+    /// ignored, so a handler overrides only the events it needs.
+    ///
+    class json_handler
+    {
+    public:
+        ///
+        /// \fn         ~json_handler
+        /// \brief      The destructor of json_handler
+        ///
+        virtual ~json_handler();
+
+        ///
+        /// \fn         on_start_object
+        /// \brief      A '{' is parsed
+        ///
+        virtual bool on_start_object();
+
+        ///
+        /// \fn         on_end_object
+        /// \brief      A '}' is parsed
+        ///
+        virtual bool on_end_object();
+
+        ///
+        /// \fn         on_start_array
+        /// \brief      A '[' is parsed
+        ///
+        virtual bool on_start_array();
+
+        ///
+        /// \fn         on_end_array
+        /// \brief      A ']' is parsed
+        ///
+        virtual bool on_end_array();
+
+        ///
+        /// \fn         on_key
+        /// \brief      The label of a pair is parsed, its value comes next
+        /// \param      key     The label, escape characters decoded
+        ///
+        virtual bool on_key(const std::string &key);
+
+        ///
+        /// \fn         on_string
+        /// \brief      A string is parsed
+        /// \param      str     The string, escape characters decoded
+        ///
+        virtual bool on_string(const std::string &str);
+
+        ///
+        /// \fn         on_number
+        /// \brief      A number is parsed
+        /// \param      text    The text of the number, see to_number to convert it
+        ///
+        virtual bool on_number(const std::string &text);
+
+        ///
+        /// \fn         on_bool
+        /// \brief      A true or false is parsed
+        ///
+        virtual bool on_bool(bool b);
+
+        ///
+        /// \fn         on_null
+        /// \brief      A null is parsed
+        ///
+        virtual bool on_null();
+    };
+}
+
+#endif // JSON_LITE_HANDLER
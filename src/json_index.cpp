@@ -0,0 +1,336 @@
+///////////////////////////////////////////////////////////////////////////////
+///  Copyright 2012 Garnel
+///
+///  Licensed under the Apache License, Version 2.0 (the "License");
+///  you may not use this file except in compliance with the License.
+///  You may obtain a copy of the License at
+///
+///    http://www.apache.org/licenses/LICENSE-2.0
+///
+///  Unless required by applicable law or agreed to in writing, software
+///  distributed under the License is distributed on an "AS IS" BASIS,
+///  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///////////////////////////////////////////////////////////////////////////////
+
+///
+/// \file       json_index.cpp
+/// The implementation of class structural_index and find_quote_or_escape
+/// \author     Garnel
+/// \date       2026/10/15
+/// \version    2.3
+/// \copyright  Apache License, Version 2.0
+///
+
+#include "json_index.h"
+
+#include <cassert>
+#include <cstring>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define JSON_LITE_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define JSON_LITE_SSE2
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+///
+/// \namespace  json_lite
+///
+namespace json_lite
+{
+    const size_t BLOCK_SIZE = 64;   ///< the bytes classified at a time
+
+    ///
+    /// \struct     block_masks
+    /// \brief      One bit per byte of a 64-byte block
+    ///
+    struct block_masks
+    {
+        uint64_t quote;         ///< '"'
+        uint64_t backslash;     ///< '\'
+        uint64_t structural;    ///< '{', '}', '[', ']', ':', ','
+        uint64_t blank;         ///< ' ', '\n', '\r', '\t'
+    };
+
+    ///
+    /// \fn         trailing_zeros
+    /// \brief      Return the index of the lowest set bit
+    /// \warning    The mask should NOT be zero
+    ///
+    inline int trailing_zeros(uint64_t mask)
+    {
+#ifdef _MSC_VER
+        unsigned long index;
+        _BitScanForward64(&index, mask);
+        return (int)index;
+#else
+        return __builtin_ctzll(mask);
+#endif
+    }
+
+    ///
+    /// \fn         prefix_xor
+    /// \brief      Bit i of the result is the xor of bits 0..i of the mask
+    /// \note       Turns the quotation bits into the bits inside strings
+    ///
+    inline uint64_t prefix_xor(uint64_t mask)
+    {
+        mask ^= mask << 1;
+        mask ^= mask << 2;
+        mask ^= mask << 4;
+        mask ^= mask << 8;
+        mask ^= mask << 16;
+        mask ^= mask << 32;
+        return mask;
+    }
+
+#if defined(JSON_LITE_AVX2)
+    ///
+    /// \fn         classify
+    /// \brief      Classify a 64-byte block with AVX2
+    ///
+    inline void classify(const char *block, block_masks &masks)
+    {
+        uint64_t quote = 0, backslash = 0, structural = 0, blank = 0;
+        for (int i = 0; i < 2; i++)
+        {
+            __m256i v = _mm256_loadu_si256((const __m256i*)(block + 32 * i));
+            // '[' and ']' differ from '{' and '}' only in bit 0x20
+            __m256i lower = _mm256_or_si256(v, _mm256_set1_epi8(0x20));
+            __m256i s = _mm256_or_si256(
+                _mm256_or_si256(_mm256_cmpeq_epi8(lower, _mm256_set1_epi8('{')),
+                                _mm256_cmpeq_epi8(lower, _mm256_set1_epi8('}'))),
+                _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(':')),
+                                _mm256_cmpeq_epi8(v, _mm256_set1_epi8(','))));
+            __m256i b = _mm256_or_si256(
+                _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(' ')),
+                                _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\n'))),
+                _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('\r')),
+                                _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\t'))));
+            int shift = 32 * i;
+            quote |= (uint64_t)(uint32_t)_mm256_movemask_epi8(
+                _mm256_cmpeq_epi8(v, _mm256_set1_epi8('"'))) << shift;
+            backslash |= (uint64_t)(uint32_t)_mm256_movemask_epi8(
+                _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\\'))) << shift;
+            structural |= (uint64_t)(uint32_t)_mm256_movemask_epi8(s) << shift;
+            blank |= (uint64_t)(uint32_t)_mm256_movemask_epi8(b) << shift;
+        }
+        masks.quote = quote;
+        masks.backslash = backslash;
+        masks.structural = structural;
+        masks.blank = blank;
+    }
+#elif defined(JSON_LITE_SSE2)
+    ///
+    /// \fn         classify
+    /// \brief      Classify a 64-byte block with SSE2
+    ///
+    inline void classify(const char *block, block_masks &masks)
+    {
+        uint64_t quote = 0, backslash = 0, structural = 0, blank = 0;
+        for (int i = 0; i < 4; i++)
+        {
+            __m128i v = _mm_loadu_si128((const __m128i*)(block + 16 * i));
+            // '[' and ']' differ from '{' and '}' only in bit 0x20
+            __m128i lower = _mm_or_si128(v, _mm_set1_epi8(0x20));
+            __m128i s = _mm_or_si128(
+                _mm_or_si128(_mm_cmpeq_epi8(lower, _mm_set1_epi8('{')),
+                             _mm_cmpeq_epi8(lower, _mm_set1_epi8('}'))),
+                _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(':')),
+                             _mm_cmpeq_epi8(v, _mm_set1_epi8(','))));
+            __m128i b = _mm_or_si128(
+                _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(' ')),
+                             _mm_cmpeq_epi8(v, _mm_set1_epi8('\n'))),
+                _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('\r')),
+                             _mm_cmpeq_epi8(v, _mm_set1_epi8('\t'))));
+            int shift = 16 * i;
+            quote |= (uint64_t)_mm_movemask_epi8(
+                _mm_cmpeq_epi8(v, _mm_set1_epi8('"'))) << shift;
+            backslash |= (uint64_t)_mm_movemask_epi8(
+                _mm_cmpeq_epi8(v, _mm_set1_epi8('\\'))) << shift;
+            structural |= (uint64_t)_mm_movemask_epi8(s) << shift;
+            blank |= (uint64_t)_mm_movemask_epi8(b) << shift;
+        }
+        masks.quote = quote;
+        masks.backslash = backslash;
+        masks.structural = structural;
+        masks.blank = blank;
+    }
+#else
+    ///
+    /// \fn         classify
+    /// \brief      Classify a 64-byte block one byte at a time
+    ///
+    inline void classify(const char *block, block_masks &masks)
+    {
+        uint64_t quote = 0, backslash = 0, structural = 0, blank = 0;
+        for (size_t i = 0; i < BLOCK_SIZE; i++)
+        {
+            uint64_t bit = (uint64_t)1 << i;
+            switch (block[i])
+            {
+            case '"':
+                quote |= bit;
+                break;
+            case '\\':
+                backslash |= bit;
+                break;
+            case '{':
+            case '}':
+            case '[':
+            case ']':
+            case ':':
+            case ',':
+                structural |= bit;
+                break;
+            case ' ':
+            case '\n':
+            case '\r':
+            case '\t':
+                blank |= bit;
+                break;
+            default:
+                break;
+            }
+        }
+        masks.quote = quote;
+        masks.backslash = backslash;
+        masks.structural = structural;
+        masks.blank = blank;
+    }
+#endif
+
+    // find_quote_or_escape
+    const char* find_quote_or_escape(const char *p, const char *end)
+    {
+#if defined(JSON_LITE_AVX2) || defined(JSON_LITE_SSE2)
+        const __m128i quote = _mm_set1_epi8('"'),
+                      backslash = _mm_set1_epi8('\\'),
+                      control = _mm_set1_epi8(0x1F);
+        for (; end - p >= 16; p += 16)
+        {
+            __m128i v = _mm_loadu_si128((const __m128i*)p);
+            // max(v, 0x1F) == 0x1F for the bytes below 0x20
+            __m128i special = _mm_or_si128(
+                _mm_or_si128(_mm_cmpeq_epi8(v, quote), _mm_cmpeq_epi8(v, backslash)),
+                _mm_cmpeq_epi8(_mm_max_epu8(v, control), control));
+            int mask = _mm_movemask_epi8(special);
+            if (mask)
+                return p + trailing_zeros((uint64_t)mask);
+        }
+#endif
+        for (; p < end; p++)
+            if (*p == '"' || *p == '\\' || (unsigned char)*p < 0x20)
+                return p;
+        return end;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    // structural_index
+    ///////////////////////////////////////////////////////////////////////////
+
+    const size_t structural_index::MAX_LENGTH;
+
+    // structural_index
+    structural_index::structural_index()
+        :unclosed_string(false)
+    {
+    }
+
+    // build
+    bool structural_index::build(const char* data, size_t length)
+    {
+        positions.clear();
+        unclosed_string = false;
+        if (length > MAX_LENGTH)  //the offsets would not fit in the positions
+            return false;
+        // about one token in every 8 bytes on typical documents
+        positions.reserve(length / 8 + 16);
+
+        uint64_t escape_carry = 0,      // the first byte of the block is escaped
+                 string_carry = 0,      // all ones if the block starts inside a string
+                 boundary_carry = 1;    // the last byte of the previous block ends a token
+        char tail[BLOCK_SIZE];
+
+        for (size_t offset = 0; offset < length; offset += BLOCK_SIZE)
+        {
+            const char *block = data + offset;
+            if (length - offset < BLOCK_SIZE)
+            {
+                // pad the last block with blanks, which never start a token
+                memset(tail, ' ', BLOCK_SIZE);
+                memcpy(tail, block, length - offset);
+                block = tail;
+            }
+
+            block_masks masks;
+            classify(block, masks);
+
+            // the characters following an odd run of backslashes are escaped
+            uint64_t escaped = escape_carry,
+                     backslash = masks.backslash;
+            escape_carry = 0;
+            while (backslash)
+            {
+                int i = trailing_zeros(backslash);
+                backslash &= backslash - 1;
+                uint64_t bit = (uint64_t)1 << i;
+                if (escaped & bit)  //the backslash itself is escaped
+                    continue;
+                if (i == BLOCK_SIZE - 1)
+                    escape_carry = 1;
+                else
+                    escaped |= bit << 1;
+            }
+
+            // the opening quotation is inside the string, the closing one is not
+            uint64_t quote = masks.quote & ~escaped,
+                     in_string = prefix_xor(quote) ^ string_carry;
+            string_carry = (uint64_t)0 - (in_string >> 63);
+
+            uint64_t structural = masks.structural & ~in_string,
+                     blank = masks.blank & ~in_string,
+                     closing_quote = quote & ~in_string,
+                     scalar = ~(in_string | quote | structural | blank),
+                     boundary = structural | blank | closing_quote,
+                     scalar_start = scalar & ((boundary << 1) | boundary_carry);
+            boundary_carry = boundary >> 63;
+
+            uint64_t tokens = structural | (quote & in_string) | scalar_start;
+            while (tokens)
+            {
+                positions.push_back((uint32_t)(offset + trailing_zeros(tokens)));
+                tokens &= tokens - 1;
+            }
+        }
+
+        unclosed_string = string_carry != 0;
+        return true;
+    }
+
+    // size
+    size_t structural_index::size() const
+    {
+        return positions.size();
+    }
+
+    // get_position
+    uint32_t structural_index::get_position(size_t i) const
+    {
+        assert(i < positions.size());
+        return positions[i];
+    }
+
+    // has_unclosed_string
+    bool structural_index::has_unclosed_string() const
+    {
+        return unclosed_string;
+    }
+}
@@ -0,0 +1,106 @@
+///////////////////////////////////////////////////////////////////////////////
+///  Copyright 2012 Garnel
+///
+///  Licensed under the Apache License, Version 2.0 (the "License");
+///  you may not use this file except in compliance with the License.
+///  You may obtain a copy of the License at
+///
+///    http://www.apache.org/licenses/LICENSE-2.0
+///
+///  Unless required by applicable law or agreed to in writing, software
+///  distributed under the License is distributed on an "AS IS" BASIS,
+///  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///////////////////////////////////////////////////////////////////////////////
+
+///
+/// \file       json_index.h
+/// The declaration of structural_index, the stage-1 pass of json_parser,
+/// and the SIMD scanning of strings
+/// \author     Garnel
+/// \date       2026/10/15
+/// \version    2.3
+/// \copyright  Apache License, Version 2.0
+///
+
+#ifndef JSON_LITE_INDEX
+#define JSON_LITE_INDEX
+
+#include <cstddef>
+#include <vector>
+#include <stdint.h>
+
+namespace json_lite
+{
+    ///
+    /// \fn         find_quote_or_escape
+    /// \brief      Find the first character ending a clean span of a string
+    /// \param      p       The first character to scan
+    /// \param      end     One past the last character to scan
+    /// \note       16 bytes at a time with SSE2 when the compiler targets it
+    /// \return     The first '"', '\\' or control character, or end if none
+    ///
+    const char* find_quote_or_escape(const char *p, const char *end);
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// structural_index
+    ///////////////////////////////////////////////////////////////////////////
+
+    ///
+    /// \class  structural_index
+    /// \brief  The positions of every token in a json text
+    ///
+    /// The text is classified 64 bytes at a time (with AVX2 or SSE2 when the
+    /// compiler targets them) into bitmaps of quotes, backslashes, structural
+    /// characters and blanks. Escaped quotes and everything inside strings
+    /// are masked out, and the positions left are recorded in order:
+    /// structural characters, opening quotations, and the first character
+    /// of every number, true, false and null.
+    ///
+    class structural_index
+    {
+    public:
+        ///
+        /// \fn         structural_index
+        /// \brief      The constructor of structural_index
+        ///
+        structural_index();
+
+        ///
+        /// \fn         build
+        /// \brief      Index a json text, replacing the previous positions
+        /// \param      data    The json text
+        /// \param      length  The length of the json text
+        /// \note       The positions are 32-bit, see MAX_LENGTH
+        /// \return     false if the text is longer than MAX_LENGTH, then nothing is indexed
+        ///
+        bool build(const char* data, size_t length);
+
+        ///
+        /// \fn         size
+        /// \brief      Return the number of positions indexed
+        ///
+        size_t size() const;
+
+        ///
+        /// \fn         get_position
+        /// \brief      Return the offset of the i-th token in the text
+        ///
+        uint32_t get_position(size_t i) const;
+
+        ///
+        /// \fn         has_unclosed_string
+        /// \brief      If the text ends inside a string
+        ///
+        bool has_unclosed_string() const;
+
+        static const size_t MAX_LENGTH = 0xFFFFFFFFu;   ///< the longest text indexed
+
+    private:
+        std::vector<uint32_t> positions;    ///< The offsets of the tokens
+        bool unclosed_string;               ///< If the text ends inside a string
+    };
+}
+
+#endif // JSON_LITE_INDEX
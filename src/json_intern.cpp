@@ -0,0 +1,102 @@
+///////////////////////////////////////////////////////////////////////////////
+///  Copyright 2012 Garnel
+///
+///  Licensed under the Apache License, Version 2.0 (the "License");
+///  you may not use this file except in compliance with the License.
+///  You may obtain a copy of the License at
+///
+///    http://www.apache.org/licenses/LICENSE-2.0
+///
+///  Unless required by applicable law or agreed to in writing, software
+///  distributed under the License is distributed on an "AS IS" BASIS,
+///  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///////////////////////////////////////////////////////////////////////////////
+
+///
+/// \file       json_intern.cpp
+/// The implementation of class json_key_table
+/// \author     Garnel
+/// \date       2026/10/15
+/// \version    2.3
+/// \copyright  Apache License, Version 2.0
+///
+
+#include "json_intern.h"
+
+#include <cstring>
+
+///
+/// \namespace  json_lite
+///
+namespace json_lite
+{
+    const size_t KEY_TABLE_MIN_SLOTS = 64;     ///< the slots of an empty table
+
+    // json_key_table
+    json_key_table::json_key_table(json_arena &_arena)
+        :count(0),
+         arena(_arena)
+    {
+    }
+
+    // intern
+    const char* json_key_table::intern(const char *str, size_t length, size_t hash)
+    {
+        // at most half of the slots are used
+        if ((count + 1) * 2 > slots.size())
+            this->grow();
+
+        size_t mask = slots.size() - 1,
+               i = hash & mask;
+        for (; slots[i].hash; i = (i + 1) & mask)
+        {
+            if (slots[i].hash == hash && slots[i].length == length
+                && memcmp(slots[i].str, str, length) == 0)
+                return slots[i].str;
+        }
+
+        char *copy = (char*)arena.allocate(length ? length : 1, 1);
+        memcpy(copy, str, length);
+        slots[i].hash = hash;
+        slots[i].str = copy;
+        slots[i].length = length;
+        count++;
+        return copy;
+    }
+
+    // clear
+    void json_key_table::clear()
+    {
+        if (count)
+            memset(&slots[0], 0, sizeof(slot) * slots.size());
+        count = 0;
+    }
+
+    // get_size
+    size_t json_key_table::get_size() const
+    {
+        return count;
+    }
+
+    // grow
+    void json_key_table::grow()
+    {
+        std::vector<slot> old;
+        old.swap(slots);
+        slot empty = {0, NULL, 0};
+        slots.resize(old.empty() ? KEY_TABLE_MIN_SLOTS : old.size() * 2, empty);
+
+        size_t mask = slots.size() - 1;
+        for (size_t j = 0; j < old.size(); j++)
+        {
+            if (!old[j].hash)
+                continue;
+            size_t i = old[j].hash & mask;
+            while (slots[i].hash)
+                i = (i + 1) & mask;
+            slots[i] = old[j];
+        }
+    }
+}
@@ -0,0 +1,124 @@
+///////////////////////////////////////////////////////////////////////////////
+///  Copyright 2012 Garnel
+///
+///  Licensed under the Apache License, Version 2.0 (the "License");
+///  you may not use this file except in compliance with the License.
+///  You may obtain a copy of the License at
+///
+///    http://www.apache.org/licenses/LICENSE-2.0
+///
+///  Unless required by applicable law or agreed to in writing, software
+///  distributed under the License is distributed on an "AS IS" BASIS,
+///  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///////////////////////////////////////////////////////////////////////////////
+
+///
+/// \file       json_intern.h
+/// The declaration of json_key_table
+/// \author     Garnel
+/// \date       2026/10/15
+/// \version    2.3
+/// \copyright  Apache License, Version 2.0
+///
+
+#ifndef JSON_LITE_INTERN
+#define JSON_LITE_INTERN
+
+#include <cstddef>
+#include <vector>
+#include <stdint.h>
+
+#include "json_arena.h"
+
+namespace json_lite
+{
+    ///
+    /// \fn         hash_label
+    /// \brief      FNV-1a hash of a label
+    /// \note       Never 0, so 0 can mean "not computed"
+    ///
+    inline size_t hash_label(const char *str, size_t length)
+    {
+        uint64_t hash = 14695981039346656037ULL;
+        for (size_t i = 0; i < length; i++)
+        {
+            hash ^= (unsigned char)str[i];
+            hash *= 1099511628211ULL;
+        }
+        return hash ? (size_t)hash : 1;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// json_key_table
+    ///////////////////////////////////////////////////////////////////////////
+
+    ///
+    /// \class  json_key_table
+    /// \brief  The labels of a document, each kept once in the document's arena
+    /// \note   Labels with the same text share the same immutable memory,
+    ///         so the same pointer means the same label
+    ///
+    class json_key_table
+    {
+    public:
+        ///
+        /// \fn         json_key_table
+        /// \brief      The constructor of json_key_table
+        /// \param      _arena  The arena holding the labels
+        ///
+        json_key_table(json_arena &_arena);
+
+        ///
+        /// \fn         intern
+        /// \brief      Return the shared copy of a label, adding it if it is new
+        /// \param      str     The label
+        /// \param      length  The length of the label
+        /// \param      hash    The hash of the label by hash_label
+        /// \return     The label in the arena, valid until clear()
+        ///
+        const char* intern(const char *str, size_t length, size_t hash);
+
+        ///
+        /// \fn         clear
+        /// \brief      Forget all the labels
+        /// \note       Call it whenever the arena is reset. The slots are kept.
+        ///
+        void clear();
+
+        ///
+        /// \fn         get_size
+        /// \brief      Return the number of different labels
+        ///
+        size_t get_size() const;
+
+    private:
+        json_key_table(const json_key_table&);              ///< copy is not allowed
+        json_key_table& operator=(const json_key_table&);   ///< copy is not allowed
+
+        ///
+        /// \fn         grow
+        /// \brief      Double the slots and add the labels again
+        ///
+        void grow();
+
+    private:
+        ///
+        /// \struct slot
+        /// \brief  A slot of the table
+        ///
+        struct slot
+        {
+            size_t hash;        ///< the hash of the label, 0 if the slot is empty
+            const char *str;    ///< the label in the arena
+            size_t length;      ///< the length of the label
+        };
+
+        std::vector<slot> slots;    ///< the slots, the number is a power of 2
+        size_t count;               ///< the number of labels
+        json_arena &arena;          ///< the arena holding the labels
+    };
+}
+
+#endif // JSON_LITE_INTERN
@@ -24,6 +24,15 @@
 ///
 
 #include "json_lite.h"
+#include "json_index.h"
+#include "json_reader.h"
+#include "json_serializer.h"
+#include "json_stats.h"
+
+#include <cstring>
+#include <new>
+#include <stdint.h>
+#include <vector>
 
 ///
 /// \namespace  json_lite
@@ -60,6 +69,81 @@ namespace json_lite
         }
     }
 
+    ///
+    /// \fn         new_value
+    /// \brief      Create an element on the heap or in an arena
+    /// \param      arena   The arena, NULL for the heap
+    /// \param      _type   The type of the element
+    /// \param      _value  The value of the element
+    ///
+    inline json_value* new_value(json_arena *arena, json_type _type, const std::string &_value = std::string())
+    {
+        if (arena)
+            return new (arena->allocate(sizeof(json_value)))
+                json_value(_type, _value.data(), _value.size(), arena);
+        return new json_value(_type, _value.data(), _value.size(), NULL);
+    }
+
+    ///
+    /// \fn         free_value
+    /// \brief      Delete an element created by new_value
+    /// \note       Elements in an arena are left to the arena
+    ///
+    inline void free_value(json_value* &p)
+    {
+        if (p && !p->get_arena())
+            delete p;
+        p = NULL;
+    }
+
+    const size_t MEMBER_INDEX_THRESHOLD = 8;   ///< objects smaller than it are scanned without index
+
+    ///
+    /// \struct     member_slot
+    /// \brief      A slot of member_index
+    ///
+    struct member_slot
+    {
+        size_t hash;            ///< the hash of the label
+        json_value *label;      ///< the label, NULL if the slot is empty
+    };
+
+    ///
+    /// \struct     member_index
+    /// \brief      An open addressing hash table of the labels of an object
+    ///
+    struct member_index
+    {
+        member_slot *slots;     ///< the slots, the capacity is a power of 2
+        size_t capacity;        ///< the number of slots
+        size_t count;           ///< the number of labels
+    };
+
+    // append_utf8
+    void append_utf8(std::string &str, unsigned int code)
+    {
+        if (code < 0x80)
+            str += (char)code;
+        else if (code < 0x800)
+        {
+            str += (char)(0xC0 | (code >> 6));
+            str += (char)(0x80 | (code & 0x3F));
+        }
+        else if (code < 0x10000)
+        {
+            str += (char)(0xE0 | (code >> 12));
+            str += (char)(0x80 | ((code >> 6) & 0x3F));
+            str += (char)(0x80 | (code & 0x3F));
+        }
+        else
+        {
+            str += (char)(0xF0 | (code >> 18));
+            str += (char)(0x80 | ((code >> 12) & 0x3F));
+            str += (char)(0x80 | ((code >> 6) & 0x3F));
+            str += (char)(0x80 | (code & 0x3F));
+        }
+    }
+
     // error_value
     std::string error_value(json_parse_error error_type)
     {
@@ -128,6 +212,9 @@ namespace json_lite
         case UNCLOSED_ARRAY:
             return "The array is unclosed.";
             break;
+        case TOO_DEEP_NESTING:
+            return "The objects and arrays are nested too deeply.";
+            break;
         case EXTRA_CONTENT_AFTER_JSON:
             return "There is needless content after json.";
             break;
@@ -137,6 +224,65 @@ namespace json_lite
         }
     }
 
+    // json_parse_result
+    json_parse_result::json_parse_result()
+        :failed(false),
+         error(SHOULD_BE_OBJECT_OR_ARRAY),
+         offset(0),
+         line(1),
+         column(1)
+    {
+    }
+
+    ///
+    /// \fn         is_token_end
+    /// \brief      If the character can follow a number, true, false or null
+    ///
+    inline bool is_token_end(char c)
+    {
+        switch (c)
+        {
+        case ',':
+        case ':':
+        case ']':
+        case '}':
+        case '[':
+        case '{':
+        case '"':
+        case ' ':
+        case '\n':
+        case '\r':
+        case '\t':
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    ///
+    /// \fn         is_blank
+    /// \brief      If the character is a blank character
+    ///
+    inline bool is_blank(char c)
+    {
+        return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+    }
+
+    ///
+    /// \fn         advance_position
+    /// \brief      Move a line and position in line over some text
+    ///
+    inline void advance_position(const char *from, const char *to, int &line, int &column)
+    {
+        const char *last = NULL;    // the last '\n'
+        for (const char *p = from; p < to && (p = (const char*)memchr(p, '\n', to - p)) != NULL; p++)
+        {
+            line++;
+            last = p;
+        }
+        column = last ? (int)(to - last) : column + (int)(to - from);
+    }
+
     ///////////////////////////////////////////////////////////////////////////
     // json_value
     ///////////////////////////////////////////////////////////////////////////
@@ -144,55 +290,102 @@ namespace json_lite
     // json_value
     json_value::json_value(json_type _type)
         :type(_type),
+         value(""),
+         value_length(0),
+         owns_value(false),
+         arena(NULL),
+         label_hash(0),
          next(NULL),
          prev(NULL),
          parent(NULL),
          first_child(NULL),
-         last_child(NULL)
+         last_child(NULL),
+         members(NULL)
     {
-        switch (_type)
-        {
-        case JSON_TRUE:
-            value = "true";
-            break;
-        case JSON_FALSE:
-            value = "false";
-            break;
-        case JSON_NULL:
-            value = "null";
-            break;
-        default:
-            value = "";
-            break;
-        }
+        this->assign_value("", 0);
     }
 
     json_value::json_value(json_type _type, std::string _value)
         :type(_type),
+        value(""),
+        value_length(0),
+        owns_value(false),
+        arena(NULL),
+        label_hash(0),
         next(NULL),
         prev(NULL),
         parent(NULL),
         first_child(NULL),
-        last_child(NULL)
+        last_child(NULL),
+        members(NULL)
     {
         this->set_value(_value);
     }
 
+    json_value::json_value(json_type _type, const char *_value, size_t _length, json_arena *_arena)
+        :type(_type),
+        value(""),
+        value_length(0),
+        owns_value(false),
+        arena(_arena),
+        label_hash(0),
+        next(NULL),
+        prev(NULL),
+        parent(NULL),
+        first_child(NULL),
+        last_child(NULL),
+        members(NULL)
+    {
+        this->assign_value(_value, _length);
+    }
+
     // ~json_value
     json_value::~json_value()
     {
-        // delete the child first
-        safe_free(first_child);
+        // elements in an arena are freed by the arena
+        assert(!arena);
+
+        // chain the children in front of the next nodes, and delete the chain
+        // one node at a time, so deep or long trees never recurse
+        json_value *pending = next;
+        if (first_child)
+        {
+            json_value *tail = first_child;
+            while (tail->next)
+                tail = tail->next;
+            tail->next = pending;
+            pending = first_child;
+        }
         first_child = NULL;
         last_child = NULL;
-
-        // delete next node
-        safe_free(next);
         next = NULL;
 
+        while (pending)
+        {
+            json_value *cur = pending;
+            pending = cur->next;
+            if (cur->first_child)
+            {
+                json_value *tail = cur->first_child;
+                while (tail->next)
+                    tail = tail->next;
+                tail->next = pending;
+                pending = cur->first_child;
+            }
+            cur->first_child = NULL;
+            cur->last_child = NULL;
+            cur->next = NULL;
+            delete cur;
+        }
+
         // clear the connection to the previous node, and its parent
         prev = NULL;
         parent = NULL;
+
+        if (owns_value)
+            delete[] value;
+        value = NULL;
+        this->drop_member_index();
     }
 
     // get_type
@@ -204,38 +397,166 @@ namespace json_lite
     // set_value
     void json_value::set_value(std::string _value)
     {
+        this->assign_value(_value.data(), _value.size());
+    }
+    
+    // get_value
+    std::string json_value::get_value() const
+    {
+        if (type == JSON_NUMBER && value_length == 0)  //the text is not kept
+            return number_text(number);
+        return std::string(value, value_length);
+    }
+
+    // get_number_type
+    json_number_type json_value::get_number_type() const
+    {
+        assert(type == JSON_NUMBER);
+        return number.type;
+    }
+
+    // is_integer
+    bool json_value::is_integer() const
+    {
+        assert(type == JSON_NUMBER);
+        return number.type != NUMBER_DOUBLE;
+    }
+
+    // get_int64
+    int64_t json_value::get_int64() const
+    {
+        assert(type == JSON_NUMBER);
+        switch (number.type)
+        {
+        case NUMBER_INT64:
+            return number.i;
+        case NUMBER_UINT64:
+            return (int64_t)number.u;
+        default:
+            return (int64_t)number.d;
+        }
+    }
+
+    // get_uint64
+    uint64_t json_value::get_uint64() const
+    {
+        assert(type == JSON_NUMBER);
+        switch (number.type)
+        {
+        case NUMBER_INT64:
+            return (uint64_t)number.i;
+        case NUMBER_UINT64:
+            return number.u;
+        default:
+            return (uint64_t)number.d;
+        }
+    }
+
+    // get_double
+    double json_value::get_double() const
+    {
+        assert(type == JSON_NUMBER);
+        switch (number.type)
+        {
+        case NUMBER_INT64:
+            return (double)number.i;
+        case NUMBER_UINT64:
+            return (double)number.u;
+        default:
+            return number.d;
+        }
+    }
+
+    // set_int64
+    void json_value::set_int64(int64_t _value)
+    {
+        assert(type == JSON_NUMBER);
+        this->assign_value("", 0);
+        number.type = NUMBER_INT64;
+        number.i = _value;
+    }
+
+    // set_uint64
+    void json_value::set_uint64(uint64_t _value)
+    {
+        assert(type == JSON_NUMBER);
+        this->assign_value("", 0);
+        number.type = NUMBER_UINT64;
+        number.u = _value;
+    }
+
+    // set_double
+    void json_value::set_double(double _value)
+    {
+        assert(type == JSON_NUMBER);
+        this->assign_value("", 0);
+        number.type = NUMBER_DOUBLE;
+        number.d = _value;
+    }
+
+    // get_arena
+    json_arena* json_value::get_arena() const
+    {
+        return arena;
+    }
+
+    // assign_value
+    void json_value::assign_value(const char *_value, size_t _length)
+    {
+        const char *old_value = owns_value ? value : NULL;
+        owns_value = false;
+        label_hash = 0;
+
+        // the native value of the number
+        number.type = NUMBER_INT64;
+        number.i = 0;
+        if (this->get_type() == JSON_NUMBER && _length)
+            to_number(_value, _length, number);
+
         switch (this->get_type())
         {
         case JSON_STRING:
         case JSON_NUMBER:
-            value = _value;
+            if (_length == 0)
+            {
+                value = "";
+                value_length = 0;
+            }
+            else
+            {
+                char *temp = arena ? (char*)arena->allocate(_length, 1) : new char[_length];
+                memcpy(temp, _value, _length);
+                value = temp;
+                value_length = _length;
+                owns_value = !arena;
+            }
             break;
 
         // leave the _value passed in alone
         case JSON_TRUE:
             value = "true";
+            value_length = 4;
             break;
         case JSON_FALSE:
             value = "false";
+            value_length = 5;
             break;
         case JSON_NULL:
             value = "null";
+            value_length = 4;
             break;
         case JSON_OBJECT:
         case JSON_ARRAY:
             value = "";
+            value_length = 0;
             break;
         
         // default
         default:
             break;
         }
-    }
-    
-    // get_value
-    std::string json_value::get_value() const
-    {
-        return value;
+
+        delete[] old_value;
     }
 
     // set_next
@@ -263,6 +584,7 @@ namespace json_lite
     void json_value::set_first_child( json_value *_first_child )
     {
         assert(_first_child);
+        this->drop_member_index();
         first_child = _first_child;
     }
     
@@ -270,6 +592,7 @@ namespace json_lite
     void json_value::set_last_child( json_value *_last_child )
     {
         assert(_last_child);
+        this->drop_member_index();
         last_child = _last_child;
     }
     
@@ -306,27 +629,167 @@ namespace json_lite
     // get_child_by_label
     json_value* json_value::get_child_by_label(const std::string &label) const
     {
-        if (this->get_type() == JSON_STRING && this->get_value() == label)
-            return this->get_first_child();
-
-        json_value* elem;
-        if (this->get_first_child() != NULL)  //has children
+        // walk the element, its children and the next elements (with their
+        // children) in order, without recursion and without copying values
+        const json_value *cur = this,
+                         *stop = this->get_parent();
+        while (cur)
         {
-            elem = this->get_first_child()->get_child_by_label(label);
-            if (elem != NULL)
-                return elem;
+            if (cur->type == JSON_STRING && cur->value_length == label.size()
+                && memcmp(cur->value, label.data(), label.size()) == 0)
+                return cur->get_first_child();
+
+            if (cur->first_child)  //has children
+            {
+                cur = cur->first_child;
+                continue;
+            }
+
+            // siblings, or the siblings of the parents
+            while (cur && !cur->next)
+            {
+                cur = cur->parent;
+                if (cur == stop)
+                    cur = NULL;
+            }
+            if (cur)
+                cur = cur->next;
         }
 
-        if (this->get_next() != NULL)  //siblings
+        return NULL;
+    }
+
+    // get_member
+    json_value* json_value::get_member(const std::string &label) const
+    {
+        return this->get_member(label.data(), label.size(), 0);
+    }
+
+    json_value* json_value::get_member(const char *label, size_t length, size_t hash) const
+    {
+        if (type != JSON_OBJECT)
+            return NULL;
+
+        if (!members)
         {
-            elem = this->get_next()->get_child_by_label(label);
-            if (elem != NULL)
-                return elem;
+            size_t count = 0;
+            json_value *cur;
+            for (cur = first_child; cur && count < MEMBER_INDEX_THRESHOLD; cur = cur->next)
+                count++;
+
+            // small objects are scanned
+            if (count < MEMBER_INDEX_THRESHOLD)
+            {
+                for (cur = first_child; cur; cur = cur->next)
+                    if (cur->value_length == length && memcmp(cur->value, label, length) == 0)
+                        return cur->first_child;
+                return NULL;
+            }
+            this->build_member_index();
         }
 
+        if (!hash)  //not computed
+            hash = hash_label(label, length);
+        size_t mask = members->capacity - 1;
+        for (size_t i = hash & mask; members->slots[i].label; i = (i + 1) & mask)
+        {
+            const json_value *cur = members->slots[i].label;
+            if (members->slots[i].hash == hash && cur->value_length == length
+                && memcmp(cur->value, label, length) == 0)
+                return cur->first_child;
+        }
         return NULL;
     }
 
+    // build_member_index
+    void json_value::build_member_index() const
+    {
+        assert(type == JSON_OBJECT);
+        this->drop_member_index();
+
+        size_t count = 0;
+        for (json_value *cur = first_child; cur; cur = cur->next)
+            count++;
+
+        // at most half of the slots are used
+        size_t capacity = 16;
+        while (capacity < count * 2)
+            capacity *= 2;
+
+        if (arena)
+        {
+            members = (member_index*)arena->allocate(sizeof(member_index));
+            members->slots = (member_slot*)arena->allocate(sizeof(member_slot) * capacity);
+        }
+        else
+        {
+            members = new member_index;
+            members->slots = new member_slot[capacity];
+        }
+        memset(members->slots, 0, sizeof(member_slot) * capacity);
+        members->capacity = capacity;
+        members->count = 0;
+
+        for (json_value *cur = first_child; cur; cur = cur->next)
+            this->index_member(cur);
+    }
+
+    // index_member
+    void json_value::index_member(json_value *label) const
+    {
+        assert(members && label->type == JSON_STRING);
+        if ((members->count + 1) * 2 > members->capacity)  //too full
+        {
+            this->build_member_index();
+            return;  //the label is already a child, so it is indexed
+        }
+
+        size_t hash = label->get_label_hash(),
+               mask = members->capacity - 1,
+               i = hash & mask;
+        for (; members->slots[i].label; i = (i + 1) & mask)
+        {
+            const json_value *cur = members->slots[i].label;
+            if (members->slots[i].hash == hash && cur->value_length == label->value_length
+                && (cur->value == label->value  //interned
+                    || memcmp(cur->value, label->value, label->value_length) == 0))
+                return;  //the first label wins
+        }
+        members->slots[i].hash = hash;
+        members->slots[i].label = label;
+        members->count++;
+    }
+
+    // share_value
+    void json_value::share_value(const char *_value, size_t _length, size_t hash)
+    {
+        assert(type == JSON_STRING);
+        if (owns_value)
+            delete[] value;
+        value = _value;
+        value_length = _length;
+        owns_value = false;
+        label_hash = hash;
+    }
+
+    // get_label_hash
+    size_t json_value::get_label_hash() const
+    {
+        return label_hash ? label_hash : hash_label(value, value_length);
+    }
+
+    // drop_member_index
+    void json_value::drop_member_index() const
+    {
+        // an index in the arena is freed with the arena
+        if (members && !arena)
+        {
+            delete[] members->slots;
+            delete members;
+        }
+        members = NULL;
+    }
+
     // add_child
     void json_value::add_child( json_value* _child )
     {
@@ -335,15 +798,19 @@ namespace json_lite
         {
             this->last_child->set_next(_child);
             _child->set_prev(this->get_last_child());
-            this->set_last_child(_child);
+            last_child = _child;
             _child->set_parent(this);
         }
         else  //has no child yet
         {
-            this->set_first_child(_child);
-            this->set_last_child(_child);
+            first_child = _child;
+            last_child = _child;
             _child->set_parent(this);
         }
+
+        // keep the index of labels up to date
+        if (members)
+            this->index_member(_child);
     }
 
     // add_pair
@@ -352,8 +819,8 @@ namespace json_lite
         assert(this->get_type() == JSON_OBJECT);
         assert(_value != NULL);
         
-        //key
-        json_value *_k = new json_value(JSON_STRING, _key);
+        //key, in the same arena as the object
+        json_value *_k = new_value(arena, JSON_STRING, _key);
 
         //value
         _k->add_child(_value);
@@ -365,22 +832,13 @@ namespace json_lite
     // output
     bool json_value::output(const std::string out_file, bool format, int indent_level) const
     {
-        // the standard output, restore it at the end
-        std::streambuf *std_buf = std::cout.rdbuf();
         std::ofstream json_file(out_file.c_str());
         if (!json_file.is_open())
         {
             std::cout << "File cannot be opened." << std::endl;
             return false;
         }
-
-        // redirect the standard output the the file
-        std::cout.rdbuf(json_file.rdbuf());
-        bool result = this->output(format, indent_level);
-
-        // restore the standard output
-        std::cout.rdbuf(std_buf);
-        return result;
+        return this->output(json_file, json_format(format), indent_level);
     }
 
     bool json_value::output(const char* out_file, bool format, int indent_level) const
@@ -391,27 +849,15 @@ namespace json_lite
 
     bool json_value::output(bool format, int indent_level) const
     {
-        assert(this);
-        bool result;  // if the output is successful
-        switch (this->get_type())
-        {
-        case JSON_STRING:
-        case JSON_NUMBER:
-        case JSON_TRUE:
-        case JSON_FALSE:
-        case JSON_NULL:
-            result = print_json_value(this, format, indent_level);
-            break;
-        case JSON_OBJECT:
-            result = print_json_object(this, format, indent_level);
-            break;
-        case JSON_ARRAY:
-            result = print_json_array(this, format, indent_level);
-            break;
-        default:
-            break;
-        }
-        return result;
+        return this->output(std::cout, json_format(format), indent_level);
+    }
+
+    bool json_value::output(std::ostream &stream, const json_format &format, int indent_level) const
+    {
+        json_buffer out(stream);
+        json_serializer serializer(out, format);
+        serializer.write(this, indent_level);
+        return out.flush();
     }
     
     // print_json_object
@@ -419,65 +865,7 @@ namespace json_lite
     {
         // the json element must be a object
         assert(obj->get_type() == JSON_OBJECT);
-
-        if (format)
-            for (int i = 0; i < indent_level; i++)
-                std::cout << "\t";
-        std::cout << '{';
-        indent_level++;
-
-        json_value *cur = obj->get_first_child(),
-                   *cur_child;
-        while (cur)  //children
-        {
-            if (format)
-                std::cout << '\n';
-
-            // output the label
-            print_json_value(cur, format, indent_level);
-
-            // the ':'
-            std::cout << ':';
-            if (format)
-                std::cout << ' ';
-
-            //the value
-            cur_child = cur->get_first_child();
-            json_type _type = cur_child->get_type();
-            if ((_type == JSON_OBJECT || _type == JSON_ARRAY)
-                && cur_child->get_first_child() != NULL)   //empty object or array will be printed directly as "{}","[]"
-            {
-                if (format)
-                    std::cout << '\n';
-                cur_child->output(format, indent_level);
-            }
-            else
-                cur_child->output();
-            
-            cur = cur->next;
-            // if it has more children, print ','
-            if (cur)
-            {
-                std::cout << ',';
-            }
-            else 
-            {
-                indent_level--;
-                if (format)
-                {
-                    std::cout << std::endl;
-                    for (int i = 0; i < indent_level; i++)
-                        std::cout << '\t';
-                }
-            }
-        }
-        
-        // the end
-        std::cout << '}';
-
-        //flush the output
-        std::cout.flush();
-        return true;
+        return obj->output(format, indent_level);
     }
     
     // print_json_array
@@ -485,47 +873,7 @@ namespace json_lite
     {
         // the json element must be a array
         assert(arr->get_type() == JSON_ARRAY);
-
-        if (format)
-            for (int i = 0; i < indent_level; i++)
-                std::cout << "\t";
-        std::cout << '[';
-        indent_level++;
-
-        json_value *cur = arr->get_first_child();
-        while (cur)  //children
-        {
-            if (format)
-                std::cout << '\n';
-
-            //the value
-            cur->output(format, indent_level);
-
-            cur = cur->next;
-
-            // if it has more children, print ','
-            if (cur)
-            {
-                std::cout << ',';
-            }
-            else 
-            {
-                indent_level--;
-                if (format)
-                {
-                    std::cout << std::endl;
-                    for (int i = 0; i < indent_level; i++)
-                        std::cout << '\t';
-                }
-            }
-        }
-
-        // the end
-        std::cout << ']';
-
-        //flush the output
-        std::cout.flush();
-        return true;
+        return arr->output(format, indent_level);
     }
     
     // print_json_value
@@ -534,35 +882,13 @@ namespace json_lite
         // only for strings, numbers, null, true and false
         json_type _type = elem->get_type();
         assert(_type != JSON_OBJECT && _type != JSON_ARRAY);
-
-        // format the output
-        if (format)
-            for (int i = 0; i < indent_level; i++)
-                std::cout << '\t';
-        
-        if (elem->get_type() == JSON_STRING)
-        {
-            std::cout << '"';
-            std::cout << elem->get_value();
-            std::cout << '"';
-        }
-        else
-        {
-            std::cout << elem->get_value();
-        }
-        return true;
-    }
+        return elem->output(format, indent_level);
+    }
 
     // operator<<
     std::ostream& operator<<(std::ostream& output, const json_value &value)
     {
-        // the standard output, restore it at the end
-        std::streambuf *std_buf = std::cout.rdbuf();
-        std::cout.rdbuf(output.rdbuf());
-        value.output(false);
-
-        // restore the standard output
-        std::cout.rdbuf(std_buf);
+        value.output(output, json_format(false));
         return output;
     }
 
@@ -572,8 +898,22 @@ namespace json_lite
 
     // json_parser
     json_parser::json_parser( const std::string file_name )
-        :line(1),
-         pos_in_line(1)
+        :from_memory(false),
+         reader(NULL),
+         line(1),
+         pos_in_line(1),
+         buffer_begin(NULL),
+         buffer_end(NULL),
+         current_char(NULL),
+         buffer_offset(0),
+         arena(NULL),
+         key_table(NULL),
+         max_depth(0),
+         keep_number_text(false),
+         stats(NULL),
+         stats_scopes(0),
+         record_begin(NULL),
+         parallel_ranges(0)
     {
         json_file.open(file_name.c_str());
         if (!json_file.is_open())
@@ -581,12 +921,51 @@ namespace json_lite
             throw "The file cannot be opened!";
         }
         json_file.seekg(0, std::ios::beg);
-        
-        memset(buffer, 0, BUF_SIZE);
-        if (!json_file.eof())
-            json_file.read(buffer, BUF_SIZE - 1);
-        
-        current_char = buffer;
+        buffer.resize(BUF_SIZE);
+
+        this->fill_buffer();
+    }
+
+    json_parser::json_parser( const char* data, size_t length )
+        :from_memory(true),
+         reader(NULL),
+         line(1),
+         pos_in_line(1),
+         buffer_begin(data),
+         buffer_end(data + length),
+         current_char(data),
+         buffer_offset(0),
+         arena(NULL),
+         key_table(NULL),
+         max_depth(0),
+         keep_number_text(false),
+         stats(NULL),
+         stats_scopes(0),
+         record_begin(NULL),
+         parallel_ranges(0)
+    {
+        assert(data || length == 0);
+    }
+
+    json_parser::json_parser(json_reader &_reader)
+        :from_memory(false),
+         reader(&_reader),
+         line(1),
+         pos_in_line(1),
+         buffer_begin(NULL),
+         buffer_end(NULL),
+         current_char(NULL),
+         buffer_offset(0),
+         arena(NULL),
+         key_table(NULL),
+         max_depth(0),
+         keep_number_text(false),
+         stats(NULL),
+         stats_scopes(0),
+         record_begin(NULL),
+         parallel_ranges(0)
+    {
+        this->fill_buffer();
     }
 
     // ~json_parser
@@ -601,217 +980,452 @@ namespace json_lite
     json_value* json_parser::parse_value( json_type _type )
     {
         json_value *_value = NULL;
-        try
+        parse_result = json_parse_result();
+        switch (_type)
         {
-            switch (_type)
+        case JSON_STRING:
             {
-            case JSON_STRING:
-                _value = new json_value(JSON_STRING, this->parse_string());
-                break;
-            case JSON_NUMBER:
-                _value = new json_value(JSON_NUMBER, this->parse_number());
-                break;
-            case JSON_OBJECT:
-                _value = this->parse_object();
-                break;
-            case JSON_ARRAY:
-                _value = this->parse_array();
-                break;
-            case JSON_TRUE:
-                _value = new json_value(JSON_TRUE);
-                this->parse_true();
-                break;
-            case JSON_FALSE:
-                _value = new json_value(JSON_FALSE);
-                this->parse_false();
-                break;
-            case JSON_NULL:
-                _value = new json_value(JSON_NULL);
-                this->parse_null();
-                break;
-            default:
-                throw INVALID_TYPE;
+                std::string str = this->parse_string();
+                if (!parse_result.failed)
+                    _value = new_value(arena, JSON_STRING, str);
             }
-            return _value;
-        }
-        catch (json_parse_error error_type)
-        {
-            this->print_error(error_type);
-            safe_free(_value);
-            return (json_value*)NULL;
+            break;
+        case JSON_NUMBER:
+            {
+                std::string text = this->parse_number();
+                if (!parse_result.failed)
+                    _value = this->new_number(text);
+            }
+            break;
+        case JSON_OBJECT:
+            _value = this->parse_object();
+            break;
+        case JSON_ARRAY:
+            _value = this->parse_array();
+            break;
+        case JSON_TRUE:
+            this->parse_true();
+            if (!parse_result.failed)
+                _value = new_value(arena, JSON_TRUE);
+            break;
+        case JSON_FALSE:
+            this->parse_false();
+            if (!parse_result.failed)
+                _value = new_value(arena, JSON_FALSE);
+            break;
+        case JSON_NULL:
+            this->parse_null();
+            if (!parse_result.failed)
+                _value = new_value(arena, JSON_NULL);
+            break;
+        default:
+            this->fail(INVALID_TYPE);
+            break;
         }
+
+        return _value;
     }
 
     // run
     json_value* json_parser::run()
     {
+        json_parse_result result;
+        json_value *_value = this->run(result);
+        if (result.failed)
+            this->print_error(result);
+        return _value;
+    }
+
+    json_value* json_parser::run(json_parse_result &result)
+    {
+        parse_result = json_parse_result();
+        JSON_LITE_STAT_PARSE();
+
         //escape blank characters
         this->escape_blank();
 
-        json_type _type;
         json_value *_value = NULL;
-        try
+        switch (this->get_char())
         {
-            switch (this->get_char())
-            {
-            case '{':
-                _type = JSON_OBJECT;
+        case '{':
+            _value = this->parse_container(JSON_OBJECT);
+            break;
+        case '[':
+            _value = this->parse_container(JSON_ARRAY);
+            break;
+        default:
+            this->fail(SHOULD_BE_OBJECT_OR_ARRAY);
+            break;
+        }
+
+        if (_value != NULL   /*no error in parse*/
+            && !this->is_end())  //after the json should be only blank characters
+        {
+            this->fail(EXTRA_CONTENT_AFTER_JSON);
+            free_value(_value);
+            _value = NULL;
+        }
+        JSON_LITE_STAT(stats->documents += _value != NULL);
+        result = parse_result;
+        return _value;
+    }
+
+    // run
+    bool json_parser::run(json_handler &handler)
+    {
+        json_parse_result result;
+        bool ok = this->run(handler, result);
+        if (result.failed)
+            this->print_error(result);
+        return ok;
+    }
+
+    bool json_parser::run(json_handler &handler, json_parse_result &result)
+    {
+        parse_result = json_parse_result();
+        JSON_LITE_STAT_PARSE();
+
+        //escape blank characters
+        this->escape_blank();
+
+        switch (this->get_char())
+        {
+        case '{':
+            if (this->parse_events(JSON_OBJECT, handler))
                 break;
-            case '[':
-                _type = JSON_ARRAY;
+            result = parse_result;  //stopped by the handler or an error
+            return !result.failed;
+        case '[':
+            if (this->parse_events(JSON_ARRAY, handler))
                 break;
-            default:
-                throw SHOULD_BE_OBJECT_OR_ARRAY;
-            }
-            _value =  this->parse_value(_type);
-            if (_value != NULL   /*no error in parse*/
-                && this->escape_blank() != '\0')  //after the json should be only blank characters
-                throw EXTRA_CONTENT_AFTER_JSON;
-            return _value;
+            result = parse_result;
+            return !result.failed;
+        default:
+            this->fail(SHOULD_BE_OBJECT_OR_ARRAY);
+            result = parse_result;
+            return false;
         }
-        catch (json_parse_error error_type)
+
+        if (!this->is_end())  //after the json should be only blank characters
+            this->fail(EXTRA_CONTENT_AFTER_JSON);
+        JSON_LITE_STAT(stats->documents += !parse_result.failed);
+        result = parse_result;
+        return !result.failed;
+    }
+
+    // next_document
+    json_value* json_parser::next_document()
+    {
+        json_parse_result result;
+        json_value *_value = this->next_document(result);
+        if (result.failed)
+            this->print_error(result);
+        return _value;
+    }
+
+    json_value* json_parser::next_document(json_parse_result &result)
+    {
+        parse_result = json_parse_result();
+        JSON_LITE_STAT_PARSE();
+
+        //escape blank characters, nothing left is the end of the stream
+        if (this->is_end())
         {
-            this->print_error(error_type);
+            result = parse_result;
             return (json_value*)NULL;
         }
+
+        //the json is kept through refills until it is parsed, see skip_line
+        record_begin = current_char;
+        json_value *_value = NULL;
+        switch (this->get_char())
+        {
+        case '{':
+            _value = this->parse_container(JSON_OBJECT);
+            break;
+        case '[':
+            _value = this->parse_container(JSON_ARRAY);
+            break;
+        default:
+            this->fail(SHOULD_BE_OBJECT_OR_ARRAY);
+            break;
+        }
+
+        JSON_LITE_STAT(stats->documents += _value != NULL);
+        result = parse_result;
+        if (result.failed)
+            this->skip_line();
+        record_begin = NULL;
+        return _value;
     }
 
-    // escape_blank
-    char json_parser::escape_blank()
+    // get_result
+    const json_parse_result& json_parser::get_result() const
+    {
+        return parse_result;
+    }
+
+    // is_end
+    bool json_parser::is_end()
+    {
+        return this->escape_blank() == '\0' && this->at_end();
+    }
+
+    // parse_elements
+    bool json_parser::parse_elements(json_value *array)
     {
-        char temp_char = this->get_current_char();
-        while (temp_char == ' ' || temp_char == '\n' ||
-            temp_char == '\r' || temp_char == '\t')
+        //escape blank characters
+        char temp_char = this->escape_blank();
+        while (true)
         {
+            json_value *_value = this->parse_element(temp_char);
+            if (!_value)  //an error in the element
+                return false;
+            // objects and arrays are counted by parse_events
+            JSON_LITE_STAT(if (temp_char != '{' && temp_char != '[') stats->values[_value->get_type()]++);
+            array->add_child(_value);
+
+            // the element separator ',' or the end of the range
+            temp_char = this->escape_blank();
+            if (temp_char == '\0' && this->at_end())
+                return true;
+            if (temp_char != ',')
+                return this->fail(INVALID_CHARACTER);
             this->get_char();
-            temp_char = this->get_current_char();
+            temp_char = this->escape_blank();
         }
-        return temp_char;
     }
 
-    // parse_string
-    std::string json_parser::parse_string()
+    // parse_element
+    json_value* json_parser::parse_element(char temp_char)
     {
-        std::string _value;         // the value of the string to parse
-        char temp[BUF_SIZE],        // string buffer
-             *p = temp;             // cursor to the current position of buffer
-        memset(temp, 0, BUF_SIZE);
-        int cursor = 0;             // current character position of buffer
-
-        char temp_char = this->get_char();
-        while (temp_char)
+        json_value *_value = NULL;
+        switch (temp_char)
         {
-            //The end of the string
-            if (temp_char == '\"')
-                break;
-            
-            //copy the character to the string(through buffer)
-            *p++ = temp_char;
-            cursor++;
-            if (cursor == BUF_SIZE - 1)  //buffer is full
+        case '\"':
+            this->get_char();
             {
-                _value += temp;
-                memset(temp, 0, BUF_SIZE);
-                p = temp;
-                cursor = 0;
+                std::string str = this->parse_string();
+                if (!parse_result.failed)
+                    _value = new_value(arena, JSON_STRING, str);
             }
-
-            //The escape characters
-            if (temp_char == '\\')
+            break;
+        case '+':
+        case '-':
+        case '0':
+        case '1':
+        case '2':
+        case '3':
+        case '4':
+        case '5':
+        case '6':
+        case '7':
+        case '8':
+        case '9':
             {
-                temp_char = this->get_char();
-                switch (temp_char)
-                {
-                case '\"':
-                case '\\':
-                case '/':
-                case 'b':
-                case 'f':
-                case 'n':
-                case 'r':
-                case 't':
-                case 'u':
-                    *p++ = temp_char;
-                    cursor++;
-                    if (cursor == BUF_SIZE - 1)  //buffer is full
-                    {
-                        _value += temp;
-                        memset(temp, 0, BUF_SIZE);
-                        p = temp;
-                        cursor = 0;
-                    }
-                    break;
-                default:
-                    throw INVALID_ESCAPE_CHARACTER;
-                    break;
-                }
+                std::string text = this->parse_number();
+                if (!parse_result.failed)
+                    _value = this->new_number(text);
             }
-
-            //read the next character
-            temp_char = this->get_char();
+            break;
+        case 't':
+            this->parse_true();
+            if (!parse_result.failed)
+                _value = new_value(arena, JSON_TRUE, "true");
+            break;
+        case 'f':
+            this->parse_false();
+            if (!parse_result.failed)
+                _value = new_value(arena, JSON_FALSE, "false");
+            break;
+        case 'n':
+            this->parse_null();
+            if (!parse_result.failed)
+                _value = new_value(arena, JSON_NULL, "null");
+            break;
+        case '{':
+            this->get_char();
+            _value = this->parse_container(JSON_OBJECT);
+            break;
+        case '[':
+            this->get_char();
+            _value = this->parse_container(JSON_ARRAY);
+            break;
+        case ',':
+            this->fail(EMPTY_VALUE);
+            break;
+        case '\0':
+            this->fail(this->at_end() ? EMPTY_VALUE : INVALID_CHARACTER);
+            break;
+        default:
+            this->fail(INVALID_CHARACTER);
+            break;
         }
-        _value += temp;
         return _value;
     }
 
-    // parse_number
-    std::string json_parser::parse_number()
+    // skip_line
+    void json_parser::skip_line()
     {
-        std::string _number;        // the value of the number to parse
-        char temp[BUF_SIZE],        // string buffer
-             *p = temp;             // cursor to the current position of buffer
-        memset(temp, 0, BUF_SIZE);
-        int cursor = 0;             // current character position of buffer
-
-        bool dot_parsed = false,    // if the dot is parsed
-             in_exponent = false,   // while parsing exponent, it turns true
-             leading_zero = false,  // if it has leading zeros
-             has_digit = false,     // if the part has digit
-             has_sign = false;      // if the number has sign(+/-)
-
-        char temp_char = this->get_current_char();
-        while (temp_char)
+        // back to the json of the stream, the next one begins on the next line
+        // even when the error is found on it, like a json cut short
+        if (record_begin)
+        {
+            current_char = record_begin;
+            record_begin = NULL;
+        }
+
+        do
         {
-            //a number can only exit in some pair of a object or a element,
-            //so ',', ']', '}' and blank characters will end a number
-            if (temp_char == ',' || temp_char == ']' || temp_char == '}' ||
-                temp_char == ' ' || temp_char == '\t' || temp_char == '\n' ||
-                temp_char == '\r')
+            const char *p = current_char < buffer_end
+                ? (const char*)memchr(current_char, '\n', buffer_end - current_char) : NULL;
+            if (p)
             {
-                if (!has_digit)  //number has no digits
-                    throw MISSING_DIGIT;
+                current_char = p + 1;
+                return;
+            }
+            current_char = buffer_end;
+        } while (this->fill_buffer());
+    }
 
-                if (in_exponent && !has_digit) //exponent has nothing or only a sign
-                    throw INVALID_EXPONENT;
+    // run_indexed
+    json_value* json_parser::run_indexed()
+    {
+        json_parse_result result;
+        json_value *root = this->run_indexed(result);
+        if (result.failed)
+            this->print_error(result);
+        return root;
+    }
 
-                break;
+    json_value* json_parser::run_indexed(json_parse_result &result)
+    {
+        if (!from_memory)
+            return this->run(result);
+        parse_result = json_parse_result();
+        JSON_LITE_STAT_PARSE();
+
+        // stage 1: index the tokens, a text too long to index is parsed by run()
+        const char *base = current_char;
+        structural_index index;
+        bool indexed;
+        {
+            JSON_LITE_STAT_TIME(index_time);
+            indexed = index.build(base, buffer_end - base);
+        }
+        if (!indexed)
+            return this->run(result);
+
+        // stage 2: walk the tokens
+        json_value *root = NULL,
+                   *_key = NULL;
+        if (this->walk_index(base, index, root, _key))
+        {
+            current_char = buffer_end;
+            JSON_LITE_STAT(stats->documents++);
+            result = parse_result;
+            return root;
+        }
+        free_value(_key);
+        free_value(root);
+
+        // the index tells an error from tokens, not characters, so the text
+        // is parsed again by run() for the same error at the same position
+        current_char = base;
+        return this->run(result);
+    }
+
+    // walk_index
+    bool json_parser::walk_index(const char *base, const structural_index &index, json_value *&root, json_value *&_key)
+    {
+        size_t i = 0, count = index.size();
+
+        // a stack of open objects and arrays
+        std::vector<json_value*> stack;
+        json_value *_value;
+        bool expect_value = true,   // a value (or a pair in an object) is expected
+             first = true;          // nothing is in the current object or array yet
+
+        if (count == 0 || (base[index.get_position(0)] != '{' && base[index.get_position(0)] != '['))
+            return this->fail(SHOULD_BE_OBJECT_OR_ARRAY);
+        root = new_value(arena, base[index.get_position(i++)] == '{' ? JSON_OBJECT : JSON_ARRAY);
+        stack.push_back(root);
+        JSON_LITE_STAT(stats->values[root->get_type()]++;
+            if (stats->max_depth < 1) stats->max_depth = 1);
+        if (max_depth && stack.size() > max_depth)
+            return this->fail(TOO_DEEP_NESTING);
+
+        while (!stack.empty())
+        {
+            bool in_object = stack.back()->get_type() == JSON_OBJECT;
+            json_parse_error unclosed = in_object ? UNCLOSED_OBJECT : UNCLOSED_ARRAY;
+            char close = in_object ? '}' : ']';
+            if (i == count)
+                return this->fail(unclosed);
+            current_char = base + index.get_position(i++);
+            char temp_char = *current_char;
+
+            // the element separator ',' or the end of the object or array
+            if (!expect_value)
+            {
+                if (temp_char == ',')
+                {
+                    expect_value = true;
+                    first = false;
+                }
+                else if (temp_char == close)
+                    stack.pop_back();
+                else
+                    return this->fail(INVALID_CHARACTER);
+                continue;
+            }
+
+            if (temp_char == close)
+            {
+                if (!first)  //extra comma (like this: "XXX, }")
+                    return this->fail(EXTRA_COMMA);
+                stack.pop_back();
+                expect_value = false;
+                continue;
             }
 
-            //copy the character to the string(through buffer)
-            *p++ = temp_char;
-            cursor++;
-            if (cursor == BUF_SIZE - 1)  //buffer is full
+            if (in_object)
             {
-                _number += temp;
-                memset(temp, 0, BUF_SIZE);
-                p = temp;
-                cursor = 0;
+                //label
+                if (temp_char != '\"')
+                    return this->fail(MISSING_QUOTATION);
+                this->get_char();
+                std::string label = this->parse_string();
+                if (parse_result.failed)
+                    return false;
+                _key = this->new_label(label);
+                JSON_LITE_STAT(stats->labels++);
+
+                //the next token must be ':'
+                if (i == count)
+                    return this->fail(unclosed);
+                if (base[index.get_position(i++)] != ':')
+                    return this->fail(MISSING_COLON);
+                if (i == count)
+                    return this->fail(unclosed);
+                current_char = base + index.get_position(i++);
+                temp_char = *current_char;
             }
 
+            _value = NULL;
             switch (temp_char)
             {
-            //digits
-            case '0':
-                if (leading_zero)  //leading zero
-                    throw LEADING_ZERO;
-                
-                if (!leading_zero && !has_digit)  //the first one is a zero
+            case '\"':
+                this->get_char();
                 {
-                    leading_zero = true;
-                    has_digit = true;
+                    std::string str = this->parse_string();
+                    if (!parse_result.failed)
+                        _value = new_value(arena, JSON_STRING, str);
                 }
                 break;
-
+            case '+':
+            case '-':
+            case '0':
             case '1':
             case '2':
             case '3':
@@ -821,380 +1435,789 @@ namespace json_lite
             case '7':
             case '8':
             case '9':
-                if (leading_zero)  //leading zero
-                    throw LEADING_ZERO;
-                has_digit = true;
+                {
+                    std::string text = this->parse_number();
+                    if (!parse_result.failed)
+                        _value = this->new_number(text);
+                }
                 break;
-
-            //has sign
-            case '+':
-            case '-':
-                if (has_digit)  //sign should in front of a number
-                    throw INVALID_SIGN_POSITION;
-                else if (has_sign)  //more than one sign
-                    throw TOO_MANY_SIGNS_IN_NUMBER;
-                else    
-                    has_sign = true;
+            case 't':
+                this->parse_true();
+                if (!parse_result.failed)
+                    _value = new_value(arena, JSON_TRUE, "true");
                 break;
-
-            //The dot
-            case  '.':
-                leading_zero = false;
-                if (dot_parsed)
-                    throw TOO_MANY_DOTS_IN_NUMBER;
-                else
-                    dot_parsed = true;
+            case 'f':
+                this->parse_false();
+                if (!parse_result.failed)
+                    _value = new_value(arena, JSON_FALSE, "false");
+                break;
+            case 'n':
+                this->parse_null();
+                if (!parse_result.failed)
+                    _value = new_value(arena, JSON_NULL, "null");
                 break;
+            case '{':
+                _value = new_value(arena, JSON_OBJECT);
+                break;
+            case '[':
+                _value = new_value(arena, JSON_ARRAY);
+                break;
+            case ',':
+                return this->fail(in_object ? INVALID_CHARACTER : EMPTY_VALUE);
+            default:
+                return this->fail(INVALID_CHARACTER);
+            }
+            if (!_value)  //an error in the value
+                return false;
+            JSON_LITE_STAT(stats->values[_value->get_type()]++);
+
+            // construct the json tree
+            if (_key)
+            {
+                _key->add_child(_value);
+                stack.back()->add_child(_key);
+                _key = NULL;
+            }
+            else
+                stack.back()->add_child(_value);
 
-            //exponent
-            case 'e':
-            case 'E':
-                if (!has_digit)  //the base has no digit
-                    throw MISSING_DIGIT;
-                
-                if (in_exponent)  //already has a exponent
-                    throw TOO_MANY_EXPONENTS;
-                
-                in_exponent = true;
-                dot_parsed = false;
-                has_digit = false;
-                has_sign = false;
-                leading_zero = false;
+            switch (_value->get_type())
+            {
+            case JSON_OBJECT:
+            case JSON_ARRAY:
+                stack.push_back(_value);
+                JSON_LITE_STAT(if (stats->max_depth < stack.size()) stats->max_depth = stack.size());
+                if (max_depth && stack.size() > max_depth)
+                    return this->fail(TOO_DEEP_NESTING);
+                expect_value = true;
+                first = true;
+                break;
+            case JSON_NUMBER:
+            case JSON_TRUE:
+            case JSON_FALSE:
+            case JSON_NULL:
+                // "truex" is not a true, nor "1\0" a number
+                if (current_char != buffer_end && !is_token_end(*current_char))
+                    return this->fail(INVALID_CHARACTER);
+                expect_value = false;
                 break;
             default:
-                if (in_exponent)
-                    throw INVALID_EXPONENT;
-                else
-                    throw INVALID_BASE;
+                expect_value = false;
                 break;
             }
+        }
 
-            //read the next character
-            this->get_char();
-            temp_char = this->get_current_char();
+        //after the json should be only blank characters
+        if (i != count)
+        {
+            current_char = base + index.get_position(i);
+            return this->fail(EXTRA_CONTENT_AFTER_JSON);
         }
-        _number += temp;
-        return _number;
+        return true;
     }
 
-    // parse_true
-    std::string json_parser::parse_true()
+    // set_arena
+    void json_parser::set_arena(json_arena *_arena)
     {
-        char temp[5],
-             *p = temp;
-        memset(temp, 0, 5);
-
-        *p++ = this->get_char();    // 't'
-        *p++ = this->get_char();    // 'r'
-        *p++ = this->get_char();    // 'u'
-        *p++ = this->get_char();    // 'e'
-        
-        if (strcmp(temp, "true") != 0)
-            throw ERROR_IN_TRUE;
-
-        return "true";
+        arena = _arena;
     }
-    
-    // parse_false
-    std::string json_parser::parse_false()
+
+    // set_key_table
+    void json_parser::set_key_table(json_key_table *_key_table)
     {
-        char temp[6],
-             *p = temp;
-        memset(temp, 0, 6);
+        key_table = _key_table;
+    }
 
-        *p++ = this->get_char();       // 'f'
-        *p++ = this->get_char();    // 'a'
-        *p++ = this->get_char();    // 'l'
-        *p++ = this->get_char();    // 's'
-        *p++ = this->get_char();    // 'e'
-        
-        if (strcmp(temp, "false"))
-            throw ERROR_IN_FALSE;
+    // set_max_depth
+    void json_parser::set_max_depth(size_t depth)
+    {
+        max_depth = depth;
+    }
 
-        return "false";
+    // set_keep_number_text
+    void json_parser::set_keep_number_text(bool keep)
+    {
+        keep_number_text = keep;
     }
 
-    // parse_null
-    std::string json_parser::parse_null()
+    // set_stats
+    void json_parser::set_stats(json_parse_stats *_stats)
     {
-        char temp[5],
-             *p = temp;
-        memset(temp, 0, 5);
+        stats = _stats;
+    }
 
-        *p++ = this->get_char();       // 'n'
-        *p++ = this->get_char();    // 'u'
-        *p++ = this->get_char();    // 'l'
-        *p++ = this->get_char();    // 'l'
-        
-        if (strcmp(temp, "null"))
-            throw ERROR_IN_FALSE;
+    // new_label
+    json_value* json_parser::new_label(const std::string &text)
+    {
+        if (!key_table)
+            return new_value(arena, JSON_STRING, text);
 
-        return "null";
+        size_t hash = hash_label(text.data(), text.size());
+        json_value *_key = new_value(arena, JSON_STRING);
+        _key->share_value(key_table->intern(text.data(), text.size(), hash), text.size(), hash);
+        return _key;
     }
 
-    // parse_object
-    json_value* json_parser::parse_object()
+    // new_number
+    json_value* json_parser::new_number(const std::string &text)
     {
-        json_value *obj = new json_value(JSON_OBJECT),
-                   *_key, *_value;
-        
-        try 
+        if (keep_number_text)
+            return new_value(arena, JSON_NUMBER, text);
+
+        json_number _number;
+        if (!to_number(text.data(), text.size(), _number))  //out of range, keep the text
+            return new_value(arena, JSON_NUMBER, text);
+
+        json_value *_value = new_value(arena, JSON_NUMBER);
+        switch (_number.type)
         {
-            //escape blank characters
-            char temp_char = this->escape_blank();
+        case NUMBER_INT64:
+            _value->set_int64(_number.i);
+            break;
+        case NUMBER_UINT64:
+            _value->set_uint64(_number.u);
+            break;
+        default:
+            _value->set_double(_number.d);
+            break;
+        }
+        return _value;
+    }
+
+    // escape_blank
+    char json_parser::escape_blank()
+    {
+        do
+        {
+            const char *p = current_char,
+                       *end = buffer_end;
+            while (p < end && is_blank(*p))
+                p++;
+            current_char = p;
+            if (p < end)
+                return *p;
+        } while (this->fill_buffer());
+        return '\0';
+    }
+
+    // parse_string
+    std::string json_parser::parse_string()
+    {
+        std::string _value;         // the value of the string to parse
+        this->read_string(_value);
+        JSON_LITE_STAT(stats->string_bytes += _value.size());
+        return _value;
+    }
+
+    // read_string
+    bool json_parser::read_string(std::string &_value)
+    {
+        while (true)
+        {
+            if (current_char == buffer_end && !this->fill_buffer())  //the end of input
+                break;
+
+            // copy the characters before the next '"', '\\' or control character at once
+            const char *span = current_char;
+            current_char = find_quote_or_escape(current_char, buffer_end);
+            _value.append(span, current_char - span);
+            if (current_char == buffer_end)  //read more
+                continue;
 
-            //if the character is '}', the object is empty
-            while (temp_char != '}')
+            char temp_char = this->get_char();
+
+            //The end of the string
+            if (temp_char == '\"')
+                break;
+
+            //The escape characters
+            if (temp_char != '\\')  //control characters must be escaped
             {
-                if (temp_char != '\"')
-                    throw MISSING_QUOTATION;
-                //escape the left quotation
-                this->get_char();
+                this->fail(INVALID_CHARACTER);
+                break;
+            }
+            if (!this->parse_escape(_value))
+                break;
+        }
+        return !parse_result.failed;
+    }
 
-                //label
-                _key = new json_value(JSON_STRING, this->parse_string());
+    // skip_string
+    void json_parser::skip_string()
+    {
+        while (true)
+        {
+            if (current_char == buffer_end && !this->fill_buffer())  //the end of input
+                break;
 
-                //escape blank characters
-                temp_char = this->escape_blank();
+            // pass over the characters before the next '"', '\\' or control character at once
+            current_char = find_quote_or_escape(current_char, buffer_end);
+            if (current_char == buffer_end)  //read more
+                continue;
 
-                //the current char must be ':'
-                if (temp_char != ':')
-                {
-                    safe_free(_key);
-                    throw MISSING_COLON;
-                }
+            char temp_char = this->get_char();
 
-                //escape ':'
-                this->get_char();
+            //The end of the string
+            if (temp_char == '\"')
+                break;
 
-                //escape blank characters
-                temp_char = this->escape_blank();
+            //pass over the escaped character
+            if (temp_char == '\\')
+                this->get_char();
+        }
+    }
 
-                //value in the pair
-                switch (temp_char)
+    // parse_escape
+    bool json_parser::parse_escape(std::string &str)
+    {
+        char temp_char = this->get_char();
+        switch (temp_char)
+        {
+        case '\"':
+        case '\\':
+        case '/':
+            str += temp_char;
+            break;
+        case 'b':
+            str += '\b';
+            break;
+        case 'f':
+            str += '\f';
+            break;
+        case 'n':
+            str += '\n';
+            break;
+        case 'r':
+            str += '\r';
+            break;
+        case 't':
+            str += '\t';
+            break;
+        case 'u':
+            {
+                unsigned int code;
+                if (!this->parse_hex4(code))
+                    return false;
+                if (code >= 0xD800 && code <= 0xDBFF)  //the high surrogate of a pair
                 {
-                //only strings begin with a quotation
-                case '\"':
-                    // escape the quotation
+                    if (this->get_current_char() != '\\')
+                    {
+                        append_utf8(str, REPLACEMENT_CHARACTER);
+                        break;
+                    }
+                    this->get_char();
+                    if (this->get_current_char() != 'u')  //another escape character
+                    {
+                        append_utf8(str, REPLACEMENT_CHARACTER);
+                        return this->parse_escape(str);
+                    }
                     this->get_char();
-                    _value = new json_value(JSON_STRING, this->parse_string());
-                    break;
-
-                //numbers
-                case '+':
-                case '-':
-                case '0':
-                case '1':
-                case '2':
-                case '3':
-                case '4':
-                case '5':
-                case '6':
-                case '7':
-                case '8':
-                case '9':
-                    _value = new json_value(JSON_NUMBER, this->parse_number());
-                    break;
 
-                // true
-                case 't':
-                    _value = new json_value(JSON_TRUE, this->parse_true());
-                    break;
-                
-                // false
-                case 'f':
-                    _value = new json_value(JSON_FALSE, this->parse_false());
-                    break;
-                
-                // null
-                case 'n':
-                    _value = new json_value(JSON_NULL, this->parse_null());
-                    break;
+                    unsigned int low;
+                    if (!this->parse_hex4(low))
+                        return false;
+                    if (low >= 0xDC00 && low <= 0xDFFF)
+                        code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                    else
+                    {
+                        append_utf8(str, REPLACEMENT_CHARACTER);
+                        code = low;
+                    }
+                }
+                // a lone surrogate can not be encoded in UTF-8
+                if (code >= 0xD800 && code <= 0xDFFF)
+                    code = REPLACEMENT_CHARACTER;
+                append_utf8(str, code);
+            }
+            break;
+        default:
+            return this->fail(INVALID_ESCAPE_CHARACTER);
+        }
+        return true;
+    }
 
-                // objects
-                case '{':
-                    // escape the {
-                    this->get_char();
-                    _value = this->parse_object();
-                    break;
+    // parse_hex4
+    bool json_parser::parse_hex4(unsigned int &code)
+    {
+        code = 0;
+        for (int i = 0; i < 4; i++)
+        {
+            char temp_char = this->get_char();
+            code <<= 4;
+            if (temp_char >= '0' && temp_char <= '9')
+                code |= temp_char - '0';
+            else if (temp_char >= 'a' && temp_char <= 'f')
+                code |= temp_char - 'a' + 10;
+            else if (temp_char >= 'A' && temp_char <= 'F')
+                code |= temp_char - 'A' + 10;
+            else
+                return this->fail(INVALID_ESCAPE_CHARACTER);
+        }
+        return true;
+    }
 
-                // arrays
-                case '[':
-                    // escape the [
-                    this->get_char();
-                    _value = this->parse_array();
-                    break;
-               
-                // unexpected end
-                case '\0':
-                    safe_free(_key);
-                    throw UNCLOSED_OBJECT;
-                    break;
+    // parse_number
+    std::string json_parser::parse_number()
+    {
+        std::string _number;        // the value of the number to parse
+        number_syntax syntax;       // the syntax of the number so far
+        bool ended = false;         // if a character ends the number
 
-                /**
-                 * error
-                 * @todo        unicode handle capability
-                 */
-                default:
-                    safe_free(_key);
-                    throw INVALID_CHARACTER;
+        do
+        {
+            // scan the buffer, the characters are copied at once
+            const char *p = current_char,
+                       *end = buffer_end;
+            for (; p < end; p++)
+            {
+                //a number can only exit in some pair of a object or a element,
+                //so ',', ']', '}' and blank characters will end a number
+                if (number_syntax::is_end(*p))
+                {
+                    ended = true;
                     break;
                 }
 
-                // construct the json tree
-                _key->add_child(_value);
-                obj->add_child(_key);
-
-                //escape blank characters and the pair separator ','
-                temp_char = this->escape_blank();
-                if (temp_char == ',')
+                json_parse_error error_type;
+                if (!syntax.next(*p, error_type))  //an error at the character
                 {
-                    this->get_char();
-                    temp_char = this->escape_blank();
-                    if (temp_char == '}')  //extra comma (like this: "XXX, }")
-                        throw EXTRA_COMMA;
+                    current_char = p;
+                    this->fail(error_type);
+                    return _number;
                 }
-                else if (temp_char != '}')  //@todo Detail the error
-                    throw INVALID_CHARACTER;
             }
-            
-            // read a character for next parse process
-            this->get_char();
-            return obj;
+            _number.append(current_char, p - current_char);
+            current_char = p;
+        } while (!ended && this->fill_buffer());
+
+        // a number ended by the end of input or '\0' is left to the caller
+        if (ended && *current_char != '\0' && !syntax.has_digits())  //number has no digits
+            this->fail(MISSING_DIGIT);
+        JSON_LITE_STAT(stats->number_bytes += _number.size());
+        return _number;
+    }
+
+    // parse_true
+    std::string json_parser::parse_true()
+    {
+        literal_syntax literal('t');
+        if (!this->match_literal(literal))
+        {
+            this->fail(literal.get_error());
+            return std::string();
         }
-        catch (json_parse_error error_type)
+        return "true";
+    }
+    
+    // parse_false
+    std::string json_parser::parse_false()
+    {
+        literal_syntax literal('f');
+        if (!this->match_literal(literal))
         {
-            safe_free(obj);
-            throw error_type;
+            this->fail(literal.get_error());
+            return std::string();
         }
+        return "false";
+    }
+
+    // parse_null
+    std::string json_parser::parse_null()
+    {
+        literal_syntax literal('n');
+        if (!this->match_literal(literal))
+        {
+            this->fail(literal.get_error());
+            return std::string();
+        }
+        return "null";
+    }
+
+    // match_literal
+    bool json_parser::match_literal(literal_syntax &literal)
+    {
+        // in the buffer, compared at once
+        size_t length = literal.get_length();
+        if ((size_t)(buffer_end - current_char) >= length)
+        {
+            bool same = memcmp(current_char, literal.get_text(), length) == 0;
+            current_char += length;
+            return same;
+        }
+
+        while (!literal.next(this->get_char()))
+            ;
+        return literal.matched();
+    }
+
+    // parse_object
+    json_value* json_parser::parse_object()
+    {
+        return this->parse_container(JSON_OBJECT);
     }
     
     // parse_array
     json_value* json_parser::parse_array()
     {
-        json_value *arr = new json_value(JSON_ARRAY),
-                   *elem;
-        
-        try
+        return this->parse_container(JSON_ARRAY);
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    // json_parser::number_syntax
+    ///////////////////////////////////////////////////////////////////////////
+
+    // number_syntax
+    json_parser::number_syntax::number_syntax()
+        :dot_parsed(false),
+         in_exponent(false),
+         leading_zero(false),
+         has_digit(false),
+         has_sign(false)
+    {
+    }
+
+    // has_digits
+    bool json_parser::number_syntax::has_digits() const
+    {
+        return has_digit;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    // json_parser::literal_syntax
+    ///////////////////////////////////////////////////////////////////////////
+
+    // literal_syntax
+    json_parser::literal_syntax::literal_syntax(char first)
+        :text(first == 't' ? "true" : first == 'f' ? "false" : "null"),
+         length(first == 'f' ? 5 : 4),
+         taken(0),
+         same(true)
+    {
+    }
+
+    // next
+    bool json_parser::literal_syntax::next(char c)
+    {
+        same = same && c == text[taken];
+        return ++taken == length;
+    }
+
+    // matched
+    bool json_parser::literal_syntax::matched() const
+    {
+        return same && taken == length;
+    }
+
+    // get_text
+    const char* json_parser::literal_syntax::get_text() const
+    {
+        return text;
+    }
+
+    // get_length
+    size_t json_parser::literal_syntax::get_length() const
+    {
+        return length;
+    }
+
+    // get_error
+    json_parse_error json_parser::literal_syntax::get_error() const
+    {
+        return text[0] == 't' ? ERROR_IN_TRUE : text[0] == 'f' ? ERROR_IN_FALSE : ERROR_IN_NULL;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    // json_parser::tree_builder
+    ///////////////////////////////////////////////////////////////////////////
+
+    // tree_builder
+    json_parser::tree_builder::tree_builder(json_parser &_parser)
+        :parser(_parser),
+         root(NULL),
+         key(NULL)
+    {
+    }
+
+    // on_start_object
+    bool json_parser::tree_builder::on_start_object()
+    {
+        return this->open(new_value(parser.arena, JSON_OBJECT));
+    }
+
+    // on_end_object
+    bool json_parser::tree_builder::on_end_object()
+    {
+        stack.pop_back();
+        return true;
+    }
+
+    // on_start_array
+    bool json_parser::tree_builder::on_start_array()
+    {
+        return this->open(new_value(parser.arena, JSON_ARRAY));
+    }
+
+    // on_end_array
+    bool json_parser::tree_builder::on_end_array()
+    {
+        stack.pop_back();
+        return true;
+    }
+
+    // on_key
+    bool json_parser::tree_builder::on_key(const std::string &_key)
+    {
+        key = parser.new_label(_key);
+        return true;
+    }
+
+    // on_string
+    bool json_parser::tree_builder::on_string(const std::string &str)
+    {
+        return this->add(new_value(parser.arena, JSON_STRING, str));
+    }
+
+    // on_number
+    bool json_parser::tree_builder::on_number(const std::string &text)
+    {
+        return this->add(parser.new_number(text));
+    }
+
+    // on_bool
+    bool json_parser::tree_builder::on_bool(bool b)
+    {
+        return this->add(new_value(parser.arena, b ? JSON_TRUE : JSON_FALSE));
+    }
+
+    // on_null
+    bool json_parser::tree_builder::on_null()
+    {
+        return this->add(new_value(parser.arena, JSON_NULL));
+    }
+
+    // get_root
+    json_value* json_parser::tree_builder::get_root() const
+    {
+        return root;
+    }
+
+    // discard
+    void json_parser::tree_builder::discard()
+    {
+        free_value(key);
+        free_value(root);
+        stack.clear();
+    }
+
+    // add
+    bool json_parser::tree_builder::add(json_value *_value)
+    {
+        if (!root)
+            root = _value;
+        else if (key)
         {
-            char temp_char = this->escape_blank();
-            //if the character is ']', the array is empty
-            while (temp_char != ']')
-            {
-                switch (temp_char)
-                {
-                // only strings begin with a quotation
-                case '\"':
-                    //escape the quotation
-                    this->get_char();
-                    elem = new json_value(JSON_STRING, this->parse_string());
-                    break;
+            key->add_child(_value);
+            stack.back()->add_child(key);
+            key = NULL;
+        }
+        else
+            stack.back()->add_child(_value);
+        return true;
+    }
 
-                // numbers
-                case '+':
-                case '-':
-                case '0':
-                case '1':
-                case '2':
-                case '3':
-                case '4':
-                case '5':
-                case '6':
-                case '7':
-                case '8':
-                case '9':
-                    elem = new json_value(JSON_NUMBER, this->parse_number());
-                    break;
+    // open
+    bool json_parser::tree_builder::open(json_value *_value)
+    {
+        this->add(_value);
+        stack.push_back(_value);
+        return true;
+    }
 
-                // true
-                case 't':
-                    elem = new json_value(JSON_TRUE, this->parse_true());
-                    break;
-                
-                // false
-                case 'f':
-                    elem = new json_value(JSON_FALSE, this->parse_false());
-                    break;
-                
-                // null
-                case 'n':
-                    elem = new json_value(JSON_NULL, this->parse_null());
-                    break;
+    // parse_container
+    json_value* json_parser::parse_container(json_type _type)
+    {
+        tree_builder builder(*this);
+        if (!this->parse_events(_type, builder))  //the builder never stops the parse
+        {
+            builder.discard();
+            return (json_value*)NULL;
+        }
+        return builder.get_root();
+    }
 
-                // objects
-                case '{':
-                    //escape the {
-                    this->get_char();
-                    elem = this->parse_object();
-                    break;
+    // parse_events
+    bool json_parser::parse_events(json_type _type, json_handler &handler)
+    {
+        // the open objects and arrays, true for objects, on the heap instead of the call stack
+        std::vector<bool> stack;
+        bool expect_value = true,   // a value (or a pair in an object) is expected
+             first = true;          // nothing is in the current object or array yet
+
+        stack.push_back(_type == JSON_OBJECT);
+        JSON_LITE_STAT(stats->values[_type]++;
+            if (stats->max_depth < stack.size()) stats->max_depth = stack.size());
+        if (max_depth && stack.size() > max_depth)
+            return this->fail(TOO_DEEP_NESTING);
+        if (!(_type == JSON_OBJECT ? handler.on_start_object() : handler.on_start_array()))
+            return false;
 
-                // arrays
-                case '[':
-                    //escape the [
-                    this->get_char();
-                    elem = this->parse_array();
-                    break;
-                
-                // spaces, line-end or ,
-                case ' ':
-                case '\n':
-                case '\r':
-                case '\t':
-                    //escape this character
-                    this->get_char();
-                    continue;
-                
-                // empty value
-                case ',':
-                    throw EMPTY_VALUE;
-                    break;
+        while (!stack.empty())
+        {
+            bool in_object = stack.back();
+            json_parse_error unclosed = in_object ? UNCLOSED_OBJECT : UNCLOSED_ARRAY;
+            char close = in_object ? '}' : ']';
 
-                // unexpected end
-                case '\0':
-                    throw UNCLOSED_ARRAY;
-                    break;
+            //escape blank characters
+            char temp_char = this->escape_blank();
 
-                // error
-                default:
-                    throw INVALID_CHARACTER;
-                    break;
-                }
+            // the element separator ','
+            if (!expect_value && temp_char == ',')
+            {
+                this->get_char();
+                expect_value = true;
+                first = false;
+                continue;
+            }
+
+            // the end of the object or array
+            if (!expect_value || temp_char == close)
+            {
+                if (temp_char == '\0' && this->at_end())
+                    return this->fail(unclosed);
+                if (temp_char != close)  //@todo Detail the error
+                    return this->fail(INVALID_CHARACTER);
+                if (expect_value && !first)  //extra comma (like this: "XXX, }")
+                    return this->fail(EXTRA_COMMA);
+
+                this->get_char();
+                stack.pop_back();
+                expect_value = false;
+                if (!(in_object ? handler.on_end_object() : handler.on_end_array()))
+                    return false;
+                continue;
+            }
+
+            if (in_object)
+            {
+                if (temp_char != '\"')
+                    return this->fail(MISSING_QUOTATION);
+                //escape the left quotation
+                this->get_char();
 
-                // construct the json tree
-                arr->add_child(elem);
+                //label
+                std::string label = this->parse_string();
+                if (parse_result.failed || !handler.on_key(label))
+                    return false;
+                JSON_LITE_STAT(stats->labels++);
+
+                //the current char must be ':'
+                if (this->escape_blank() != ':')
+                    return this->fail(MISSING_COLON);
 
-                //escape blank characters and the element separator ','
+                //escape ':' and blank characters
+                this->get_char();
                 temp_char = this->escape_blank();
-                if (temp_char == ',')
+            }
+
+            bool go_on;
+            expect_value = false;
+            switch (temp_char)
+            {
+            //only strings begin with a quotation
+            case '\"':
+                // escape the quotation
+                this->get_char();
                 {
-                    this->get_char();  //escape ','
-                    temp_char = this->escape_blank();
-                    if (temp_char == ']')  //extra comma (like this: "XXX, ]")
-                        throw EXTRA_COMMA;
+                    std::string str = this->parse_string();
+                    go_on = !parse_result.failed && handler.on_string(str);
                 }
-                else if (temp_char != ']')  //@todo Detail the error
+                JSON_LITE_STAT(stats->values[JSON_STRING]++);
+                break;
+
+            //numbers
+            case '+':
+            case '-':
+            case '0':
+            case '1':
+            case '2':
+            case '3':
+            case '4':
+            case '5':
+            case '6':
+            case '7':
+            case '8':
+            case '9':
                 {
-                    if (temp_char == '\0')
-                        throw UNCLOSED_ARRAY;
-                    throw INVALID_CHARACTER;
+                    std::string text = this->parse_number();
+                    go_on = !parse_result.failed && handler.on_number(text);
                 }
-            }
+                JSON_LITE_STAT(stats->values[JSON_NUMBER]++);
+                break;
+
+            // true
+            case 't':
+                this->parse_true();
+                go_on = !parse_result.failed && handler.on_bool(true);
+                JSON_LITE_STAT(stats->values[JSON_TRUE]++);
+                break;
             
-            // escape the ']'
-            this->get_char();
-            return arr;
-        }
-        catch (json_parse_error error_type)
-        {
-            safe_free(arr);
-            throw error_type;
+            // false
+            case 'f':
+                this->parse_false();
+                go_on = !parse_result.failed && handler.on_bool(false);
+                JSON_LITE_STAT(stats->values[JSON_FALSE]++);
+                break;
+            
+            // null
+            case 'n':
+                this->parse_null();
+                go_on = !parse_result.failed && handler.on_null();
+                JSON_LITE_STAT(stats->values[JSON_NULL]++);
+                break;
+
+            // go into the object or array
+            case '{':
+            case '[':
+                // escape the { or [
+                this->get_char();
+                stack.push_back(temp_char == '{');
+                JSON_LITE_STAT(stats->values[temp_char == '{' ? JSON_OBJECT : JSON_ARRAY]++;
+                    if (stats->max_depth < stack.size()) stats->max_depth = stack.size());
+                if (max_depth && stack.size() > max_depth)
+                    return this->fail(TOO_DEEP_NESTING);
+                expect_value = true;
+                first = true;
+                go_on = temp_char == '{' ? handler.on_start_object() : handler.on_start_array();
+                break;
+
+            // empty value
+            case ',':
+                return this->fail(in_object ? INVALID_CHARACTER : EMPTY_VALUE);
+
+            // unexpected end, or a '\0' in the text
+            case '\0':
+                return this->fail(this->at_end() ? unclosed : INVALID_CHARACTER);
+
+            /**
+             * error
+             * @todo        unicode handle capability
+             */
+            default:
+                return this->fail(INVALID_CHARACTER);
+            }
+
+            if (!go_on)
+                return false;
         }
+
+        return true;
     }
 
     // locate_element_by_label
     std::streampos json_parser::locate_element_by_label(const char* label)
     {
-        while (!json_file.eof())
+        std::string str;    // the string read, reused
+        while (!this->at_end())
         {
             char temp = get_char();
             if (temp == '\\')  //escape characters
@@ -1205,7 +2228,9 @@ namespace json_lite
             
             if (temp == '"') //a string
             {
-                if (this->parse_string() == label)
+                str.clear();
+                this->read_string(str);
+                if (str == label)
                 {
                     if (this->escape_blank() != ':')  //the string is not a label
                         continue;
@@ -1217,58 +2242,218 @@ namespace json_lite
             }  
         }
 
-        return json_file.tellg();
+        return buffer_offset + (current_char - buffer_begin);
     }
 
     // get_char
     const char json_parser::get_char()
     {
-        char temp_char = 0;
-        temp_char = *current_char++;
-        if (!temp_char)  //the end of the buffer
+        if (current_char == buffer_end && !this->fill_buffer())  //the end of input
+            return '\0';
+
+        return *current_char++;
+    }
+
+    // get_current_char
+    const char json_parser::get_current_char()
+    {
+        if (current_char == buffer_end && !this->fill_buffer())  //the end of input
+            return '\0';
+
+        return *current_char;
+    }
+
+    // at_end
+    bool json_parser::at_end()
+    {
+        return current_char == buffer_end && !this->fill_buffer();
+    }
+
+    // fill_buffer
+    bool json_parser::fill_buffer()
+    {
+        if (from_memory)
+            return false;
+        JSON_LITE_STAT_TIME(read_time);
+
+        // the json of a stream being parsed is kept at the front of the buffer,
+        // the next block is read after it
+        if (record_begin)
+            return this->fill_after_record();
+
+        // the position moves past the block before it is given back, its lines
+        // can't be counted later
+        advance_position(buffer_begin, buffer_end, line, pos_in_line);
+        buffer_offset += buffer_end - buffer_begin;
+        buffer_begin = current_char = buffer_end;
+
+        if (reader)  //parse the block in place
         {
-            if (!json_file.eof())
-            {
-                memset(buffer, 0, BUF_SIZE);
-                json_file.read(buffer, BUF_SIZE - 1);
-                current_char = buffer;
-                temp_char = *current_char++;
-            }
+            const char *block;
+            size_t length = reader->next_block(block);
+            if (length == 0)
+                return false;
+            buffer_begin = current_char = block;
+            buffer_end = block + length;
+            JSON_LITE_STAT(stats->refills++);
+            return true;
         }
-        
-        pos_in_line++;
-        if (temp_char == '\n')
+
+        if (!json_file.is_open() || json_file.eof())
+            return false;
+
+        json_file.read(&buffer[0], BUF_SIZE);
+        buffer_begin = current_char = &buffer[0];
+        buffer_end = buffer_begin + json_file.gcount();
+        JSON_LITE_STAT(stats->refills += buffer_end != buffer_begin);
+        return buffer_end != buffer_begin;
+    }
+
+    // fill_after_record
+    bool json_parser::fill_after_record()
+    {
+        // the position moves up to the json kept
+        advance_position(buffer_begin, record_begin, line, pos_in_line);
+        buffer_offset += record_begin - buffer_begin;
+
+        size_t kept = buffer_end - record_begin;
+        if (!buffer.empty() && record_begin >= &buffer[0] && record_begin < &buffer[0] + buffer.size())
         {
-            line++;
-            pos_in_line = 1;
+            memmove(&buffer[0], record_begin, kept);  //it is in the buffer already
+            if (buffer.size() < kept + BUF_SIZE)
+                buffer.resize(kept + BUF_SIZE);
         }
+        else  //it is in a block of the reader, given back by next_block
+        {
+            if (buffer.size() < kept + BUF_SIZE)
+                buffer.resize(kept + BUF_SIZE);
+            memcpy(&buffer[0], record_begin, kept);
+        }
+        buffer_begin = record_begin = &buffer[0];
+        current_char = buffer_end = buffer_begin + kept;
 
-        return temp_char;
+        size_t length = 0;
+        if (reader)
+        {
+            const char *block;
+            length = reader->next_block(block);
+            if (buffer.size() < kept + length)
+                buffer.resize(kept + length);
+            if (length)
+                memcpy(&buffer[kept], block, length);
+        }
+        else if (json_file.is_open() && !json_file.eof())
+        {
+            json_file.read(&buffer[kept], BUF_SIZE);
+            length = (size_t)json_file.gcount();
+        }
+
+        // the buffer may have moved when it is resized
+        buffer_begin = record_begin = &buffer[0];
+        current_char = buffer_begin + kept;
+        buffer_end = current_char + length;
+        JSON_LITE_STAT(stats->refills += length != 0);
+        return length != 0;
     }
 
-    // get_current_char
-    const char json_parser::get_current_char()
+    // get_position
+    void json_parser::get_position(int &_line, int &_column) const
+    {
+        _line = line;
+        _column = pos_in_line;
+        advance_position(buffer_begin, current_char, _line, _column);
+    }
+
+    // fail
+    bool json_parser::fail(json_parse_error error_type)
     {
-        char temp_char = 0;
-        temp_char = *current_char;
-        if (!temp_char)  //the end of the buffer
+        if (!parse_result.failed)  //the first error is kept
         {
-            if (!json_file.eof())
-            {
-                memset(buffer, 0, BUF_SIZE);
-                json_file.read(buffer, BUF_SIZE - 1);
-                current_char = buffer;
-                temp_char = *current_char;
-            }
+            parse_result.failed = true;
+            parse_result.error = error_type;
+            parse_result.offset = (size_t)(buffer_offset + (current_char - buffer_begin));
+            this->get_position(parse_result.line, parse_result.column);
         }
-        return temp_char;
+        return false;
     }
 
     // print_error
     void json_parser::print_error(json_parse_error error_type) const
     {
-        std::cout << "Error in json at line " << line 
-            << ", position " << pos_in_line << " :" << std::endl;
+        int _line, _column;
+        this->get_position(_line, _column);
+        std::cout << "Error in json at line " << _line
+            << ", position " << _column << " :" << std::endl;
         std::cout << error_value(error_type) << std::endl;
     }
-}
\ No newline at end of file
+
+    void json_parser::print_error(const json_parse_result &result) const
+    {
+        std::cout << "Error in json at line " << result.line
+            << ", position " << result.column << " :" << std::endl;
+        std::cout << error_value(result.error) << std::endl;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    // json_document
+    ///////////////////////////////////////////////////////////////////////////
+
+    // json_document
+    json_document::json_document(size_t block_size)
+        :arena(block_size),
+         keys(arena),
+         root(NULL)
+    {
+    }
+
+    // parse
+    json_value* json_document::parse(json_parser &parser, bool indexed)
+    {
+        this->clear();
+        parser.set_arena(&arena);
+        parser.set_key_table(&keys);
+        root = indexed ? parser.run_indexed() : parser.run();
+        parser.set_arena(NULL);
+        parser.set_key_table(NULL);
+        return root;
+    }
+
+    // parse_next
+    json_value* json_document::parse_next(json_parser &parser)
+    {
+        this->clear();
+        parser.set_arena(&arena);
+        parser.set_key_table(&keys);
+        root = parser.next_document();
+        parser.set_arena(NULL);
+        parser.set_key_table(NULL);
+        return root;
+    }
+
+    // get_root
+    json_value* json_document::get_root() const
+    {
+        return root;
+    }
+
+    // get_arena
+    json_arena& json_document::get_arena()
+    {
+        return arena;
+    }
+
+    // get_key_table
+    const json_key_table& json_document::get_key_table() const
+    {
+        return keys;
+    }
+
+    // clear
+    void json_document::clear()
+    {
+        // the elements in the arena need no destructor
+        root = NULL;
+        keys.clear();
+        arena.reset();
+    }
+}
@@ -30,8 +30,14 @@
 #include <string>
 #include <cassert>
 #include <fstream>
+#include <vector>
 
-const int BUF_SIZE = 1024;  ///< the size of buffer
+#include "json_arena.h"
+#include "json_handler.h"
+#include "json_intern.h"
+#include "json_number.h"
+
+const int BUF_SIZE = 64 * 1024;     ///< the size of the buffer reading a json file
 
 ///
 /// \namespace  json_lite
@@ -86,6 +92,7 @@ namespace json_lite
         
         UNCLOSED_OBJECT,
         UNCLOSED_ARRAY,
+        TOO_DEEP_NESTING,
 
         EXTRA_CONTENT_AFTER_JSON
     };
@@ -98,6 +105,71 @@ namespace json_lite
     ///
     std::string error_value(json_parse_error error_type);
 
+    ///
+    /// \struct json_parse_result
+    /// \brief  If a parse fails, with which error and where
+    /// \note   The position is of the character where the error is found
+    ///
+    struct json_parse_result
+    {
+        ///
+        /// \fn         json_parse_result
+        /// \brief      The result of a parse without error
+        ///
+        json_parse_result();
+
+        bool failed;                ///< if the parse has failed
+        json_parse_error error;     ///< the error, if failed
+        size_t offset;              ///< the byte offset of the error in the input, from 0
+        int line;                   ///< the line of the error, from 1
+        int column;                 ///< the position of the error in its line, from 1
+    };
+
+    const unsigned int REPLACEMENT_CHARACTER = 0xFFFD;  ///< U+FFFD, for lone surrogates
+
+    ///
+    /// \fn         append_utf8
+    /// \brief      Append a unicode code point to a string in UTF-8
+    ///
+    void append_utf8(std::string &str, unsigned int code);
+
+    struct member_index;
+    struct json_format;
+    class json_reader;
+    class structural_index;
+    class json_value;
+    struct json_parse_stats;
+
+    ///
+    /// \fn         print_json_object
+    /// \brief      Print the json object
+    /// \param      obj             The json object
+    /// \param      format          Format the document
+    /// \param      indent_level    The level of indentation default value is 0
+    /// \return     true for success, false for failure
+    ///
+    bool print_json_object(const json_value *obj, bool format, int indent_level = 0);
+    
+    ///
+    /// \fn         print_json_array
+    /// \brief      Print the json array
+    /// \param      arr             The json array
+    /// \param      format          Format the document in the output file
+    /// \param      indent_level    The levels of indentation, default value is 0
+    /// \return     true for success, false for failure
+    ///
+    bool print_json_array(const json_value *arr, bool format, int indent_level = 0);
+
+    ///
+    /// \fn         print_json_value
+    /// \brief      Print the json value
+    /// \param      elem            The json element
+    /// \param      format          Format the document in the output file
+    /// \param      indent_level    The levels of indentation, default value is 0
+    /// \return     true for success, false for failure
+    ///
+    bool print_json_value(const json_value *elem, bool format, int indent_level = 0);
+
 
     ///////////////////////////////////////////////////////////////////////////
     /// json_value
@@ -127,10 +199,23 @@ namespace json_lite
         ///
         json_value(json_type _type, std::string _value);
 
+        ///
+        /// \overload    json_value(json_type _type, const char *_value, size_t _length, json_arena *_arena)
+        /// \brief       The constructor of json_value
+        /// \param       _type      The type of the element
+        /// \param       _value     The value of the element
+        /// \param       _length    The length of the value
+        /// \param       _arena     The arena holding the element, NULL for the heap
+        /// \warning     An element in an arena must be placed in memory from the
+        ///              same arena, and must NOT be deleted
+        ///
+        json_value(json_type _type, const char *_value, size_t _length, json_arena *_arena);
+
         ///
         /// \fn         ~json_value
         /// \brief      The destructor of json_value
-        ///             It will free its children first
+        ///             It will free its children first, then the next nodes
+        /// \note       Nodes are freed one by one without recursion
         ///
         ~json_value();
 
@@ -152,9 +237,75 @@ namespace json_lite
         ///
         /// \fn         get_value
         /// \brief      Return the value of the element
+        /// \note       A number parsed without its text returns the shortest text
+        ///             converting back to the same number
         /// \warning    Objects and arrays have NO value, the value will be a empty string
         ///
         std::string get_value() const;
+
+        ///
+        /// \fn         get_number_type
+        /// \brief      Return how the number is stored
+        /// \warning    Only works for numbers
+        ///
+        json_number_type get_number_type() const;
+
+        ///
+        /// \fn         is_integer
+        /// \brief      If the number is stored as an integer (int64_t or uint64_t)
+        /// \warning    Only works for numbers
+        ///
+        bool is_integer() const;
+
+        ///
+        /// \fn         get_int64
+        /// \brief      Return the number as int64_t
+        /// \note       A double is truncated, a uint64_t beyond int64_t wraps
+        /// \warning    Only works for numbers
+        ///
+        int64_t get_int64() const;
+
+        ///
+        /// \fn         get_uint64
+        /// \brief      Return the number as uint64_t
+        /// \note       A double is truncated, a negative int64_t wraps
+        /// \warning    Only works for numbers
+        ///
+        uint64_t get_uint64() const;
+
+        ///
+        /// \fn         get_double
+        /// \brief      Return the number as double
+        /// \warning    Only works for numbers
+        ///
+        double get_double() const;
+
+        ///
+        /// \fn         set_int64
+        /// \brief      Set the number to an int64_t, dropping its text
+        /// \warning    Only works for numbers
+        ///
+        void set_int64(int64_t _value);
+
+        ///
+        /// \fn         set_uint64
+        /// \brief      Set the number to a uint64_t, dropping its text
+        /// \warning    Only works for numbers
+        ///
+        void set_uint64(uint64_t _value);
+
+        ///
+        /// \fn         set_double
+        /// \brief      Set the number to a double, dropping its text
+        /// \warning    Only works for numbers
+        ///
+        void set_double(double _value);
+
+        ///
+        /// \fn         get_arena
+        /// \brief      Return the arena holding the element, or NULL for the heap
+        ///
+        json_arena* get_arena() const;
         
         ///
         /// \fn         set_next
@@ -227,6 +378,45 @@ namespace json_lite
         ///
         json_value* get_child_by_label(const std::string &label) const;
 
+        ///
+        /// \fn         get_member
+        /// \brief      Get the value of a label of the object itself
+        /// \param      label   The label to search
+        /// \note       Only the labels directly in the object are searched.
+        ///             Large objects build a hash index of their labels at the
+        ///             first lookup, kept up to date by add_child and add_pair.
+        ///             If a label appears twice, the first one wins.
+        /// \warning    Do NOT delete the pointer returned.
+        ///             Changing a label with set_value does not update the index.
+        /// \warning    The first lookup in a large object writes its index, so it is
+        ///             NOT safe for threads reading the same tree at once, like a
+        ///             shared config or the json of json_parallel_reader handed to
+        ///             other threads. Look up a member of each such object once,
+        ///             on one thread, before sharing the tree.
+        /// \return     The value of the label, or NULL if the label doesn't exist
+        ///             or the element is not an object
+        ///
+        json_value* get_member(const std::string &label) const;
+
+        ///
+        /// \overload   get_member(const char *label, size_t length, size_t hash)
+        /// \brief      Get the value of a label whose hash is computed once,
+        ///             for labels looked up again and again, see json_pointer
+        /// \param      hash    The hash of the label by hash_label, 0 to compute it if needed
+        ///
+        json_value* get_member(const char *label, size_t length, size_t hash) const;
+
+        ///
+        /// \fn         get_pointer
+        /// \brief      Get the element a JSON Pointer (RFC 6901) addresses from this element
+        /// \param      pointer     Like "/items/2/id", "" for the element itself
+        /// \note       The pointer is compiled at every call, see json_pointer to
+        ///             compile it once
+        /// \warning    Do NOT delete the pointer returned
+        /// \return     The element, or NULL if it doesn't exist or the pointer is invalid
+        ///
+        json_value* get_pointer(const std::string &pointer) const;
+
         ///
         /// \fn         add_child
         /// \brief      Add a new child to the current element
@@ -275,34 +465,20 @@ namespace json_lite
         bool output(bool format = true, int indent_level = 0) const;
 
         ///
-        /// \fn         print_json_object
-        /// \brief      Print the json object
-        /// \param      obj             The json object
-        /// \param      format          Format the document
-        /// \param      indent_level    The level of indentation default value is 0
-        /// \return     true for success, false for failure
-        ///
-        friend bool print_json_object(const json_value *obj, bool format, int indent_level = 0);
-        
-        ///
-        /// \fn         print_json_array
-        /// \brief      Print the json array
-        /// \param      arr             The json array
-        /// \param      format          Format the document in the output file
+        /// \overload   output(std::ostream &stream, const json_format &format, int indent_level = 0) const
+        /// \brief      Print the json tree to a stream
+        /// \param      stream          The stream
+        /// \param      format          How to print, see json_format
         /// \param      indent_level    The levels of indentation, default value is 0
+        /// \note       The output is gathered in a buffer of its own and written in
+        ///             large blocks, so threads can print at the same time
         /// \return     true for success, false for failure
         ///
-        friend bool print_json_array(const json_value *arr, bool format, int indent_level = 0);
+        bool output(std::ostream &stream, const json_format &format, int indent_level = 0) const;
 
-        ///
-        /// \fn         print_json_value
-        /// \brief      Print the json value
-        /// \param      elem            The json element
-        /// \param      format          Format the document in the output file
-        /// \param      indent_level    The levels of indentation, default value is 0
-        /// \return     true for success, false for failure
-        ///
-        friend bool print_json_value(const json_value *elem, bool format, int indent_level = 0);
+        friend bool print_json_object(const json_value *obj, bool format, int indent_level);   ///< see print_json_object
+        friend bool print_json_array(const json_value *arr, bool format, int indent_level);    ///< see print_json_array
+        friend bool print_json_value(const json_value *elem, bool format, int indent_level);   ///< see print_json_value
 
         ///
         /// \brief      Overload the operator << to output json conveniently
@@ -312,17 +488,65 @@ namespace json_lite
         ///
         friend std::ostream& operator<<(std::ostream& output, const json_value &value);
 
+        friend class json_parser;
+        friend class json_serializer;
+
     private:
         json_value(){}  ///< default constructor is not allowed to use
 
+        ///
+        /// \fn         assign_value
+        /// \brief      Set the value by the type, copied to the heap or the arena
+        ///
+        void assign_value(const char *_value, size_t _length);
+
+        ///
+        /// \fn         build_member_index
+        /// \brief      Index all the labels of the object
+        ///
+        void build_member_index() const;
+
+        ///
+        /// \fn         index_member
+        /// \brief      Add a label to the index of the object
+        ///
+        void index_member(json_value *label) const;
+
+        ///
+        /// \fn         drop_member_index
+        /// \brief      Forget the index of the object
+        ///
+        void drop_member_index() const;
+
+        ///
+        /// \fn         share_value
+        /// \brief      Point a string at a label interned by json_key_table
+        /// \param      _value  The label, NOT owned by the element
+        /// \param      _length The length of the label
+        /// \param      hash    The hash of the label by hash_label
+        ///
+        void share_value(const char *_value, size_t _length, size_t hash);
+
+        ///
+        /// \fn         get_label_hash
+        /// \brief      Return the hash of the string, computed once when it is interned
+        ///
+        size_t get_label_hash() const;
+
     private:
         json_type type;             ///< the type of the element
-        std::string value;          ///< the value of the element
+        const char *value;          ///< the value of the element
+        size_t value_length;        ///< the length of the value
+        bool owns_value;            ///< if the value is allocated on the heap by the element
+        json_arena *arena;          ///< the arena holding the element, NULL for the heap
+        size_t label_hash;          ///< the hash of an interned label, 0 if not computed
+        json_number number;         ///< the native value of a number
         json_value *next;           ///< the next element
         json_value *prev;           ///< the previous element
         json_value *parent;         ///< the parent element
         json_value *first_child;    ///< the first child
         json_value *last_child;     ///< the last_child
+        mutable member_index *members;  ///< the index of the labels of an object, built lazily by get_member
     };
 
     ///////////////////////////////////////////////////////////////////////////
@@ -343,6 +567,25 @@ namespace json_lite
         /// \exception  char*       If the file cannot be opened, throw a message
         ///
         json_parser(const std::string file_name);
+
+        ///
+        /// \overload   json_parser(const char* data, size_t length)
+        /// \brief      Construct a parser over json text already in memory
+        /// \param      data        The json text
+        /// \param      length      The length of the json text
+        /// \note       The text is parsed in place without being copied
+        /// \warning    The memory must stay valid while the parser is used
+        ///
+        json_parser(const char* data, size_t length);
+
+        ///
+        /// \overload   json_parser(json_reader &_reader)
+        /// \brief      Construct a parser over the blocks of a json_reader
+        /// \param      _reader     The reader of the json file
+        /// \note       The blocks are parsed in place, while the next one is read ahead
+        /// \warning    The reader must outlive the parser
+        ///
+        json_parser(json_reader &_reader);
         
         ///
         /// \fn         ~json_parser
@@ -353,10 +596,165 @@ namespace json_lite
         ///
         /// \fn         run
         /// \brief      This function begins to parse the whole json file
+        /// \note       An error is printed, see run(json_parse_result &result)
         /// \return     The json element parsed
         ///
         json_value* run();
 
+        ///
+        /// \overload   run(json_parse_result &result)
+        /// \brief      Parse the whole json file, giving back an error instead of printing it
+        /// \param      result      The error and its position, if the parse fails
+        /// \note       No exception is thrown and nothing is printed for an error
+        /// \return     The json element parsed, NULL for an error
+        ///
+        json_value* run(json_parse_result &result);
+
+        ///
+        /// \overload   run(json_handler &handler)
+        /// \brief      Parse the whole json without building a tree
+        /// \param      handler     The receiver of the events of the json
+        /// \note       Nothing is allocated for the elements, and the handler
+        ///             can stop the parse at any event by returning false
+        /// \return     true if the json is parsed without error or the handler
+        ///             stops it, false for an error
+        ///
+        bool run(json_handler &handler);
+
+        ///
+        /// \overload   run(json_handler &handler, json_parse_result &result)
+        /// \brief      Parse the whole json without building a tree, giving back an error
+        ///             instead of printing it, see run(json_handler &handler)
+        ///
+        bool run(json_handler &handler, json_parse_result &result);
+
+        ///
+        /// \fn         next_document
+        /// \brief      Parse the next json of a stream of json, like NDJSON (JSON Lines)
+        /// \note       The json are separated by blank characters, one per line in NDJSON.
+        ///             A json with an error is printed, and the stream goes on at the
+        ///             line after the one where that json begins, so a json cut short
+        ///             doesn't take the next one with it. A json of many lines with an
+        ///             error gives an error for each of its lines left.
+        /// \note       The json being parsed is kept in memory through the refills
+        ///             of a file or a reader, to go back to it after an error.
+        /// \return     The json element parsed, or NULL at the end of input or for
+        ///             a json with an error, see is_end
+        ///
+        json_value* next_document();
+
+        ///
+        /// \overload   next_document(json_parse_result &result)
+        /// \brief      Parse the next json of a stream, giving back an error instead of printing it
+        /// \param      result      The error and its position, if the json has an error
+        ///
+        json_value* next_document(json_parse_result &result);
+
+        ///
+        /// \fn         is_end
+        /// \brief      If there are only blank characters left in the input
+        ///
+        bool is_end();
+
+        ///
+        /// \fn         run_indexed
+        /// \brief      Parse the whole json text in two stages
+        /// \note       The first stage indexes every token of the text with SIMD
+        ///             (see structural_index), the second stage builds the json
+        ///             tree by walking the index instead of every character
+        /// \note       A json with an error is parsed again by run(), so the error
+        ///             and its position are the same as run() gives
+        /// \warning    Only json text in memory is indexed, a file (or a text longer
+        ///             than structural_index::MAX_LENGTH) is parsed by run()
+        /// \return     The json element parsed
+        ///
+        json_value* run_indexed();
+
+        ///
+        /// \overload   run_indexed(json_parse_result &result)
+        /// \brief      Parse the whole json text in two stages, giving back an error
+        ///             instead of printing it
+        ///
+        json_value* run_indexed(json_parse_result &result);
+
+        ///
+        /// \fn         run_parallel
+        /// \brief      Parse a json text in memory whose root is a large array on many threads
+        /// \param      threads     The number of threads, 0 for one per core
+        /// \note       A fast scan cuts the array between elements into ranges,
+        ///             the ranges are parsed at the same time, and their elements
+        ///             are joined into the array in order.
+        ///             With an arena or a key table, each range is parsed into an
+        ///             arena and a key table of its own, then its memory is moved to
+        ///             the arena and its labels interned into the key table.
+        ///             Small texts, other roots and texts with errors are parsed by
+        ///             run() on this thread, see get_parallel_ranges.
+        /// \return     The json element parsed
+        ///
+        json_value* run_parallel(size_t threads = 0);
+
+        ///
+        /// \overload   run_parallel(json_parse_result &result, size_t threads)
+        /// \brief      Parse a large array on many threads, giving back an error
+        ///             instead of printing it
+        ///
+        json_value* run_parallel(json_parse_result &result, size_t threads = 0);
+
+        ///
+        /// \fn         get_parallel_ranges
+        /// \brief      Return the ranges parsed at the same time by the last run_parallel
+        /// \return     0 if it was parsed by run() on this thread
+        ///
+        size_t get_parallel_ranges() const;
+
+        ///
+        /// \fn         get_result
+        /// \brief      Return the result of the last parse
+        ///
+        const json_parse_result& get_result() const;
+
+        ///
+        /// \fn         set_arena
+        /// \brief      Allocate the elements parsed from an arena
+        /// \param      _arena  The arena, NULL to allocate from the heap
+        ///
+        void set_arena(json_arena *_arena);
+
+        ///
+        /// \fn         set_key_table
+        /// \brief      Intern the labels parsed into a key table
+        /// \param      _key_table  The key table, NULL to copy every label (the default)
+        /// \note       Labels with the same text share one copy in the table,
+        ///             and their hashes are kept for get_member
+        /// \warning    The table must outlive the elements parsed, see json_document
+        ///
+        void set_key_table(json_key_table *_key_table);
+
+        ///
+        /// \fn         set_max_depth
+        /// \brief      Limit how deeply objects and arrays can be nested
+        /// \param      depth   The max depth, 0 for no limit (the default)
+        /// \note       Parsing stops at once with TOO_DEEP_NESTING beyond the limit
+        ///
+        void set_max_depth(size_t depth);
+
+        ///
+        /// \fn         set_keep_number_text
+        /// \brief      Keep the text of numbers besides their native values
+        /// \param      keep    true to keep the text, false by default
+        /// \note       Numbers out of the range of double always keep their text
+        ///
+        void set_keep_number_text(bool keep);
+
+        ///
+        /// \fn         set_stats
+        /// \brief      Count what the parses do into a stats
+        /// \param      _stats  The stats, NULL to count nothing (the default)
+        /// \note       The counts are added to what the stats has, see json_stats.h.
+        ///             Without JSON_LITE_STATS nothing is counted.
+        ///
+        void set_stats(json_parse_stats *_stats);
+
         ///
         /// \fn         escape_blank
         /// \brief      Escape blank characters and return the first none-blank character
@@ -370,23 +768,29 @@ namespace json_lite
         /// \fn         parse_value
         /// \brief      Parse a complete element from buffer
         /// \param      _type   The type of element to be parsed
-        /// \return     The json element parsed.
+        /// \note       An error is recorded, see get_result
+        /// \return     The json element parsed, NULL for an error
         ///
         json_value* parse_value(json_type _type);
 
         ///
         /// \fn         parse_string
         /// \brief      Parse a string
-        /// \exception  json_parse_error    INVALID_ESCAPE_CHARACTER    A invalid character after '\'
+        /// \note       Errors are recorded, see get_result:
+        ///             INVALID_ESCAPE_CHARACTER    A invalid character after '\'
+        ///             INVALID_CHARACTER           A control character not escaped
+        /// \note       Escape characters are decoded, \\uXXXX (and surrogate pairs) to UTF-8.
+        ///             A lone surrogate is decoded to U+FFFD.
         /// \return     The string value without quotations on two sides
         ///
         std::string parse_string();
 
         ///
         /// \brief      Parse a number.
-        /// \exception  json_parse_error    TOO_MANY_DOTS_IN_NUMBER     More than one '.' exist in a number
-        ///                                 INVALID_EXPONENT            Error in the exponent of a number
-        ///                                 INVALID_BASE                Error in the base of a number
+        /// \note       Errors are recorded, see get_result:
+        ///             TOO_MANY_DOTS_IN_NUMBER     More than one '.' exist in a number
+        ///             INVALID_EXPONENT            Error in the exponent of a number
+        ///             INVALID_BASE                Error in the base of a number
         /// \return     The value of the number in string
         ///
         std::string parse_number();
@@ -394,7 +798,7 @@ namespace json_lite
         ///
         /// \fn         parse_true
         /// \brief      Parse a true.
-        /// \exception  json_parse_error    ERROR_IN_TRUE   Error in parsing "true"
+        /// \note       Errors are recorded, see get_result: ERROR_IN_TRUE   Error in parsing "true"
         /// \return     String "true"
         ///
         std::string parse_true();
@@ -402,7 +806,7 @@ namespace json_lite
         ///
         /// \fn         parse_false
         /// \brief      Parse a false
-        /// \exception  json_parse_error    ERROR_IN_FALSE  Error in parsing "false"
+        /// \note       Errors are recorded, see get_result: ERROR_IN_FALSE  Error in parsing "false"
         /// \return     String "false"
         ///
         std::string parse_false();
@@ -410,7 +814,7 @@ namespace json_lite
         ///
         /// \fn         parse_null
         /// \brief      Parse a null
-        /// \exception  json_parse_error    ERROR_IN_NULL   Error in parsing "null"
+        /// \note       Errors are recorded, see get_result: ERROR_IN_NULL   Error in parsing "null"
         /// \return     String "null"
         ///
         std::string parse_null();
@@ -418,20 +822,26 @@ namespace json_lite
         ///
         /// \fn         parse_object
         /// \brief      Parse a object
-        /// \exception  json_parse_error    MISSING_QUOTATION   The string of a pair lose it left double quotation
-        ///                                 MISSING_COLON       A pair lose ':'
-        ///                                 INVALID_CHARACTER   Some unknown character in the element of a pair
-        ///                                 Any exception in parsing string, number, true, false, null
-        /// \return     A pointer to the json object
+        /// \note       Errors are recorded, see get_result:
+        ///             MISSING_QUOTATION   The string of a pair lose it left double quotation
+        ///             MISSING_COLON       A pair lose ':'
+        ///             INVALID_CHARACTER   Some unknown character in the element of a pair
+        ///             TOO_DEEP_NESTING    Nested deeper than the max depth
+        ///             Any error in parsing string, number, true, false, null
+        /// \note       Nested objects and arrays are parsed with a stack on the heap
+        /// \return     A pointer to the json object, NULL for an error
         ///
         json_value* parse_object();
 
         ///
         /// \fn         parse_array
         /// \brief      Parse a array
-        /// \exception  json_parse_error    INVALID_CHARACTER   Some unknown character in the element
-        ///                                 Any exception in parsing string, number, true, false, null
-        /// \return     A pointer to the json object
+        /// \note       Errors are recorded, see get_result:
+        ///             INVALID_CHARACTER   Some unknown character in the element
+        ///             TOO_DEEP_NESTING    Nested deeper than the max depth
+        ///             Any error in parsing string, number, true, false, null
+        /// \note       Nested objects and arrays are parsed with a stack on the heap
+        /// \return     A pointer to the json array, NULL for an error
         ///
         json_value* parse_array();
 
@@ -448,6 +858,8 @@ namespace json_lite
         /// \fn         get_char
         /// \brief      Get the current character in the buffer and move the cursor to the next character
         /// \warning    It will move the cursor to the next character
+        /// \note       '\0' is returned at the end of input, and for a '\0' in the text,
+        ///             see at_end
         /// \return     The current character
         ///
         const char get_char();
@@ -460,18 +872,552 @@ namespace json_lite
         ///
         const char get_current_char();
 
+        ///
+        /// \fn         at_end
+        /// \brief      If the whole input is read
+        /// \note       Tells the end of input from a '\0' in the text
+        ///
+        bool at_end();
+
         ///
         /// \fn         print_error
         /// \@brief     Print the error message
         ///
         void print_error(json_parse_error error_type) const;
 
+        ///
+        /// \overload   print_error(const json_parse_result &result)
+        /// \brief      Print the error of a parse at its position
+        ///
+        void print_error(const json_parse_result &result) const;
+
+    private:
+        ///
+        /// \fn         fill_buffer
+        /// \brief      Read the next block of the json file into the buffer
+        /// \note       Text in memory is never refilled
+        /// \return     true if some characters are read, false at the end of input
+        ///
+        bool fill_buffer();
+
+        ///
+        /// \fn         fill_after_record
+        /// \brief      Move the json of the stream being parsed to the front of the
+        ///             buffer, and read the next block after it
+        /// \return     true if some characters are read, false at the end of input
+        ///
+        bool fill_after_record();
+
+        ///
+        /// \fn         get_position
+        /// \brief      Count the line and the position in line of the cursor
+        /// \note       Lines are counted from the first character of the buffer, only
+        ///             when a position is asked for. Text in memory is one buffer, so
+        ///             its parse never counts them. A file or a json_reader counts the
+        ///             lines of each block with memchr when the next one is read, as
+        ///             the block is gone when an error is reported.
+        ///
+        void get_position(int &_line, int &_column) const;
+
+        ///
+        /// \fn         parse_container
+        /// \brief      Parse an object or array whose '{' or '[' is escaped
+        /// \param      _type   JSON_OBJECT or JSON_ARRAY
+        /// \note       Without recursion, see parse_object and parse_array
+        /// \return     The object or array parsed, NULL for an error
+        ///
+        json_value* parse_container(json_type _type);
+
+        ///
+        /// \fn         parse_events
+        /// \brief      Parse an object or array whose '{' or '[' is escaped
+        ///             into the events of a handler
+        /// \param      _type   JSON_OBJECT or JSON_ARRAY
+        /// \param      handler The receiver of the events, including the first '{' or '['
+        /// \note       The grammar of parse_object and parse_array, without recursion
+        /// \return     false if the handler stops the parse or for an error
+        ///
+        bool parse_events(json_type _type, json_handler &handler);
+
+        ///
+        /// \fn         parse_elements
+        /// \brief      Parse the elements of an array separated by ',' up to the end of input
+        /// \param      array       The array to add the elements to
+        /// \note       For the ranges of run_parallel, which have at least one element
+        /// \return     false for an error
+        ///
+        bool parse_elements(json_value *array);
+
+        ///
+        /// \fn         parse_element
+        /// \brief      Parse an element beginning with a character at the cursor
+        /// \param      temp_char   The first character, not escaped
+        /// \note       An error is recorded, not printed
+        /// \return     The element parsed, NULL for an error
+        ///
+        json_value* parse_element(char temp_char);
+
+        ///
+        /// \fn         walk_index
+        /// \brief      Build the json tree of run_indexed from the tokens of the text
+        /// \param      base    The first character of the text
+        /// \param      index   The tokens of the text
+        /// \param      root    The root built, freed by the caller for an error
+        /// \param      _key    The label waiting for its value, freed by the caller for an error
+        /// \return     false for an error
+        ///
+        bool walk_index(const char *base, const structural_index &index, json_value *&root, json_value *&_key);
+
+        ///
+        /// \fn         skip_line
+        /// \brief      Pass over the rest of the current line, after an error
+        /// \note       In next_document it is the line where the json begins, see record_begin
+        ///
+        void skip_line();
+
+        ///
+        /// \fn         skip_string
+        /// \brief      Pass over a string whose left quotation is escaped
+        /// \note       Nothing is decoded or checked, for json_cursor
+        ///
+        void skip_string();
+
+        ///
+        /// \fn         read_string
+        /// \brief      Parse a string whose left quotation is escaped, appending it
+        /// \param      _value  The string to append the value to, see parse_string
+        /// \return     false for an error
+        ///
+        bool read_string(std::string &_value);
+
+        ///
+        /// \fn         new_number
+        /// \brief      Create a number element from its text
+        /// \note       The text is converted once, and kept only if required
+        ///
+        json_value* new_number(const std::string &text);
+
+        ///
+        /// \fn         new_label
+        /// \brief      Create a label element, interned if there is a key table
+        ///
+        json_value* new_label(const std::string &text);
+
+        ///
+        /// \class      number_syntax
+        /// \brief      The syntax of a number, checked a character at a time
+        ///
+        class number_syntax;
+
+        ///
+        /// \class      literal_syntax
+        /// \brief      The characters of true, false or null, checked a character at a time
+        ///
+        class literal_syntax;
+
+        ///
+        /// \fn         match_literal
+        /// \brief      Pass over as many characters as a literal and compare them with it
+        /// \param      literal     The literal expected
+        ///
+        bool match_literal(literal_syntax &literal);
+
+        ///
+        /// \fn         parse_escape
+        /// \brief      Decode an escape character whose '\' is escaped
+        /// \param      str     The string to append the character to
+        /// \return     false for INVALID_ESCAPE_CHARACTER
+        ///
+        bool parse_escape(std::string &str);
+
+        ///
+        /// \fn         parse_hex4
+        /// \brief      Parse the 4 hex digits of \\uXXXX
+        /// \param      code    The code unit parsed
+        /// \return     false for INVALID_ESCAPE_CHARACTER
+        ///
+        bool parse_hex4(unsigned int &code);
+
+        ///
+        /// \fn         fail
+        /// \brief      Record an error at the current position, unless one is recorded
+        /// \return     false, to be returned by the step failing
+        ///
+        bool fail(json_parse_error error_type);
+
+        ///
+        /// \class      tree_builder
+        /// \brief      The handler building the json tree of run()
+        ///
+        class tree_builder;
+
+        ///
+        /// \class      stats_scope
+        /// \brief      Count the bytes and the time of a parse call into the stats
+        ///
+        class stats_scope;
+
+        friend class json_cursor;
+        friend class json_push_parser;
+        friend class json_projection;
+
     private:
         std::ifstream json_file;    ///< The input stream of json file
-        char buffer[BUF_SIZE];      ///< Two buffers reading json file
-        int line;                   ///< The line number
-        int pos_in_line;            ///< The position in current line
-        char *current_char;         ///< The current char(buffer + pos_in_buf)
+        std::vector<char> buffer;   ///< The buffer reading json file, empty for other input
+        bool from_memory;           ///< If the json text is in memory rather than a file
+        json_reader *reader;        ///< The reader of the json file, NULL to read json_file
+        int line;                   ///< The line of the first character of the buffer
+        int pos_in_line;            ///< The position in line of the first character of the buffer
+        const char *buffer_begin;   ///< The first character of the buffer or the text in memory
+        const char *buffer_end;     ///< One past the last valid character
+        const char *current_char;   ///< The current char
+        std::streamoff buffer_offset;   ///< The offset of buffer_begin in the input
+        json_arena *arena;          ///< The arena of elements parsed, NULL for the heap
+        json_key_table *key_table;  ///< The table interning labels, NULL to copy them
+        size_t max_depth;           ///< The max depth of nesting, 0 for no limit
+        bool keep_number_text;      ///< If numbers keep their text
+        json_parse_result parse_result;     ///< The result of the last parse
+        json_parse_stats *stats;    ///< The stats counted into, NULL to count nothing
+        size_t stats_scopes;        ///< The parse calls running, the outer one is counted
+        const char *record_begin;   ///< The json of a stream being parsed, kept in the buffer, or NULL
+        size_t parallel_ranges;     ///< The ranges of the last run_parallel, 0 if run() parsed it
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    ///json_parser::number_syntax
+    ///////////////////////////////////////////////////////////////////////////
+
+    ///
+    /// \class  json_parser::number_syntax
+    /// \brief  The syntax of a number, checked a character at a time
+    /// \note   json_push_parser checks its numbers with it, to give the same errors
+    ///
+    class json_parser::number_syntax
+    {
+    public:
+        ///
+        /// \fn         number_syntax
+        /// \brief      Before the first character of a number
+        ///
+        number_syntax();
+
+        ///
+        /// \fn         is_end
+        /// \brief      If a character ends a number: ',', ']', '}', a blank character or '\0'
+        ///
+        static bool is_end(char c);
+
+        ///
+        /// \fn         next
+        /// \brief      Check the next character of a number, one not ending it
+        /// \param      error   The error at the character
+        /// \return     false for an error
+        ///
+        bool next(char c, json_parse_error &error);
+
+        ///
+        /// \fn         has_digits
+        /// \brief      If the last part of the number has digits, MISSING_DIGIT otherwise
+        ///
+        bool has_digits() const;
+
+    private:
+        bool dot_parsed;    ///< if the dot is parsed
+        bool in_exponent;   ///< while parsing exponent, it turns true
+        bool leading_zero;  ///< if it has leading zeros
+        bool has_digit;     ///< if the part has digit
+        bool has_sign;      ///< if the number has sign(+/-)
+    };
+
+    // is_end, inline for the character loops of the parsers
+    inline bool json_parser::number_syntax::is_end(char c)
+    {
+        return c == ',' || c == ']' || c == '}'
+            || c == ' ' || c == '\n' || c == '\r' || c == '\t' || c == '\0';
+    }
+
+    // next
+    inline bool json_parser::number_syntax::next(char c, json_parse_error &error)
+    {
+        switch (c)
+        {
+        //digits
+        case '0':
+            if (leading_zero)  //leading zero
+            {
+                error = LEADING_ZERO;
+                return false;
+            }
+            if (!has_digit)  //the first one is a zero
+                leading_zero = true;
+            has_digit = true;
+            return true;
+
+        case '1':
+        case '2':
+        case '3':
+        case '4':
+        case '5':
+        case '6':
+        case '7':
+        case '8':
+        case '9':
+            if (leading_zero)  //leading zero
+            {
+                error = LEADING_ZERO;
+                return false;
+            }
+            has_digit = true;
+            return true;
+
+        //has sign
+        case '+':
+        case '-':
+            if (has_digit)  //sign should in front of a number
+            {
+                error = INVALID_SIGN_POSITION;
+                return false;
+            }
+            if (has_sign)  //more than one sign
+            {
+                error = TOO_MANY_SIGNS_IN_NUMBER;
+                return false;
+            }
+            has_sign = true;
+            return true;
+
+        //The dot
+        case '.':
+            leading_zero = false;
+            if (dot_parsed)
+            {
+                error = TOO_MANY_DOTS_IN_NUMBER;
+                return false;
+            }
+            dot_parsed = true;
+            return true;
+
+        //exponent
+        case 'e':
+        case 'E':
+            if (!has_digit)  //the base has no digit
+            {
+                error = MISSING_DIGIT;
+                return false;
+            }
+            if (in_exponent)  //already has a exponent
+            {
+                error = TOO_MANY_EXPONENTS;
+                return false;
+            }
+            in_exponent = true;
+            dot_parsed = false;
+            has_digit = false;
+            has_sign = false;
+            leading_zero = false;
+            return true;
+
+        default:
+            error = in_exponent ? INVALID_EXPONENT : INVALID_BASE;
+            return false;
+        }
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    ///json_parser::literal_syntax
+    ///////////////////////////////////////////////////////////////////////////
+
+    ///
+    /// \class  json_parser::literal_syntax
+    /// \brief  The characters of true, false or null, checked a character at a time
+    /// \note   As many characters as the literal are taken before it is checked,
+    ///         so an error is after them. json_push_parser checks its literals
+    ///         with it, to give the same errors.
+    ///
+    class json_parser::literal_syntax
+    {
+    public:
+        ///
+        /// \fn         literal_syntax
+        /// \brief      Before the first character of a literal
+        /// \param      first   't', 'f' or 'n'
+        ///
+        literal_syntax(char first);
+
+        ///
+        /// \fn         next
+        /// \brief      Take the next character
+        /// \return     true when the literal has all its characters
+        ///
+        bool next(char c);
+
+        ///
+        /// \fn         matched
+        /// \brief      If the characters taken are the literal
+        ///
+        bool matched() const;
+
+        ///
+        /// \fn         get_text
+        /// \brief      Return "true", "false" or "null"
+        ///
+        const char* get_text() const;
+
+        ///
+        /// \fn         get_length
+        /// \brief      Return the length of the literal
+        ///
+        size_t get_length() const;
+
+        ///
+        /// \fn         get_error
+        /// \brief      Return ERROR_IN_TRUE, ERROR_IN_FALSE or ERROR_IN_NULL
+        ///
+        json_parse_error get_error() const;
+
+    private:
+        const char *text;   ///< the literal
+        size_t length;      ///< the length of the literal
+        size_t taken;       ///< the characters taken
+        bool same;          ///< if the characters taken are the literal so far
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    ///json_parser::tree_builder
+    ///////////////////////////////////////////////////////////////////////////
+
+    ///
+    /// \class  json_parser::tree_builder
+    /// \brief  The handler building the json tree of run()
+    /// \note   The elements are allocated with the arena and key table of the parser
+    ///
+    class json_parser::tree_builder : public json_handler
+    {
+    public:
+        ///
+        /// \fn         tree_builder
+        /// \brief      The constructor of tree_builder
+        /// \param      _parser     The parser, for its arena, key table and numbers
+        ///
+        tree_builder(json_parser &_parser);
+
+        bool on_start_object();
+        bool on_end_object();
+        bool on_start_array();
+        bool on_end_array();
+        bool on_key(const std::string &_key);
+        bool on_string(const std::string &str);
+        bool on_number(const std::string &text);
+        bool on_bool(bool b);
+        bool on_null();
+
+        ///
+        /// \fn         get_root
+        /// \brief      Return the tree built
+        ///
+        json_value* get_root() const;
+
+        ///
+        /// \fn         discard
+        /// \brief      Free the tree built so far, after an error
+        ///
+        void discard();
+
+    private:
+        ///
+        /// \fn         add
+        /// \brief      Add an element to the open object or array
+        ///
+        bool add(json_value *_value);
+
+        ///
+        /// \fn         open
+        /// \brief      Add an object or array and go into it
+        ///
+        bool open(json_value *_value);
+
+    private:
+        json_parser &parser;                ///< the parser, for its arena and key table
+        std::vector<json_value*> stack;     ///< the open objects and arrays
+        json_value *root;                   ///< the root of the tree
+        json_value *key;                    ///< the label waiting for its value
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    ///json_document
+    ///////////////////////////////////////////////////////////////////////////
+
+    ///
+    /// \class  json_document
+    /// \brief  A json tree allocated in an arena owned by the document
+    /// \note   The whole tree is freed at once when the document is cleared,
+    ///         reused by the next parse or destroyed.
+    ///         Repeated labels are interned, so they share one copy of their text.
+    ///
+    class json_document
+    {
+    public:
+        ///
+        /// \fn         json_document
+        /// \brief      The constructor of json_document
+        /// \param      block_size  The size of each arena block
+        ///
+        json_document(size_t block_size = ARENA_BLOCK_SIZE);
+
+        ///
+        /// \fn         parse
+        /// \brief      Parse a json into the document, replacing the previous one
+        /// \param      parser      The parser of the json
+        /// \param      indexed     Parse with json_parser::run_indexed
+        /// \warning    Do NOT delete the pointer returned
+        /// \return     The root of the document, or NULL if the parse fails
+        ///
+        json_value* parse(json_parser &parser, bool indexed = false);
+
+        ///
+        /// \fn         parse_next
+        /// \brief      Parse the next json of a stream into the document, replacing the previous one
+        /// \param      parser      The parser of the stream, see json_parser::next_document
+        /// \note       The arena is reused by every json of the stream
+        /// \warning    Do NOT delete the pointer returned
+        /// \return     The root of the document, or NULL at the end of the stream
+        ///             or for a json with an error
+        ///
+        json_value* parse_next(json_parser &parser);
+
+        ///
+        /// \fn         get_root
+        /// \brief      Return the root of the document, or NULL if it is empty
+        ///
+        json_value* get_root() const;
+
+        ///
+        /// \fn         get_arena
+        /// \brief      Return the arena of the document
+        /// \note       Elements added to the document should be allocated from it
+        ///
+        json_arena& get_arena();
+
+        ///
+        /// \fn         get_key_table
+        /// \brief      Return the labels interned by the document
+        ///
+        const json_key_table& get_key_table() const;
+
+        ///
+        /// \fn         clear
+        /// \brief      Free the tree and keep the memory for the next parse
+        ///
+        void clear();
+
+    private:
+        json_document(const json_document&);              ///< copy is not allowed
+        json_document& operator=(const json_document&);   ///< copy is not allowed
+
+    private:
+        json_arena arena;           ///< The arena of the tree
+        json_key_table keys;        ///< The labels of the tree, in the arena
+        json_value *root;           ///< The root of the tree
     };
 }
 
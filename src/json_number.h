@@ -0,0 +1,85 @@
+///////////////////////////////////////////////////////////////////////////////
+///  Copyright 2012 Garnel
+///
+///  Licensed under the Apache License, Version 2.0 (the "License");
+///  you may not use this file except in compliance with the License.
+///  You may obtain a copy of the License at
+///
+///    http://www.apache.org/licenses/LICENSE-2.0
+///
+///  Unless required by applicable law or agreed to in writing, software
+///  distributed under the License is distributed on an "AS IS" BASIS,
+///  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///////////////////////////////////////////////////////////////////////////////
+
+///
+/// \file       json_number.h
+/// The conversion between json numbers and native numbers
+/// \author     Garnel
+/// \date       2026/10/15
+/// \version    2.3
+/// \copyright  Apache License, Version 2.0
+///
+
+#ifndef JSON_LITE_NUMBER
+#define JSON_LITE_NUMBER
+
+#include <cstddef>
+#include <string>
+#include <stdint.h>
+
+namespace json_lite
+{
+    ///
+    /// \enum   json_number_type
+    /// \brief  How a json number is stored
+    ///
+    enum json_number_type
+    {
+        NUMBER_INT64,       ///< an integer fitting in int64_t
+        NUMBER_UINT64,      ///< an integer too large for int64_t but fitting in uint64_t
+        NUMBER_DOUBLE       ///< any other number
+    };
+
+    ///
+    /// \struct json_number
+    /// \brief  A json number converted to a native number
+    ///
+    struct json_number
+    {
+        json_number_type type;  ///< which member is used
+        union
+        {
+            int64_t i;          ///< NUMBER_INT64
+            uint64_t u;         ///< NUMBER_UINT64
+            double d;           ///< NUMBER_DOUBLE
+        };
+    };
+
+    ///
+    /// \fn         to_number
+    /// \brief      Convert the text of a number to a native number
+    /// \param      str     The text of the number, validated by json_parser::parse_number
+    /// \param      length  The length of the text
+    /// \param      number  The number converted
+    /// \note       Doubles are correctly rounded, whatever the locale. Most of them are
+    ///             converted exactly with double arithmetic (Clinger's fast path), then
+    ///             from a 128-bit product with a power of 5 (Eisel-Lemire). The few
+    ///             left are rounded by comparing the digits with the doubles around
+    ///             a guess, as big integers. The text is read in place, not copied.
+    /// \note       "-0" is a double, to keep its sign
+    /// \return     false if the number is out of the range of double
+    ///
+    bool to_number(const char *str, size_t length, json_number &number);
+
+    ///
+    /// \fn         number_text
+    /// \brief      Return the shortest text of a number that converts back to it
+    /// \note       The decimal point is always '.', whatever the locale
+    ///
+    std::string number_text(const json_number &number);
+}
+
+#endif // JSON_LITE_NUMBER
@@ -0,0 +1,636 @@
+///////////////////////////////////////////////////////////////////////////////
+///  Copyright 2012 Garnel
+///
+///  Licensed under the Apache License, Version 2.0 (the "License");
+///  you may not use this file except in compliance with the License.
+///  You may obtain a copy of the License at
+///
+///    http://www.apache.org/licenses/LICENSE-2.0
+///
+///  Unless required by applicable law or agreed to in writing, software
+///  distributed under the License is distributed on an "AS IS" BASIS,
+///  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///////////////////////////////////////////////////////////////////////////////
+
+///
+/// \file       json_parallel.cpp
+/// The implementation of class json_parallel_reader
+/// \author     Garnel
+/// \date       2026/10/15
+/// \version    2.3
+/// \copyright  Apache License, Version 2.0
+///
+
+#include "json_parallel.h"
+#include "json_index.h"
+#include "json_stats.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <vector>
+
+///
+/// \namespace  json_lite
+///
+namespace json_lite
+{
+    ///
+    /// \struct     parallel_chunk
+    /// \brief      A chunk of the input and the json parsed from it
+    /// \note       Chunks are reused, keeping their arenas and storage
+    ///
+    struct parallel_chunk
+    {
+        parallel_chunk()
+            :keys(arena),
+             data(NULL),
+             length(0),
+             offset(0),
+             seq(0),
+             lines(0)
+        {
+        }
+
+        json_arena arena;                   ///< the arena of the json
+        json_key_table keys;                ///< the labels of the json
+        std::string storage;                ///< the text read from a file
+        const char *data;                   ///< the text of the chunk
+        size_t length;                      ///< the length of the text
+        size_t offset;                      ///< the offset of the text in the input
+        size_t seq;                         ///< the position of the chunk in the input
+        size_t lines;                       ///< the line ends in the text
+        std::vector<json_value*> records;   ///< the json parsed
+        std::vector<json_parse_result> failures;    ///< the errors of the json with errors
+    };
+
+    ///
+    /// \struct     parallel_state
+    /// \brief      The queues shared by the reading thread and the workers
+    ///
+    struct parallel_state
+    {
+        parallel_state()
+            :closing(false)
+        {
+        }
+
+        std::mutex lock;                            ///< the lock of the queues
+        std::condition_variable work_ready;         ///< a chunk is queued or closing
+        std::condition_variable chunk_done;         ///< a chunk is parsed
+        std::deque<parallel_chunk*> work;           ///< the chunks to parse
+        std::map<size_t, parallel_chunk*> done;     ///< the chunks parsed, by position
+        bool closing;                               ///< the workers should exit
+    };
+
+    ///
+    /// \fn         parse_chunks
+    /// \brief      The loop of a worker thread
+    ///
+    void parse_chunks(parallel_state *state)
+    {
+        while (true)
+        {
+            parallel_chunk *chunk;
+            {
+                std::unique_lock<std::mutex> guard(state->lock);
+                while (state->work.empty() && !state->closing)
+                    state->work_ready.wait(guard);
+                if (state->work.empty())  //closing
+                    return;
+                chunk = state->work.front();
+                state->work.pop_front();
+            }
+
+            json_parser parser(chunk->data, chunk->length);
+            parser.set_arena(&chunk->arena);
+            parser.set_key_table(&chunk->keys);
+            json_parse_result result;
+            while (!parser.is_end())
+            {
+                json_value *record = parser.next_document(result);
+                if (record)
+                    chunk->records.push_back(record);
+                else  //nothing but blanks is left before a call, so it is an error
+                {
+                    result.offset += chunk->offset;
+                    chunk->failures.push_back(result);
+                }
+            }
+            // the line ends of the chunks before an error give its line in the input
+            chunk->lines = std::count(chunk->data, chunk->data + chunk->length, '\n');
+
+            {
+                std::lock_guard<std::mutex> guard(state->lock);
+                state->done[chunk->seq] = chunk;
+            }
+            state->chunk_done.notify_one();
+        }
+    }
+
+    const size_t PARALLEL_MIN_RANGE = 64 * 1024;    ///< the smallest range of run_parallel worth a thread
+
+    ///
+    /// \fn         split_array
+    /// \brief      Find the ',' cutting the elements of an array into ranges of about the same size
+    /// \param      p       The first character after '['
+    /// \param      end     One past the last character of the text
+    /// \param      parts   The number of ranges wanted
+    /// \param      cuts    The ',' between the ranges
+    /// \note       Only the strings and the nesting are followed, the rest is checked
+    ///             when the ranges are parsed
+    /// \return     The character closing the array, or NULL if it is not closed
+    ///
+    const char* split_array(const char *p, const char *end, size_t parts, std::vector<const char*> &cuts)
+    {
+        size_t step = (end - p) / parts,
+               depth = 1;
+        const char *next_cut = p + step;
+        for (; p < end; p++)
+        {
+            switch (*p)
+            {
+            case '\"':
+                // pass over the string, and the characters escaped in it
+                for (p++; ; p++)
+                {
+                    p = find_quote_or_escape(p, end);
+                    if (p >= end)
+                        return NULL;
+                    if (*p == '\"')
+                        break;
+                    if (*p == '\\')
+                        p++;
+                }
+                break;
+            case '{':
+            case '[':
+                depth++;
+                break;
+            case '}':
+            case ']':
+                if (--depth == 0)
+                    return p;
+                break;
+            case ',':
+                if (depth == 1 && p >= next_cut)
+                {
+                    cuts.push_back(p);
+                    next_cut = p + step;
+                }
+                break;
+            default:
+                break;
+            }
+        }
+        return NULL;
+    }
+
+    ///
+    /// \struct     array_range
+    /// \brief      Some elements of the array of run_parallel
+    ///
+    struct array_range
+    {
+        array_range()
+            :keys(arena),
+             begin(NULL),
+             end(NULL),
+             elements(NULL),
+             ok(false)
+        {
+        }
+
+        json_arena arena;       ///< the arena of the elements, if the parser has one
+        json_key_table keys;    ///< the labels of the elements, if the parser has a key table
+        const char *begin;      ///< the first character after '[' or ','
+        const char *end;        ///< the ',' or ']' after the elements
+        json_value *elements;   ///< an array holding the elements parsed
+        bool ok;                ///< if the elements are parsed without error
+        json_parse_stats stats; ///< the counts of the elements, if the parser has stats
+        std::vector<json_value*> labels;    ///< the labels to intern into the key table of the parser
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    // json_parser::run_parallel
+    ///////////////////////////////////////////////////////////////////////////
+
+    // run_parallel
+    json_value* json_parser::run_parallel(size_t threads)
+    {
+        json_parse_result result;
+        json_value *root = this->run_parallel(result, threads);
+        if (result.failed)
+            this->print_error(result);
+        return root;
+    }
+
+    json_value* json_parser::run_parallel(json_parse_result &result, size_t threads)
+    {
+        size_t workers = threads ? threads : std::thread::hardware_concurrency();
+        if (workers == 0)
+            workers = 1;
+        JSON_LITE_STAT_PARSE();
+        parallel_ranges = 0;
+
+        //escape blank characters
+        char temp_char = this->escape_blank();
+        const char *begin = current_char;
+        size_t parts = std::min(workers * 4, (size_t)(buffer_end - begin) / PARALLEL_MIN_RANGE);
+
+        if (!from_memory || temp_char != '[' || workers < 2 || parts < 2 || max_depth == 1)
+            return this->run(result);
+
+        std::vector<const char*> cuts;
+        const char *close;
+        {
+            JSON_LITE_STAT_TIME(index_time);
+            close = split_array(begin + 1, buffer_end, parts, cuts);
+        }
+        if (!close || *close != ']' || cuts.empty())
+            return this->run(result);
+        //after the json should be only blank characters
+        for (const char *p = close + 1; p < buffer_end; p++)
+            if (*p != ' ' && *p != '\n' && *p != '\r' && *p != '\t')
+                return this->run(result);
+
+        std::vector<array_range> ranges(cuts.size() + 1);
+        for (size_t i = 0; i < ranges.size(); i++)
+        {
+            ranges[i].begin = i == 0 ? begin + 1 : cuts[i - 1] + 1;
+            ranges[i].end = i == cuts.size() ? close : cuts[i];
+        }
+
+        // parse the ranges, the elements go straight under the root
+        json_value *root = arena
+            ? new (arena->allocate(sizeof(json_value))) json_value(JSON_ARRAY, NULL, 0, arena)
+            : new json_value(JSON_ARRAY);
+        std::atomic<size_t> next_range(0);
+        size_t element_depth = max_depth ? max_depth - 1 : 0;
+        bool keep_text = keep_number_text;
+        std::vector<std::thread> pool;
+        for (size_t i = 0; i < std::min(workers, ranges.size()); i++)
+        {
+            pool.push_back(std::thread([&]()
+            {
+                for (size_t j; (j = next_range++) < ranges.size(); )
+                {
+                    array_range &range = ranges[j];
+                    json_parser parser(range.begin, range.end - range.begin);
+                    parser.max_depth = element_depth;
+                    parser.keep_number_text = keep_text;
+                    // the arena and the key table of the parser can't be shared by the threads
+                    parser.arena = arena ? &range.arena : NULL;
+                    parser.key_table = key_table ? &range.keys : NULL;
+                    JSON_LITE_STAT(parser.stats = &range.stats);
+                    range.elements = new json_value(JSON_ARRAY);
+                    range.ok = parser.parse_elements(range.elements);
+                    if (!range.ok)
+                        continue;
+
+                    // the elements are told the arena they are moved to, and the
+                    // labels are gathered, walking in depth-first order
+                    if (arena || key_table)
+                    {
+                        for (json_value *cur = range.elements->first_child; cur; )
+                        {
+                            if (arena)
+                                cur->arena = arena;
+                            if (key_table && cur->type == JSON_STRING && cur->parent->type == JSON_OBJECT)
+                                range.labels.push_back(cur);
+                            if (cur->first_child)
+                                cur = cur->first_child;
+                            else
+                            {
+                                while (!cur->next && cur->parent != range.elements)
+                                    cur = cur->parent;
+                                cur = cur->next;
+                            }
+                        }
+                    }
+                    for (json_value *cur = range.elements->first_child; cur; cur = cur->next)
+                        cur->parent = root;
+                }
+            }));
+        }
+        for (size_t i = 0; i < pool.size(); i++)
+            pool[i].join();
+
+        // an error is parsed again by run() to find its position
+        bool ok = true;
+        for (size_t i = 0; i < ranges.size(); i++)
+            ok = ok && ranges[i].ok;
+        if (!ok)
+        {
+            for (size_t i = 0; i < ranges.size(); i++)
+            {
+                // the elements in the arena of a range are freed with it
+                if (arena && ranges[i].elements)
+                {
+                    ranges[i].elements->first_child = NULL;
+                    ranges[i].elements->last_child = NULL;
+                }
+                delete ranges[i].elements;
+            }
+            if (!arena)  //left to the arena
+                delete root;
+            return this->run(result);
+        }
+
+        // join the elements in order
+        JSON_LITE_STAT(stats->values[JSON_ARRAY]++; stats->documents++);
+        for (size_t i = 0; i < ranges.size(); i++)
+        {
+            JSON_LITE_STAT(ranges[i].stats.max_depth++; *stats += ranges[i].stats);  //one more for the root
+
+            // the labels go to the key table of the parser, the memory to its arena
+            std::vector<json_value*> &labels = ranges[i].labels;
+            for (size_t k = 0; k < labels.size(); k++)
+                labels[k]->share_value(key_table->intern(labels[k]->value, labels[k]->value_length,
+                    labels[k]->label_hash), labels[k]->value_length, labels[k]->label_hash);
+            if (arena)
+                arena->adopt(ranges[i].arena);
+
+            json_value *elements = ranges[i].elements;
+            if (root->last_child)
+            {
+                root->last_child->next = elements->first_child;
+                elements->first_child->prev = root->last_child;
+            }
+            else
+                root->first_child = elements->first_child;
+            root->last_child = elements->last_child;
+            elements->first_child = NULL;
+            elements->last_child = NULL;
+            delete elements;
+        }
+
+        current_char = buffer_end;
+        parallel_ranges = ranges.size();
+        parse_result = json_parse_result();
+        result = parse_result;
+        return root;
+    }
+
+    // get_parallel_ranges
+    size_t json_parser::get_parallel_ranges() const
+    {
+        return parallel_ranges;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    // json_record_handler
+    ///////////////////////////////////////////////////////////////////////////
+
+    // ~json_record_handler
+    json_record_handler::~json_record_handler()
+    {
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    // json_parallel_reader
+    ///////////////////////////////////////////////////////////////////////////
+
+    // json_parallel_reader
+    json_parallel_reader::json_parallel_reader(size_t _threads, size_t _chunk_size, size_t _max_in_flight)
+        :threads(_threads),
+         chunk_size(_chunk_size ? _chunk_size : PARALLEL_CHUNK_SIZE),
+         max_in_flight(_max_in_flight),
+         ordered(true),
+         records(0),
+         from_memory(false),
+         memory(NULL),
+         memory_end(NULL)
+    {
+    }
+
+    // set_ordered
+    void json_parallel_reader::set_ordered(bool _ordered)
+    {
+        ordered = _ordered;
+    }
+
+    // run
+    bool json_parallel_reader::run(const std::string &file_name, json_record_handler &handler)
+    {
+        input.open(file_name.c_str(), std::ios::binary);
+        if (!input.is_open())
+            return false;
+
+        from_memory = false;
+        carry.clear();
+        this->run_chunks(handler);
+        input.close();
+        input.clear();
+        return true;
+    }
+
+    bool json_parallel_reader::run(const char *data, size_t length, json_record_handler &handler)
+    {
+        from_memory = true;
+        memory = data;
+        memory_end = data + length;
+        this->run_chunks(handler);
+        memory = memory_end = NULL;
+        return true;
+    }
+
+    // get_records
+    size_t json_parallel_reader::get_records() const
+    {
+        return records;
+    }
+
+    // get_errors
+    size_t json_parallel_reader::get_errors() const
+    {
+        return failures.size();
+    }
+
+    // get_error_results
+    const std::vector<json_parse_result>& json_parallel_reader::get_error_results() const
+    {
+        return failures;
+    }
+
+    ///
+    /// \fn         earlier_error
+    /// \brief      If an error is before another in the input
+    ///
+    bool earlier_error(const json_parse_result &a, const json_parse_result &b)
+    {
+        return a.offset < b.offset;
+    }
+
+    // run_chunks
+    void json_parallel_reader::run_chunks(json_record_handler &handler)
+    {
+        records = 0;
+        failures.clear();
+
+        size_t workers = threads ? threads : std::thread::hardware_concurrency();
+        if (workers == 0)
+            workers = 1;
+        size_t limit = max_in_flight ? max_in_flight : workers * 2;
+
+        parallel_state state;
+        std::vector<std::thread> pool;
+        for (size_t i = 0; i < workers; i++)
+            pool.push_back(std::thread(parse_chunks, &state));
+
+        std::vector<parallel_chunk*> spare;     // the chunks to reuse
+        std::vector<size_t> lines,              // the line ends of each chunk, by position
+                            failure_chunks;     // the chunk of each error, by position
+        size_t next_seq = 0,        // the position of the next chunk read
+               handed_seq = 0,      // the position of the next chunk handed in order
+               in_flight = 0,       // the chunks read and not handed yet
+               offset = 0;          // the offset of the next chunk read
+        bool more = true,           // there is more input
+             stopped = false;       // the handler stops reading
+
+        while (true)
+        {
+            // read the next chunks while there is room
+            while (more && !stopped && in_flight < limit)
+            {
+                parallel_chunk *chunk = spare.empty() ? new parallel_chunk : spare.back();
+                if (!spare.empty())
+                    spare.pop_back();
+                if (!this->fill_chunk(*chunk))
+                {
+                    spare.push_back(chunk);
+                    more = false;
+                    break;
+                }
+
+                chunk->seq = next_seq++;
+                chunk->offset = offset;
+                offset += chunk->length;
+                {
+                    std::lock_guard<std::mutex> guard(state.lock);
+                    state.work.push_back(chunk);
+                }
+                state.work_ready.notify_one();
+                in_flight++;
+            }
+            if (in_flight == 0)
+                break;
+
+            // wait for the next chunk to hand
+            parallel_chunk *chunk;
+            {
+                std::unique_lock<std::mutex> guard(state.lock);
+                while (ordered ? state.done.count(handed_seq) == 0 : state.done.empty())
+                    state.chunk_done.wait(guard);
+                std::map<size_t, parallel_chunk*>::iterator it =
+                    ordered ? state.done.find(handed_seq) : state.done.begin();
+                chunk = it->second;
+                state.done.erase(it);
+            }
+            handed_seq++;
+            in_flight--;
+
+            // the chunks parsed after the handler stops are dropped
+            for (size_t i = 0; i < chunk->records.size() && !stopped; i++)
+            {
+                records++;
+                stopped = !handler.on_record(chunk->records[i]);
+            }
+            lines.resize(std::max(lines.size(), chunk->seq + 1));
+            lines[chunk->seq] = chunk->lines;
+            failures.insert(failures.end(), chunk->failures.begin(), chunk->failures.end());
+            failure_chunks.resize(failures.size(), chunk->seq);
+
+            chunk->records.clear();
+            chunk->failures.clear();
+            chunk->lines = 0;
+            chunk->keys.clear();
+            chunk->arena.reset();
+            spare.push_back(chunk);
+        }
+
+        {
+            std::lock_guard<std::mutex> guard(state.lock);
+            state.closing = true;
+        }
+        state.work_ready.notify_all();
+        for (size_t i = 0; i < pool.size(); i++)
+            pool[i].join();
+        for (size_t i = 0; i < spare.size(); i++)
+            delete spare[i];
+
+        // the lines of the errors from the beginning of the input, every chunk
+        // before theirs is handed by now
+        for (size_t seq = 1; seq < lines.size(); seq++)
+            lines[seq] += lines[seq - 1];
+        for (size_t i = 0; i < failures.size(); i++)
+            if (failure_chunks[i] > 0)
+                failures[i].line += (int)lines[failure_chunks[i] - 1];
+        std::stable_sort(failures.begin(), failures.end(), earlier_error);
+    }
+
+    // fill_chunk
+    bool json_parallel_reader::fill_chunk(parallel_chunk &chunk)
+    {
+        if (from_memory)
+        {
+            if (memory == memory_end)
+                return false;
+
+            // end at the last line end in the chunk, or the first one after it for a long line
+            const char *end = memory_end;
+            if ((size_t)(memory_end - memory) > chunk_size)
+            {
+                end = memory + chunk_size;
+                while (end > memory && end[-1] != '\n')
+                    end--;
+                if (end == memory)
+                {
+                    end = (const char*)memchr(memory + chunk_size, '\n', memory_end - memory - chunk_size);
+                    end = end ? end + 1 : memory_end;
+                }
+            }
+
+            chunk.data = memory;
+            chunk.length = end - memory;
+            memory = end;
+            return true;
+        }
+
+        // the text after the last line end of the previous chunk comes first
+        chunk.storage.assign(carry);
+        carry.clear();
+        while (true)
+        {
+            size_t old_size = chunk.storage.size();
+            chunk.storage.resize(old_size + chunk_size);
+            input.read(&chunk.storage[old_size], chunk_size);
+            chunk.storage.resize(old_size + (size_t)input.gcount());
+            if (input.gcount() == 0)  //the end of input
+                break;
+
+            // keep the text after the last line end for the next chunk
+            size_t line_end = chunk.storage.rfind('\n');
+            if (line_end != std::string::npos && line_end >= old_size)
+            {
+                carry.assign(chunk.storage, line_end + 1, std::string::npos);
+                chunk.storage.resize(line_end + 1);
+                break;
+            }
+        }
+
+        if (chunk.storage.empty())
+            return false;
+        chunk.data = chunk.storage.data();
+        chunk.length = chunk.storage.size();
+        return true;
+    }
+}
@@ -0,0 +1,174 @@
+///////////////////////////////////////////////////////////////////////////////
+///  Copyright 2012 Garnel
+///
+///  Licensed under the Apache License, Version 2.0 (the "License");
+///  you may not use this file except in compliance with the License.
+///  You may obtain a copy of the License at
+///
+///    http://www.apache.org/licenses/LICENSE-2.0
+///
+///  Unless required by applicable law or agreed to in writing, software
+///  distributed under the License is distributed on an "AS IS" BASIS,
+///  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///////////////////////////////////////////////////////////////////////////////
+
+///
+/// \file       json_parallel.h
+/// The declaration of json_parallel_reader, parsing NDJSON on many threads
+/// \author     Garnel
+/// \date       2026/10/15
+/// \version    2.3
+/// \copyright  Apache License, Version 2.0
+///
+
+#ifndef JSON_LITE_PARALLEL
+#define JSON_LITE_PARALLEL
+
+#include <cstddef>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "json_lite.h"
+
+namespace json_lite
+{
+    const size_t PARALLEL_CHUNK_SIZE = 4 * 1024 * 1024;     ///< the default size of a chunk
+
+    struct parallel_chunk;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// json_record_handler
+    ///////////////////////////////////////////////////////////////////////////
+
+    ///
+    /// \class  json_record_handler
+    /// \brief  The receiver of the json of json_parallel_reader
+    ///
+    class json_record_handler
+    {
+    public:
+        ///
+        /// \fn         ~json_record_handler
+        /// \brief      The destructor of json_record_handler
+        ///
+        virtual ~json_record_handler();
+
+        ///
+        /// \fn         on_record
+        /// \brief      A json of the stream is parsed
+        /// \param      record  The json, in an arena of the reader
+        /// \warning    Do NOT delete the record, it is freed after the call
+        /// \return     true to go on, false to stop reading
+        ///
+        virtual bool on_record(json_value *record) = 0;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// json_parallel_reader
+    ///////////////////////////////////////////////////////////////////////////
+
+    ///
+    /// \class  json_parallel_reader
+    /// \brief  Parse a stream of json, one per line (NDJSON), on many threads
+    ///
+    /// The input is cut at line ends into chunks of about chunk_size bytes.
+    /// Worker threads parse the chunks with json_parser::next_document into
+    /// an arena per chunk, while the thread calling run() reads the next
+    /// chunks and hands the json to the handler, one at a time. At most
+    /// max_in_flight chunks are read and not yet handed, which bounds the
+    /// memory used.
+    ///
+    class json_parallel_reader
+    {
+    public:
+        ///
+        /// \fn         json_parallel_reader
+        /// \brief      The constructor of json_parallel_reader
+        /// \param      _threads        The number of worker threads, 0 for one per core
+        /// \param      _chunk_size     The size of each chunk
+        /// \param      _max_in_flight  The max chunks in memory, 0 for twice the threads
+        ///
+        json_parallel_reader(size_t _threads = 0, size_t _chunk_size = PARALLEL_CHUNK_SIZE,
+            size_t _max_in_flight = 0);
+
+        ///
+        /// \fn         set_ordered
+        /// \brief      Hand the json in the order of the input or as soon as they are parsed
+        /// \param      _ordered    true for the order of the input (the default)
+        /// \note       Unordered, the json of a chunk are still in order
+        ///
+        void set_ordered(bool _ordered);
+
+        ///
+        /// \fn         run(const std::string &file_name, json_record_handler &handler)
+        /// \brief      Parse a NDJSON file
+        /// \param      file_name   The file name
+        /// \param      handler     The receiver of the json, called on this thread only
+        /// \note       A json with an error is skipped, see get_error_results
+        /// \return     false if the file cannot be opened
+        ///
+        bool run(const std::string &file_name, json_record_handler &handler);
+
+        ///
+        /// \overload   run(const char *data, size_t length, json_record_handler &handler)
+        /// \brief      Parse NDJSON text in memory, without copying it
+        ///
+        bool run(const char *data, size_t length, json_record_handler &handler);
+
+        ///
+        /// \fn         get_records
+        /// \brief      Return the number of json handed by the last run
+        ///
+        size_t get_records() const;
+
+        ///
+        /// \fn         get_errors
+        /// \brief      Return the number of json with errors in the last run
+        ///
+        size_t get_errors() const;
+
+        ///
+        /// \fn         get_error_results
+        /// \brief      Return the errors of the json with errors in the last run,
+        ///             in the order of the input
+        /// \note       The offset and the line are from the beginning of the input
+        ///
+        const std::vector<json_parse_result>& get_error_results() const;
+
+    private:
+        json_parallel_reader(const json_parallel_reader&);              ///< copy is not allowed
+        json_parallel_reader& operator=(const json_parallel_reader&);   ///< copy is not allowed
+
+        ///
+        /// \fn         run_chunks
+        /// \brief      Read, parse and hand out the chunks of the input
+        ///
+        void run_chunks(json_record_handler &handler);
+
+        ///
+        /// \fn         fill_chunk
+        /// \brief      Read the next chunk, ending at a line end
+        /// \return     false at the end of input
+        ///
+        bool fill_chunk(parallel_chunk &chunk);
+
+    private:
+        size_t threads;             ///< the number of worker threads, 0 for one per core
+        size_t chunk_size;          ///< the size of each chunk
+        size_t max_in_flight;       ///< the max chunks in memory, 0 for twice the threads
+        bool ordered;               ///< if the json are handed in the order of the input
+        size_t records;             ///< the json handed by the last run
+        std::vector<json_parse_result> failures;    ///< the errors of the last run
+
+        bool from_memory;           ///< if the input is in memory rather than a file
+        std::ifstream input;        ///< the input file
+        std::string carry;          ///< the text read from the file after the last line end
+        const char *memory;         ///< the text in memory not cut into chunks yet
+        const char *memory_end;     ///< one past the last character in memory
+    };
+}
+
+#endif // JSON_LITE_PARALLEL
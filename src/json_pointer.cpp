@@ -0,0 +1,152 @@
+///////////////////////////////////////////////////////////////////////////////
+///  Copyright 2012 Garnel
+///
+///  Licensed under the Apache License, Version 2.0 (the "License");
+///  you may not use this file except in compliance with the License.
+///  You may obtain a copy of the License at
+///
+///    http://www.apache.org/licenses/LICENSE-2.0
+///
+///  Unless required by applicable law or agreed to in writing, software
+///  distributed under the License is distributed on an "AS IS" BASIS,
+///  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///////////////////////////////////////////////////////////////////////////////
+
+///
+/// \file       json_pointer.cpp
+/// The implementation of class json_pointer
+/// \author     Garnel
+/// \date       2026/10/15
+/// \version    2.3
+/// \copyright  Apache License, Version 2.0
+///
+
+#include "json_pointer.h"
+#include "json_intern.h"
+
+///
+/// \namespace  json_lite
+///
+namespace json_lite
+{
+    const size_t json_pointer::NO_INDEX;
+
+    // json_pointer
+    json_pointer::json_pointer()
+    {
+    }
+
+    json_pointer::json_pointer(const std::string &pointer)
+    {
+        if (!this->compile(pointer))
+        {
+            throw "The json pointer is invalid!";
+        }
+    }
+
+    // compile
+    bool json_pointer::compile(const std::string &pointer)
+    {
+        segments.clear();
+        if (pointer.empty())  //the document itself
+            return true;
+        if (pointer[0] != '/')
+            return false;
+
+        for (size_t begin = 1; ; )
+        {
+            size_t end = pointer.find('/', begin);
+            if (end == std::string::npos)
+                end = pointer.size();
+
+            segment part;
+            for (size_t i = begin; i < end; i++)
+            {
+                if (pointer[i] != '~')
+                    part.label += pointer[i];
+                else if (i + 1 < end && (pointer[i + 1] == '0' || pointer[i + 1] == '1'))
+                    part.label += pointer[++i] == '0' ? '~' : '/';
+                else
+                {
+                    segments.clear();
+                    return false;
+                }
+            }
+            part.hash = hash_label(part.label.data(), part.label.size());
+
+            // "0", or digits not beginning with '0', which don't overflow
+            part.index = part.label.empty() || (part.label[0] == '0' && part.label.size() > 1) ? NO_INDEX : 0;
+            for (size_t i = 0; i < part.label.size() && part.index != NO_INDEX; i++)
+            {
+                char c = part.label[i];
+                if (c < '0' || c > '9' || part.index > (NO_INDEX - 1 - (c - '0')) / 10)
+                    part.index = NO_INDEX;
+                else
+                    part.index = part.index * 10 + (c - '0');
+            }
+            segments.push_back(part);
+
+            if (end == pointer.size())
+                break;
+            begin = end + 1;
+        }
+        return true;
+    }
+
+    // resolve
+    json_value* json_pointer::resolve(const json_value *root) const
+    {
+        const json_value *cur = root;
+        for (size_t i = 0; i < segments.size() && cur; i++)
+        {
+            const segment &part = segments[i];
+            switch (cur->get_type())
+            {
+            case JSON_OBJECT:
+                cur = cur->get_member(part.label.data(), part.label.size(), part.hash);
+                break;
+            case JSON_ARRAY:
+                if (part.index == NO_INDEX)
+                    return NULL;
+                cur = cur->get_first_child();
+                for (size_t k = part.index; k > 0 && cur; k--)
+                    cur = cur->get_next();
+                break;
+            default:  //a string, number, true, false or null has no children
+                return NULL;
+            }
+        }
+        return (json_value*)cur;
+    }
+
+    // size
+    size_t json_pointer::size() const
+    {
+        return segments.size();
+    }
+
+    // get_segment
+    const std::string& json_pointer::get_segment(size_t i) const
+    {
+        return segments[i].label;
+    }
+
+    // get_index
+    size_t json_pointer::get_index(size_t i) const
+    {
+        return segments[i].index;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    // json_value::get_pointer
+    ///////////////////////////////////////////////////////////////////////////
+
+    // get_pointer
+    json_value* json_value::get_pointer(const std::string &pointer) const
+    {
+        json_pointer path;
+        return path.compile(pointer) ? path.resolve(this) : NULL;
+    }
+}
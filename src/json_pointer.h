@@ -0,0 +1,128 @@
+///////////////////////////////////////////////////////////////////////////////
+///  Copyright 2012 Garnel
+///
+///  Licensed under the Apache License, Version 2.0 (the "License");
+///  you may not use this file except in compliance with the License.
+///  You may obtain a copy of the License at
+///
+///    http://www.apache.org/licenses/LICENSE-2.0
+///
+///  Unless required by applicable law or agreed to in writing, software
+///  distributed under the License is distributed on an "AS IS" BASIS,
+///  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///////////////////////////////////////////////////////////////////////////////
+
+///
+/// \file       json_pointer.h
+/// The declaration of json_pointer, a JSON Pointer (RFC 6901) compiled once
+/// \author     Garnel
+/// \date       2026/10/15
+/// \version    2.3
+/// \copyright  Apache License, Version 2.0
+///
+
+#ifndef JSON_LITE_POINTER
+#define JSON_LITE_POINTER
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "json_lite.h"
+
+namespace json_lite
+{
+    ///////////////////////////////////////////////////////////////////////////
+    /// json_pointer
+    ///////////////////////////////////////////////////////////////////////////
+
+    ///
+    /// \class  json_pointer
+    /// \brief  A JSON Pointer split into its segments, to be resolved in many documents
+    ///
+    /// A pointer like "/items/2/id" addresses the member "id" of the third
+    /// element of the member "items". "~1" stands for '/' and "~0" for '~'
+    /// in a segment. The empty pointer "" addresses the document itself.
+    ///
+    /// The segments are unescaped and hashed once, when the pointer is
+    /// compiled, so resolve only walks the document: a segment is a label in
+    /// an object, looked up by get_member, and an index in an array. An index
+    /// is "0" or digits not beginning with '0'; "-", the element after the
+    /// last, never exists.
+    ///
+    /// \note   The URI fragment form ("#/items/2") is not supported
+    ///
+    class json_pointer
+    {
+    public:
+        ///
+        /// \fn         json_pointer
+        /// \brief      The empty pointer, addressing the document itself
+        ///
+        json_pointer();
+
+        ///
+        /// \overload   json_pointer(const std::string &pointer)
+        /// \brief      Compile a pointer
+        /// \param      pointer     Like "/items/2/id"
+        /// \exception  char*       If the pointer is invalid, throw a message
+        ///
+        explicit json_pointer(const std::string &pointer);
+
+        ///
+        /// \fn         compile
+        /// \brief      Compile a pointer, replacing the segments
+        /// \param      pointer     Like "/items/2/id"
+        /// \return     false if the pointer doesn't begin with '/' or has a '~' not
+        ///             followed by '0' or '1', then the pointer is empty
+        ///
+        bool compile(const std::string &pointer);
+
+        ///
+        /// \fn         resolve
+        /// \brief      Return the element the pointer addresses from an element
+        /// \param      root    The document, or any element, NULL gives NULL
+        /// \warning    Do NOT delete the pointer returned
+        /// \return     The element, or NULL if it doesn't exist
+        ///
+        json_value* resolve(const json_value *root) const;
+
+        ///
+        /// \fn         size
+        /// \brief      Return the number of segments
+        ///
+        size_t size() const;
+
+        ///
+        /// \fn         get_segment
+        /// \brief      Return a segment, unescaped
+        ///
+        const std::string& get_segment(size_t i) const;
+
+        ///
+        /// \fn         get_index
+        /// \brief      Return the index a segment means in an array, or NO_INDEX
+        ///
+        size_t get_index(size_t i) const;
+
+        static const size_t NO_INDEX = (size_t)-1;  ///< a segment which is not an index
+
+    private:
+        ///
+        /// \struct     segment
+        /// \brief      A label, and the index it means in an array
+        ///
+        struct segment
+        {
+            std::string label;      ///< the segment unescaped
+            size_t hash;            ///< the hash of the label by hash_label
+            size_t index;           ///< the index in an array, NO_INDEX if it is not one
+        };
+
+        std::vector<segment> segments;  ///< the segments in order
+    };
+}
+
+#endif // JSON_LITE_POINTER
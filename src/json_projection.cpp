@@ -0,0 +1,428 @@
+///////////////////////////////////////////////////////////////////////////////
+///  Copyright 2012 Garnel
+///
+///  Licensed under the Apache License, Version 2.0 (the "License");
+///  you may not use this file except in compliance with the License.
+///  You may obtain a copy of the License at
+///
+///    http://www.apache.org/licenses/LICENSE-2.0
+///
+///  Unless required by applicable law or agreed to in writing, software
+///  distributed under the License is distributed on an "AS IS" BASIS,
+///  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///////////////////////////////////////////////////////////////////////////////
+
+///
+/// \file       json_projection.cpp
+/// The implementation of class json_projection
+/// \author     Garnel
+/// \date       2026/10/15
+/// \version    2.3
+/// \copyright  Apache License, Version 2.0
+///
+
+#include "json_projection.h"
+#include "json_intern.h"
+#include "json_pointer.h"
+
+#include <cstring>
+
+///
+/// \namespace  json_lite
+///
+namespace json_lite
+{
+    // json_projection
+    json_projection::json_projection()
+        :nodes(1),
+         found(0)
+    {
+        nodes[0].hash = 0;
+        nodes[0].index = json_pointer::NO_INDEX;
+        nodes[0].has_indexes = false;
+    }
+
+    // ~json_projection
+    json_projection::~json_projection()
+    {
+        this->clear();
+    }
+
+    // add_path
+    bool json_projection::add_path(const std::string &pointer)
+    {
+        json_pointer path;
+        if (!path.compile(pointer))
+            return false;
+        this->clear();
+
+        // follow the segments already in the tree, and add the others
+        size_t current = 0;
+        for (size_t i = 0; i < path.size(); i++)
+        {
+            const std::string &_label = path.get_segment(i);
+            size_t hash = hash_label(_label.data(), _label.size());
+            size_t child = this->find_child(current, _label.data(), _label.size(), hash);
+            if (!child)
+            {
+                node segment;
+                segment.label = _label;
+                segment.hash = hash;
+                segment.index = path.get_index(i);
+                segment.has_indexes = false;
+                child = nodes.size();
+                nodes.push_back(segment);
+                nodes[current].children.push_back(child);
+                if (segment.index != json_pointer::NO_INDEX)
+                    nodes[current].has_indexes = true;
+            }
+            current = child;
+        }
+        nodes[current].paths.push_back(values.size());
+        values.push_back(NULL);
+        return true;
+    }
+
+    // size
+    size_t json_projection::size() const
+    {
+        return values.size();
+    }
+
+    // run
+    bool json_projection::run(json_parser &parser)
+    {
+        json_parse_result result;
+        bool ok = this->run(parser, result);
+        if (result.failed)
+            parser.print_error(result);
+        return ok;
+    }
+
+    bool json_projection::run(json_parser &parser, json_parse_result &result)
+    {
+        parser.parse_result = json_parse_result();
+        this->clear();
+
+        //escape blank characters
+        char temp_char = parser.escape_blank();
+        bool ok = temp_char == '{' || temp_char == '['
+            ? this->walk(parser, 0) : parser.fail(SHOULD_BE_OBJECT_OR_ARRAY);
+
+        if (ok && !parser.is_end())  //after the json should be only blank characters
+            ok = parser.fail(EXTRA_CONTENT_AFTER_JSON);
+        if (!ok)
+            this->clear();
+        result = parser.parse_result;
+        return ok;
+    }
+
+    // next_document
+    bool json_projection::next_document(json_parser &parser)
+    {
+        json_parse_result result;
+        bool ok = this->next_document(parser, result);
+        if (result.failed)
+            parser.print_error(result);
+        return ok;
+    }
+
+    bool json_projection::next_document(json_parser &parser, json_parse_result &result)
+    {
+        parser.parse_result = json_parse_result();
+        this->clear();
+
+        //escape blank characters, nothing left is the end of the stream
+        if (parser.is_end())
+        {
+            result = parser.parse_result;
+            return false;
+        }
+
+        char temp_char = parser.escape_blank();
+        parser.record_begin = parser.current_char;  //see json_parser::next_document
+        bool ok = temp_char == '{' || temp_char == '['
+            ? this->walk(parser, 0) : parser.fail(SHOULD_BE_OBJECT_OR_ARRAY);
+
+        if (!ok)
+        {
+            this->clear();
+            parser.skip_line();
+        }
+        parser.record_begin = NULL;
+        result = parser.parse_result;
+        return ok;
+    }
+
+    // get_value
+    json_value* json_projection::get_value(size_t path) const
+    {
+        return values[path];
+    }
+
+    // clear
+    void json_projection::clear()
+    {
+        for (size_t i = 0; i < built.size(); i++)
+            if (!built[i]->get_arena())  //the arena frees its own
+                delete built[i];
+        built.clear();
+        for (size_t i = 0; i < values.size(); i++)
+            values[i] = NULL;
+        found = 0;
+    }
+
+    // walk
+    bool json_projection::walk(json_parser &parser, size_t node)
+    {
+        // every path is found, or a label repeated
+        if (found == values.size()
+            || (!nodes[node].paths.empty() && values[nodes[node].paths[0]]))
+            return this->skip_value(parser);
+
+        // the value of some paths is built, with the paths inside it
+        if (!nodes[node].paths.empty())
+        {
+            json_value *value = parser.parse_element(parser.escape_blank());
+            if (!value)
+                return false;
+            built.push_back(value);
+            this->found_at(node, value);
+            this->resolve(value, node);
+            return true;
+        }
+
+        switch (parser.escape_blank())
+        {
+        case '{':
+            return this->walk_object(parser, node);
+        case '[':
+            if (nodes[node].has_indexes)
+                return this->walk_array(parser, node);
+            return this->skip_value(parser);
+        default:  //the paths go on in a string, number, true, false or null
+            return this->skip_value(parser);
+        }
+    }
+
+    // walk_object
+    bool json_projection::walk_object(json_parser &parser, size_t node)
+    {
+        // escape the {
+        parser.get_char();
+        char temp_char = parser.escape_blank();
+        if (temp_char == '}')  //the object is empty
+        {
+            parser.get_char();
+            return true;
+        }
+
+        while (true)
+        {
+            if (found == values.size())  //nothing more to look for
+                return this->skip_rest(parser, true);
+
+            //the label of a pair
+            if (temp_char != '\"')
+                return parser.fail(temp_char == '\0' && parser.at_end() ? UNCLOSED_OBJECT : MISSING_QUOTATION);
+            parser.get_char();
+            label.clear();
+            if (!parser.read_string(label))
+                return false;
+            if (parser.escape_blank() != ':')
+                return parser.fail(MISSING_COLON);
+            parser.get_char();
+
+            //the value of the label, walked if it is on a path
+            size_t child = this->find_child(node, label.data(), label.size(),
+                hash_label(label.data(), label.size()));
+            if (!(child ? this->walk(parser, child) : this->skip_value(parser)))
+                return false;
+
+            //',' or the end of the object
+            temp_char = parser.escape_blank();
+            if (temp_char == '}')
+            {
+                parser.get_char();
+                return true;
+            }
+            if (temp_char == '\0' && parser.at_end())
+                return parser.fail(UNCLOSED_OBJECT);
+            if (temp_char != ',')
+                return parser.fail(INVALID_CHARACTER);
+            parser.get_char();
+            temp_char = parser.escape_blank();
+            if (temp_char == '}')  //extra comma (like this: "XXX, }")
+                return parser.fail(EXTRA_COMMA);
+        }
+    }
+
+    // walk_array
+    bool json_projection::walk_array(json_parser &parser, size_t node)
+    {
+        // escape the [
+        parser.get_char();
+        char temp_char = parser.escape_blank();
+        if (temp_char == ']')  //the array is empty
+        {
+            parser.get_char();
+            return true;
+        }
+
+        for (size_t index = 0; ; index++)
+        {
+            if (found == values.size())  //nothing more to look for
+                return this->skip_rest(parser, false);
+
+            //the element, walked if it is on a path
+            size_t child = this->find_child(node, index);
+            if (!(child ? this->walk(parser, child) : this->skip_value(parser)))
+                return false;
+
+            //',' or the end of the array
+            temp_char = parser.escape_blank();
+            if (temp_char == ']')
+            {
+                parser.get_char();
+                return true;
+            }
+            if (temp_char == '\0' && parser.at_end())
+                return parser.fail(UNCLOSED_ARRAY);
+            if (temp_char != ',')
+                return parser.fail(INVALID_CHARACTER);
+            parser.get_char();
+            temp_char = parser.escape_blank();
+            if (temp_char == ']')  //extra comma (like this: "XXX, ]")
+                return parser.fail(EXTRA_COMMA);
+        }
+    }
+
+    // resolve
+    void json_projection::resolve(json_value *value, size_t node)
+    {
+        const std::vector<size_t> &children = nodes[node].children;
+        for (size_t i = 0; i < children.size(); i++)
+        {
+            const struct node &segment = nodes[children[i]];
+            json_value *child = NULL;
+            if (value->get_type() == JSON_OBJECT)
+                child = value->get_member(segment.label.data(), segment.label.size(), segment.hash);
+            else if (value->get_type() == JSON_ARRAY && segment.index != json_pointer::NO_INDEX)
+            {
+                child = value->get_first_child();
+                for (size_t k = segment.index; k > 0 && child; k--)
+                    child = child->get_next();
+            }
+            if (child)
+            {
+                this->found_at(children[i], child);
+                this->resolve(child, children[i]);
+            }
+        }
+    }
+
+    // found_at
+    void json_projection::found_at(size_t node, json_value *value)
+    {
+        const std::vector<size_t> &paths = nodes[node].paths;
+        for (size_t i = 0; i < paths.size(); i++)
+        {
+            if (!values[paths[i]])
+                found++;
+            values[paths[i]] = value;
+        }
+    }
+
+    // find_child
+    size_t json_projection::find_child(size_t node, const char *_label, size_t length, size_t hash) const
+    {
+        // the hash and the length tell most labels apart before their bytes
+        const std::vector<size_t> &children = nodes[node].children;
+        for (size_t i = 0; i < children.size(); i++)
+        {
+            const struct node &child = nodes[children[i]];
+            if (child.hash == hash && child.label.size() == length
+                && memcmp(child.label.data(), _label, length) == 0)
+                return children[i];
+        }
+        return 0;
+    }
+
+    size_t json_projection::find_child(size_t node, size_t index) const
+    {
+        const std::vector<size_t> &children = nodes[node].children;
+        for (size_t i = 0; i < children.size(); i++)
+            if (nodes[children[i]].index == index)
+                return children[i];
+        return 0;
+    }
+
+    // skip_value
+    bool json_projection::skip_value(json_parser &parser)
+    {
+        char temp_char = parser.escape_blank();
+        switch (temp_char)
+        {
+        case '\"':
+            parser.get_char();
+            parser.skip_string();
+            return true;
+
+        case '{':
+        case '[':
+            parser.get_char();
+            return this->skip_rest(parser, temp_char == '{');
+
+        case ',':
+        case '}':
+        case ']':
+            return parser.fail(EMPTY_VALUE);
+
+        case '\0':
+            return parser.fail(parser.at_end() ? EMPTY_VALUE : INVALID_CHARACTER);
+
+        default:
+            // a number, true, false or null, up to the next separator
+            while (temp_char != ',' && temp_char != '}' && temp_char != ']'
+                && temp_char != ' ' && temp_char != '\n' && temp_char != '\r' && temp_char != '\t'
+                && !(temp_char == '\0' && parser.at_end()))
+            {
+                parser.get_char();
+                temp_char = parser.get_current_char();
+            }
+            return true;
+        }
+    }
+
+    // skip_rest
+    bool json_projection::skip_rest(json_parser &parser, bool in_object)
+    {
+        // match the brackets, skipping strings which may have brackets in them
+        for (size_t nest = 1; nest; )
+        {
+            switch (parser.get_char())
+            {
+            case '\"':
+                parser.skip_string();
+                break;
+            case '{':
+            case '[':
+                nest++;
+                break;
+            case '}':
+            case ']':
+                nest--;
+                break;
+            case '\0':
+                if (!parser.at_end())  //a '\0' in the text
+                    break;
+                return parser.fail(in_object ? UNCLOSED_OBJECT : UNCLOSED_ARRAY);
+            default:
+                break;
+            }
+        }
+        return true;
+    }
+}
@@ -0,0 +1,227 @@
+///////////////////////////////////////////////////////////////////////////////
+///  Copyright 2012 Garnel
+///
+///  Licensed under the Apache License, Version 2.0 (the "License");
+///  you may not use this file except in compliance with the License.
+///  You may obtain a copy of the License at
+///
+///    http://www.apache.org/licenses/LICENSE-2.0
+///
+///  Unless required by applicable law or agreed to in writing, software
+///  distributed under the License is distributed on an "AS IS" BASIS,
+///  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///////////////////////////////////////////////////////////////////////////////
+
+///
+/// \file       json_projection.h
+/// The declaration of json_projection, extracting some paths of a json in one pass
+/// \author     Garnel
+/// \date       2026/10/15
+/// \version    2.3
+/// \copyright  Apache License, Version 2.0
+///
+
+#ifndef JSON_LITE_PROJECTION
+#define JSON_LITE_PROJECTION
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "json_lite.h"
+
+namespace json_lite
+{
+    ///////////////////////////////////////////////////////////////////////////
+    /// json_projection
+    ///////////////////////////////////////////////////////////////////////////
+
+    ///
+    /// \class  json_projection
+    /// \brief  Extract the values of some JSON Pointers from the input, in one pass
+    ///
+    /// The paths are merged into a tree of segments when they are added. The
+    /// input is walked once from the parser: only the labels of the objects
+    /// on a path are decoded, every other value is passed over by matching
+    /// its brackets, and only the values addressed are built. Once every
+    /// path is found, the rest of the json is passed over.
+    ///
+    /// \code
+    /// json_projection projection;
+    /// projection.add_path("/user/id");
+    /// projection.add_path("/items/0/price");
+    /// while (projection.next_document(parser))
+    ///     if (projection.get_value(0))
+    ///         ...
+    /// \endcode
+    ///
+    /// \note   What is passed over is NOT checked, like json_cursor::skip_value.
+    ///         A label repeated in an object is found at its first value.
+    /// \note   A path inside another (like "/a/b" with "/a") is resolved in the
+    ///         value of the outer one, and shares its memory.
+    ///
+    class json_projection
+    {
+    public:
+        ///
+        /// \fn         json_projection
+        /// \brief      A projection without paths
+        ///
+        json_projection();
+
+        ///
+        /// \fn         ~json_projection
+        /// \brief      Free the values extracted
+        ///
+        ~json_projection();
+
+        ///
+        /// \fn         add_path
+        /// \brief      Add a path, numbered in the order added from 0
+        /// \param      pointer     A JSON Pointer, like "/items/2/id", see json_pointer
+        /// \note       The values extracted are cleared
+        /// \return     false if the pointer is invalid, then it is not added
+        ///
+        bool add_path(const std::string &pointer);
+
+        ///
+        /// \fn         size
+        /// \brief      Return the number of paths
+        ///
+        size_t size() const;
+
+        ///
+        /// \fn         run
+        /// \brief      Extract the values of the paths from the whole json of a parser
+        /// \param      parser      The parser of the json, at its beginning
+        /// \note       An error is printed, see run(json_parser &parser, json_parse_result &result)
+        /// \return     false for an error, then no value is kept
+        ///
+        bool run(json_parser &parser);
+
+        ///
+        /// \overload   run(json_parser &parser, json_parse_result &result)
+        /// \brief      Extract the values of the paths, giving back an error instead of printing it
+        /// \param      result      The error and its position, if the json has an error
+        ///
+        bool run(json_parser &parser, json_parse_result &result);
+
+        ///
+        /// \fn         next_document
+        /// \brief      Extract the values of the paths from the next json of a stream
+        /// \param      parser      The parser of the stream, see json_parser::next_document
+        /// \note       A json with an error is printed, and the stream goes on at the line
+        ///             after the one where it begins, like json_parser::next_document
+        /// \return     false at the end of the stream or for a json with an error, see
+        ///             json_parser::is_end
+        ///
+        bool next_document(json_parser &parser);
+
+        ///
+        /// \overload   next_document(json_parser &parser, json_parse_result &result)
+        /// \brief      Extract from the next json of a stream, giving back an error
+        ///             instead of printing it
+        ///
+        bool next_document(json_parser &parser, json_parse_result &result);
+
+        ///
+        /// \fn         get_value
+        /// \brief      Return the value of a path in the last json
+        /// \param      path    The number of the path, see add_path
+        /// \warning    Do NOT delete the pointer returned, it is freed by the next
+        ///             extraction, clear() or the projection. Values allocated from
+        ///             the arena of the parser are left to the arena.
+        /// \return     The value, or NULL if the path doesn't exist in the json
+        ///
+        json_value* get_value(size_t path) const;
+
+        ///
+        /// \fn         clear
+        /// \brief      Free the values extracted, the paths are kept
+        ///
+        void clear();
+
+    private:
+        json_projection(const json_projection&);              ///< copy is not allowed
+        json_projection& operator=(const json_projection&);   ///< copy is not allowed
+
+        ///
+        /// \fn         walk
+        /// \brief      Walk the value at the cursor for a node of the paths
+        /// \return     false for an error
+        ///
+        bool walk(json_parser &parser, size_t node);
+
+        ///
+        /// \fn         walk_object
+        /// \brief      Walk the members of the object at the cursor for a node
+        ///
+        bool walk_object(json_parser &parser, size_t node);
+
+        ///
+        /// \fn         walk_array
+        /// \brief      Walk the elements of the array at the cursor for a node
+        ///
+        bool walk_array(json_parser &parser, size_t node);
+
+        ///
+        /// \fn         resolve
+        /// \brief      Find the paths below a node in a value built for it
+        ///
+        void resolve(json_value *value, size_t node);
+
+        ///
+        /// \fn         found_at
+        /// \brief      Give a value to the paths ending at a node
+        ///
+        void found_at(size_t node, json_value *value);
+
+        ///
+        /// \fn         find_child
+        /// \brief      Return the child of a node for a label or an index, 0 for none
+        /// \param      hash    The hash of the label by hash_label
+        ///
+        size_t find_child(size_t node, const char *_label, size_t length, size_t hash) const;
+        size_t find_child(size_t node, size_t index) const;
+
+        ///
+        /// \fn         skip_value
+        /// \brief      Pass over the value at the cursor
+        /// \note       Strings are not decoded, numbers and literals are passed
+        ///             over up to the next separator, and brackets are matched
+        ///
+        bool skip_value(json_parser &parser);
+
+        ///
+        /// \fn         skip_rest
+        /// \brief      Pass over the rest of the object or array the cursor is in,
+        ///             with its closing bracket
+        ///
+        bool skip_rest(json_parser &parser, bool in_object);
+
+    private:
+        ///
+        /// \struct     node
+        /// \brief      A segment of some paths, node 0 is the json itself
+        ///
+        struct node
+        {
+            std::string label;              ///< the segment unescaped
+            size_t hash;                    ///< the hash of the label by hash_label
+            size_t index;                   ///< the index in an array, json_pointer::NO_INDEX if it is not one
+            bool has_indexes;               ///< if some child can match an index in an array
+            std::vector<size_t> children;   ///< the nodes of the next segments
+            std::vector<size_t> paths;      ///< the paths ending here
+        };
+
+        std::vector<node> nodes;            ///< the tree of the paths
+        std::vector<json_value*> values;    ///< the value of each path, or NULL
+        std::vector<json_value*> built;     ///< the values built, freed by clear
+        size_t found;                       ///< the paths with a value
+        std::string label;                  ///< the label read, reused
+    };
+}
+
+#endif // JSON_LITE_PROJECTION
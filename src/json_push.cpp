@@ -0,0 +1,669 @@
+///////////////////////////////////////////////////////////////////////////////
+///  Copyright 2012 Garnel
+///
+///  Licensed under the Apache License, Version 2.0 (the "License");
+///  you may not use this file except in compliance with the License.
+///  You may obtain a copy of the License at
+///
+///    http://www.apache.org/licenses/LICENSE-2.0
+///
+///  Unless required by applicable law or agreed to in writing, software
+///  distributed under the License is distributed on an "AS IS" BASIS,
+///  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///////////////////////////////////////////////////////////////////////////////
+
+///
+/// \file       json_push.cpp
+/// The implementation of class json_push_parser
+/// \author     Garnel
+/// \date       2026/10/15
+/// \version    2.3
+/// \copyright  Apache License, Version 2.0
+///
+
+#include "json_push.h"
+#include "json_index.h"
+
+#include <cassert>
+
+///
+/// \namespace  json_lite
+///
+namespace json_lite
+{
+    ///
+    /// \fn         is_blank
+    /// \brief      If the character is a blank character between tokens
+    ///
+    inline bool is_blank(char c)
+    {
+        return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+    }
+
+    ///
+    /// \fn         hex_digit
+    /// \brief      Return the value of a hex digit, -1 for other characters
+    ///
+    inline int hex_digit(char c)
+    {
+        if (c >= '0' && c <= '9')
+            return c - '0';
+        if (c >= 'a' && c <= 'f')
+            return c - 'a' + 10;
+        if (c >= 'A' && c <= 'F')
+            return c - 'A' + 10;
+        return -1;
+    }
+
+    // json_push_parser
+    json_push_parser::json_push_parser()
+        :handler(NULL),
+         tree_parser(new json_parser("", 0)),
+         builder(NULL),
+         root(NULL),
+         literal('n'),
+         max_depth(0)
+    {
+        this->reset();
+    }
+
+    json_push_parser::json_push_parser(json_handler &_handler)
+        :handler(&_handler),
+         tree_parser(NULL),
+         builder(NULL),
+         root(NULL),
+         literal('n'),
+         max_depth(0)
+    {
+        this->reset();
+    }
+
+    // ~json_push_parser
+    json_push_parser::~json_push_parser()
+    {
+        if (root && !root->get_arena())
+            delete root;
+        if (builder)
+        {
+            builder->discard();
+            delete builder;
+        }
+        delete tree_parser;
+    }
+
+    // feed
+    json_push_status json_push_parser::feed(const char *data, size_t length)
+    {
+        assert(data || length == 0);
+        if (status == PUSH_ERROR || status == PUSH_STOPPED)
+            return status;
+
+        if (!this->parse(data, data + length))
+            return parse_result.failed ? this->stop_on_error() : status = PUSH_STOPPED;
+        return status = where == STATE_END ? PUSH_DONE : PUSH_NEED_MORE;
+    }
+
+    // finish
+    json_push_status json_push_parser::finish()
+    {
+        if (status == PUSH_ERROR || status == PUSH_STOPPED)
+            return status;
+
+        // the errors of json_parser at the end of input
+        json_parse_error error_type = stack.empty() || stack.back() ? UNCLOSED_OBJECT : UNCLOSED_ARRAY;
+        switch (where)
+        {
+        case STATE_END:
+            return status = PUSH_DONE;
+        case STATE_START:
+            error_type = SHOULD_BE_OBJECT_OR_ARRAY;
+            break;
+        case STATE_LITERAL:
+            error_type = literal.get_error();
+            break;
+        case STATE_KEY:
+        case STATE_STRING:
+            if (escape_state != ESCAPE_NONE && escape_state != ESCAPE_SURROGATE)
+                error_type = INVALID_ESCAPE_CHARACTER;
+            else if (where == STATE_KEY)
+                error_type = MISSING_COLON;
+            break;
+        case STATE_COLON:
+            error_type = MISSING_COLON;
+            break;
+        case STATE_ELEMENT:
+            if (expect_value && stack.back())
+                error_type = MISSING_QUOTATION;
+            break;
+        default:
+            break;
+        }
+        this->fail(error_type);
+        return this->stop_on_error();
+    }
+
+    // reset
+    void json_push_parser::reset()
+    {
+        if (root && !root->get_arena())
+            delete root;
+        root = NULL;
+        if (tree_parser)
+        {
+            if (builder)
+            {
+                builder->discard();
+                delete builder;
+            }
+            builder = new json_parser::tree_builder(*tree_parser);
+            handler = builder;
+        }
+
+        status = PUSH_NEED_MORE;
+        parse_result = json_parse_result();
+        where = STATE_START;
+        stack.clear();
+        expect_value = true;
+        first = true;
+        token.clear();
+        literal = json_parser::literal_syntax('n');
+        number = json_parser::number_syntax();
+        escape_state = ESCAPE_NONE;
+        hex_count = 0;
+        code = 0;
+        high = 0;
+        line = 1;
+        pos_in_line = 1;
+        offset = 0;
+    }
+
+    // get_status
+    json_push_status json_push_parser::get_status() const
+    {
+        return status;
+    }
+
+    // get_result
+    const json_parse_result& json_push_parser::get_result() const
+    {
+        return parse_result;
+    }
+
+    // release_root
+    json_value* json_push_parser::release_root()
+    {
+        json_value *_root = root;
+        root = NULL;
+        return _root;
+    }
+
+    // set_max_depth
+    void json_push_parser::set_max_depth(size_t depth)
+    {
+        max_depth = depth;
+    }
+
+    // set_arena
+    void json_push_parser::set_arena(json_arena *_arena)
+    {
+        assert(tree_parser && "only a parser building a tree has an arena");
+        if (tree_parser)
+            tree_parser->set_arena(_arena);
+    }
+
+    // set_key_table
+    void json_push_parser::set_key_table(json_key_table *_key_table)
+    {
+        assert(tree_parser && "only a parser building a tree has a key table");
+        if (tree_parser)
+            tree_parser->set_key_table(_key_table);
+    }
+
+    // set_keep_number_text
+    void json_push_parser::set_keep_number_text(bool keep)
+    {
+        assert(tree_parser && "only a parser building a tree keeps numbers");
+        if (tree_parser)
+            tree_parser->set_keep_number_text(keep);
+    }
+
+    // parse
+    bool json_push_parser::parse(const char *p, const char *end)
+    {
+        while (p < end && !parse_result.failed)
+        {
+            char temp_char = *p;
+            switch (where)
+            {
+            case STATE_START:
+                if (is_blank(temp_char))
+                {
+                    this->get_char(p);
+                    break;
+                }
+                if (temp_char != '{' && temp_char != '[')
+                {
+                    this->get_char(p);  //the position is after it, like json_parser
+                    return this->fail(SHOULD_BE_OBJECT_OR_ARRAY);
+                }
+                if (!this->begin_value(p))
+                    return false;
+                break;
+
+            case STATE_ELEMENT:
+                {
+                    //escape blank characters
+                    if (is_blank(temp_char))
+                    {
+                        this->get_char(p);
+                        break;
+                    }
+
+                    bool in_object = stack.back();
+                    char close = in_object ? '}' : ']';
+
+                    // the element separator ','
+                    if (!expect_value && temp_char == ',')
+                    {
+                        this->get_char(p);
+                        expect_value = true;
+                        first = false;
+                        break;
+                    }
+
+                    // the end of the object or array
+                    if (!expect_value || temp_char == close)
+                    {
+                        if (temp_char != close)
+                            return this->fail(INVALID_CHARACTER);
+                        if (expect_value && !first)  //extra comma (like this: "XXX, }")
+                            return this->fail(EXTRA_COMMA);
+
+                        this->get_char(p);
+                        stack.pop_back();
+                        expect_value = false;
+                        bool go_on = in_object ? handler->on_end_object() : handler->on_end_array();
+                        if (stack.empty())
+                        {
+                            where = STATE_END;
+                            if (builder)  //the tree is complete
+                            {
+                                root = builder->get_root();
+                                delete builder;
+                                builder = NULL;
+                                handler = NULL;
+                            }
+                        }
+                        if (!go_on)
+                            return false;
+                        break;
+                    }
+
+                    if (in_object)
+                    {
+                        if (temp_char != '\"')
+                            return this->fail(MISSING_QUOTATION);
+                        //escape the left quotation
+                        this->get_char(p);
+                        token.clear();
+                        escape_state = ESCAPE_NONE;
+                        where = STATE_KEY;
+                        break;
+                    }
+
+                    if (!this->begin_value(p))
+                        return false;
+                }
+                break;
+
+            case STATE_KEY:
+                if (this->parse_string(p, end))
+                {
+                    where = STATE_COLON;
+                    if (!handler->on_key(token))
+                        return false;
+                }
+                break;
+
+            case STATE_COLON:
+                if (is_blank(temp_char))
+                {
+                    this->get_char(p);
+                    break;
+                }
+                //the current char must be ':'
+                if (temp_char != ':')
+                    return this->fail(MISSING_COLON);
+                this->get_char(p);
+                where = STATE_VALUE;
+                break;
+
+            case STATE_VALUE:
+                if (is_blank(temp_char))
+                {
+                    this->get_char(p);
+                    break;
+                }
+                if (!this->begin_value(p))
+                    return false;
+                break;
+
+            case STATE_STRING:
+                if (this->parse_string(p, end) && !this->end_value(handler->on_string(token)))
+                    return false;
+                break;
+
+            case STATE_NUMBER:
+                if (this->parse_number(p, end) && !this->end_value(handler->on_number(token)))
+                    return false;
+                break;
+
+            case STATE_LITERAL:
+                //as many characters as the literal, then it is checked
+                this->get_char(p);
+                if (literal.next(temp_char))
+                {
+                    if (!literal.matched())
+                        return this->fail(literal.get_error());
+                    const char *text = literal.get_text();
+                    if (!this->end_value(text[0] == 'n' ? handler->on_null() : handler->on_bool(text[0] == 't')))
+                        return false;
+                }
+                break;
+
+            case STATE_END:
+            default:
+                //after the json should be only blank characters
+                if (!is_blank(temp_char))
+                    return this->fail(EXTRA_CONTENT_AFTER_JSON);
+                this->get_char(p);
+                break;
+            }
+        }
+        return !parse_result.failed;
+    }
+
+    // begin_value
+    bool json_push_parser::begin_value(const char *&p)
+    {
+        char temp_char = *p;
+        expect_value = false;
+        switch (temp_char)
+        {
+        //only strings begin with a quotation
+        case '\"':
+            // escape the quotation
+            this->get_char(p);
+            token.clear();
+            escape_state = ESCAPE_NONE;
+            where = STATE_STRING;
+            break;
+
+        //numbers
+        case '+':
+        case '-':
+        case '0':
+        case '1':
+        case '2':
+        case '3':
+        case '4':
+        case '5':
+        case '6':
+        case '7':
+        case '8':
+        case '9':
+            token.clear();
+            number = json_parser::number_syntax();
+            where = STATE_NUMBER;
+            break;
+
+        // true, false and null
+        case 't':
+        case 'f':
+        case 'n':
+            literal = json_parser::literal_syntax(temp_char);
+            where = STATE_LITERAL;
+            break;
+
+        // go into the object or array
+        case '{':
+        case '[':
+            // escape the { or [
+            this->get_char(p);
+            stack.push_back(temp_char == '{');
+            if (max_depth && stack.size() > max_depth)
+                return this->fail(TOO_DEEP_NESTING);
+            expect_value = true;
+            first = true;
+            where = STATE_ELEMENT;
+            return temp_char == '{' ? handler->on_start_object() : handler->on_start_array();
+
+        // empty value
+        case ',':
+            return this->fail(stack.back() ? INVALID_CHARACTER : EMPTY_VALUE);
+            break;
+
+        default:
+            return this->fail(INVALID_CHARACTER);
+            break;
+        }
+        return true;
+    }
+
+    // end_value
+    bool json_push_parser::end_value(bool go_on)
+    {
+        where = STATE_ELEMENT;
+        return go_on;
+    }
+
+    // parse_string
+    bool json_push_parser::parse_string(const char *&p, const char *end)
+    {
+        while (p < end && !parse_result.failed)
+        {
+            if (escape_state != ESCAPE_NONE)
+            {
+                if (this->parse_escape(p))
+                    this->get_char(p);
+                continue;
+            }
+
+            // copy the characters before the next '"', '\\' or control character at once
+            const char *span = p;
+            p = find_quote_or_escape(p, end);
+            token.append(span, p - span);
+            pos_in_line += (int)(p - span);
+            offset += p - span;
+            if (p == end)  //the string goes on in the next chunk
+                break;
+
+            char temp_char = *p;
+            this->get_char(p);
+
+            //The end of the string
+            if (temp_char == '\"')
+                return true;
+
+            //The escape characters
+            if (temp_char == '\\')
+                escape_state = ESCAPE_BEGIN;
+            else  //control characters must be escaped
+                return this->fail(INVALID_CHARACTER);
+        }
+        return false;
+    }
+
+    // parse_escape
+    bool json_push_parser::parse_escape(const char *&p)
+    {
+        char c = *p;
+        switch (escape_state)
+        {
+        case ESCAPE_BEGIN:
+            escape_state = ESCAPE_NONE;
+            switch (c)
+            {
+            case '\"':
+            case '\\':
+            case '/':
+                token += c;
+                break;
+            case 'b':
+                token += '\b';
+                break;
+            case 'f':
+                token += '\f';
+                break;
+            case 'n':
+                token += '\n';
+                break;
+            case 'r':
+                token += '\r';
+                break;
+            case 't':
+                token += '\t';
+                break;
+            case 'u':
+                escape_state = ESCAPE_HEX;
+                hex_count = 0;
+                code = 0;
+                break;
+            default:
+                this->get_char(p);
+                return this->fail(INVALID_ESCAPE_CHARACTER);
+                break;
+            }
+            return true;
+
+        case ESCAPE_HEX:
+        case ESCAPE_LOW_HEX:
+            {
+                int digit = hex_digit(c);
+                if (digit < 0)
+                {
+                    this->get_char(p);
+                    return this->fail(INVALID_ESCAPE_CHARACTER);
+                }
+                code = (code << 4) | digit;
+                if (++hex_count < 4)
+                    return true;
+
+                if (escape_state == ESCAPE_HEX && code >= 0xD800 && code <= 0xDBFF)
+                {
+                    //the high surrogate of a pair
+                    high = code;
+                    escape_state = ESCAPE_SURROGATE;
+                    return true;
+                }
+                if (escape_state == ESCAPE_LOW_HEX)
+                {
+                    if (code >= 0xDC00 && code <= 0xDFFF)
+                        code = 0x10000 + ((high - 0xD800) << 10) + (code - 0xDC00);
+                    else
+                        append_utf8(token, REPLACEMENT_CHARACTER);
+                }
+                // a lone surrogate can not be encoded in UTF-8
+                if (code >= 0xD800 && code <= 0xDFFF)
+                    code = REPLACEMENT_CHARACTER;
+                append_utf8(token, code);
+                escape_state = ESCAPE_NONE;
+            }
+            return true;
+
+        case ESCAPE_SURROGATE:
+            if (c != '\\')  //the character goes on in the string
+            {
+                append_utf8(token, REPLACEMENT_CHARACTER);
+                escape_state = ESCAPE_NONE;
+                return false;
+            }
+            escape_state = ESCAPE_LOW_BEGIN;
+            return true;
+
+        case ESCAPE_LOW_BEGIN:
+            if (c != 'u')  //another escape character
+            {
+                append_utf8(token, REPLACEMENT_CHARACTER);
+                escape_state = ESCAPE_BEGIN;
+                return this->parse_escape(p);
+            }
+            escape_state = ESCAPE_LOW_HEX;
+            hex_count = 0;
+            code = 0;
+            return true;
+
+        case ESCAPE_NONE:
+        default:
+            return false;
+        }
+    }
+
+    // parse_number
+    bool json_push_parser::parse_number(const char *&p, const char *end)
+    {
+        while (p < end)
+        {
+            //',', ']', '}', blank characters and '\0' end a number, a '\0' is
+            //left to the caller like json_parser::parse_number
+            char temp_char = *p;
+            if (json_parser::number_syntax::is_end(temp_char))
+            {
+                if (temp_char != '\0' && !number.has_digits())  //number has no digits
+                    return this->fail(MISSING_DIGIT);
+                return true;
+            }
+
+            json_parse_error error_type;
+            if (!number.next(temp_char, error_type))
+                return this->fail(error_type);
+            token += temp_char;
+            this->get_char(p);
+        }
+        return false;
+    }
+
+    // get_char
+    void json_push_parser::get_char(const char *&p)
+    {
+        offset++;
+        pos_in_line++;
+        if (*p++ == '\n')
+        {
+            line++;
+            pos_in_line = 1;
+        }
+    }
+
+    // fail
+    bool json_push_parser::fail(json_parse_error error_type)
+    {
+        if (!parse_result.failed)  //the first error is kept
+        {
+            parse_result.failed = true;
+            parse_result.error = error_type;
+            parse_result.offset = offset;
+            parse_result.line = line;
+            parse_result.column = pos_in_line;
+        }
+        return false;
+    }
+
+    // stop_on_error
+    json_push_status json_push_parser::stop_on_error()
+    {
+        if (root && !root->get_arena())  //extra content after the json
+            delete root;
+        root = NULL;
+        if (builder)
+        {
+            builder->discard();
+            delete builder;
+            builder = NULL;
+            handler = NULL;
+        }
+        return status = PUSH_ERROR;
+    }
+}
@@ -0,0 +1,287 @@
+///////////////////////////////////////////////////////////////////////////////
+///  Copyright 2012 Garnel
+///
+///  Licensed under the Apache License, Version 2.0 (the "License");
+///  you may not use this file except in compliance with the License.
+///  You may obtain a copy of the License at
+///
+///    http://www.apache.org/licenses/LICENSE-2.0
+///
+///  Unless required by applicable law or agreed to in writing, software
+///  distributed under the License is distributed on an "AS IS" BASIS,
+///  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///////////////////////////////////////////////////////////////////////////////
+
+///
+/// \file       json_push.h
+/// The declaration of json_push_parser, parsing json fed in chunks
+/// \author     Garnel
+/// \date       2026/10/15
+/// \version    2.3
+/// \copyright  Apache License, Version 2.0
+///
+
+#ifndef JSON_LITE_PUSH
+#define JSON_LITE_PUSH
+
+#include <string>
+#include <vector>
+
+#include "json_lite.h"
+
+namespace json_lite
+{
+    ///
+    /// \enum   json_push_status
+    /// \brief  The result of json_push_parser::feed and finish
+    ///
+    enum json_push_status
+    {
+        PUSH_NEED_MORE,         ///< the json is not complete, feed more
+        PUSH_DONE,              ///< the json is complete
+        PUSH_STOPPED,           ///< the handler stopped the parse
+        PUSH_ERROR              ///< an error in the json, see json_push_parser::get_result
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// json_push_parser
+    ///////////////////////////////////////////////////////////////////////////
+
+    ///
+    /// \class  json_push_parser
+    /// \brief  Parse a json fed in chunks of any size, as they arrive
+    ///
+    /// The caller pushes the text with feed() instead of the parser reading
+    /// it, and never blocks: a chunk ending in the middle of a string, a
+    /// number or true, false and null is kept and goes on with the next one.
+    /// finish() tells the end of input.
+    ///
+    /// The grammar and the errors are those of json_parser::run(), the numbers
+    /// and the literals are checked by the same json_parser::number_syntax and
+    /// json_parser::literal_syntax. The json is reported to a json_handler, or
+    /// built into a tree, see release_root. An error is given back by
+    /// get_result, nothing is printed or thrown.
+    ///
+    class json_push_parser
+    {
+    public:
+        ///
+        /// \fn         json_push_parser
+        /// \brief      A parser building the json tree, see release_root
+        ///
+        json_push_parser();
+
+        ///
+        /// \overload   json_push_parser(json_handler &_handler)
+        /// \brief      A parser reporting the json to a handler, without a tree
+        /// \param      _handler    The receiver of the events of the json
+        ///
+        json_push_parser(json_handler &_handler);
+
+        ///
+        /// \fn         ~json_push_parser
+        /// \brief      Free the tree of a json not complete or not released
+        ///
+        ~json_push_parser();
+
+        ///
+        /// \fn         feed
+        /// \brief      Parse the next chunk of the json text
+        /// \param      data    The chunk, not needed after the call
+        /// \param      length  The length of the chunk
+        /// \return     PUSH_NEED_MORE until the json is complete, then PUSH_DONE.
+        ///             After an error or a stop, the same status is returned.
+        ///
+        json_push_status feed(const char *data, size_t length);
+
+        ///
+        /// \fn         finish
+        /// \brief      Tell the end of input
+        /// \return     PUSH_DONE if the json is complete, otherwise PUSH_ERROR with
+        ///             the error of an unexpected end, see get_result
+        ///
+        json_push_status finish();
+
+        ///
+        /// \fn         reset
+        /// \brief      Start over for another json, freeing the tree not released
+        ///
+        void reset();
+
+        ///
+        /// \fn         get_status
+        /// \brief      Return the status of the last feed or finish
+        ///
+        json_push_status get_status() const;
+
+        ///
+        /// \fn         get_result
+        /// \brief      Return the error and its position after PUSH_ERROR
+        /// \note       The error and its position are those json_parser::run gives
+        ///             for the whole text, counted from the first character fed
+        ///             since the construction or reset()
+        ///
+        const json_parse_result& get_result() const;
+
+        ///
+        /// \fn         release_root
+        /// \brief      Return the tree of a complete json, which the caller frees
+        /// \return     The json element parsed, NULL if the json is not complete,
+        ///             already released or reported to a handler
+        ///
+        json_value* release_root();
+
+        ///
+        /// \fn         set_max_depth
+        /// \brief      Limit how deeply objects and arrays can be nested, see json_parser::set_max_depth
+        ///
+        void set_max_depth(size_t depth);
+
+        ///
+        /// \fn         set_arena
+        /// \brief      Allocate the tree from an arena, see json_parser::set_arena
+        ///
+        void set_arena(json_arena *_arena);
+
+        ///
+        /// \fn         set_key_table
+        /// \brief      Intern the labels of the tree, see json_parser::set_key_table
+        ///
+        void set_key_table(json_key_table *_key_table);
+
+        ///
+        /// \fn         set_keep_number_text
+        /// \brief      Keep the text of the numbers of the tree, see json_parser::set_keep_number_text
+        ///
+        void set_keep_number_text(bool keep);
+
+    private:
+        json_push_parser(const json_push_parser&);              ///< copy is not allowed
+        json_push_parser& operator=(const json_push_parser&);   ///< copy is not allowed
+
+        ///
+        /// \fn         parse
+        /// \brief      Parse the characters of a chunk
+        /// \return     false if the handler stops the parse
+        ///
+        bool parse(const char *p, const char *end);
+
+        ///
+        /// \fn         begin_value
+        /// \brief      Begin a value with its first character, not escaped yet
+        /// \param      p       The first character of the value
+        /// \return     false if the handler stops the parse
+        ///
+        bool begin_value(const char *&p);
+
+        ///
+        /// \fn         end_value
+        /// \brief      A string, number, true, false or null is parsed
+        /// \return     false if the handler stops the parse
+        ///
+        bool end_value(bool go_on);
+
+        ///
+        /// \fn         parse_string
+        /// \brief      Parse the characters of a string in the chunk
+        /// \note       Errors are recorded, see json_parser::parse_string
+        /// \return     true if the right quotation is escaped
+        ///
+        bool parse_string(const char *&p, const char *end);
+
+        ///
+        /// \fn         parse_escape
+        /// \brief      Parse a character of an escape character
+        /// \note       INVALID_ESCAPE_CHARACTER is recorded
+        /// \return     false if the character is not part of the escape and goes on in
+        ///             the string, or for an error
+        ///
+        bool parse_escape(const char *&p);
+
+        ///
+        /// \fn         parse_number
+        /// \brief      Parse the characters of a number in the chunk
+        /// \note       Errors are recorded, see json_parser::parse_number
+        /// \return     true if the number ends before the end of the chunk
+        ///
+        bool parse_number(const char *&p, const char *end);
+
+        ///
+        /// \fn         get_char
+        /// \brief      Escape a character, counting the line and the position
+        ///
+        void get_char(const char *&p);
+
+        ///
+        /// \fn         fail
+        /// \brief      Record an error at the cursor, unless one is recorded
+        /// \return     false, to be returned by the step failing
+        ///
+        bool fail(json_parse_error error_type);
+
+        ///
+        /// \fn         stop_on_error
+        /// \brief      Free the tree of the json with an error and stop the parser
+        /// \return     PUSH_ERROR
+        ///
+        json_push_status stop_on_error();
+
+    private:
+        ///
+        /// \enum   state
+        /// \brief  Where the parser is in the json
+        ///
+        enum state
+        {
+            STATE_START,        ///< before the '{' or '[' of the root
+            STATE_ELEMENT,      ///< ',', the end, or the next pair or element
+            STATE_KEY,          ///< in the label of a pair
+            STATE_COLON,        ///< the ':' after a label
+            STATE_VALUE,        ///< the value after ':'
+            STATE_STRING,       ///< in a string
+            STATE_NUMBER,       ///< in a number
+            STATE_LITERAL,      ///< in true, false or null
+            STATE_END           ///< after the root, only blank characters
+        };
+
+        ///
+        /// \enum   escape
+        /// \brief  Where the parser is in an escape character of a string
+        ///
+        enum escape
+        {
+            ESCAPE_NONE,        ///< not in an escape character
+            ESCAPE_BEGIN,       ///< after '\\'
+            ESCAPE_HEX,         ///< in the 4 hex digits of \\uXXXX
+            ESCAPE_SURROGATE,   ///< after a high surrogate, '\\' of the low one expected
+            ESCAPE_LOW_BEGIN,   ///< after '\\' of the low surrogate, 'u' expected
+            ESCAPE_LOW_HEX      ///< in the 4 hex digits of the low surrogate
+        };
+
+        json_handler *handler;          ///< the receiver of the events
+        json_parser *tree_parser;       ///< the parser for the arena and key table of the tree, or NULL
+        json_parser::tree_builder *builder;     ///< the builder of the tree, or NULL
+        json_value *root;               ///< the tree of a complete json not released yet
+        json_push_status status;        ///< the status of the last feed or finish
+        state where;                    ///< where the parser is in the json
+        std::vector<bool> stack;        ///< the open objects and arrays, true for objects
+        bool expect_value;              ///< a value (or a pair in an object) is expected
+        bool first;                     ///< nothing is in the current object or array yet
+        std::string token;              ///< the string or number parsed so far
+        json_parser::literal_syntax literal;    ///< the true, false or null parsed
+        escape escape_state;            ///< where the parser is in an escape character
+        int hex_count;                  ///< the hex digits parsed of \\uXXXX
+        unsigned int code;              ///< the code of \\uXXXX parsed so far
+        unsigned int high;              ///< the high surrogate waiting for the low one
+        json_parser::number_syntax number;      ///< the syntax of the number parsed
+        size_t max_depth;               ///< the max depth of nesting, 0 for no limit
+        int line;                       ///< the line number
+        int pos_in_line;                ///< the position in current line
+        size_t offset;                  ///< the characters fed before the cursor
+        json_parse_result parse_result; ///< the error, if the status is PUSH_ERROR
+    };
+}
+
+#endif // JSON_LITE_PUSH
@@ -0,0 +1,317 @@
+///////////////////////////////////////////////////////////////////////////////
+///  Copyright 2012 Garnel
+///
+///  Licensed under the Apache License, Version 2.0 (the "License");
+///  you may not use this file except in compliance with the License.
+///  You may obtain a copy of the License at
+///
+///    http://www.apache.org/licenses/LICENSE-2.0
+///
+///  Unless required by applicable law or agreed to in writing, software
+///  distributed under the License is distributed on an "AS IS" BASIS,
+///  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///////////////////////////////////////////////////////////////////////////////
+
+///
+/// \file       json_reader.cpp
+/// The implementation of class json_reader
+/// \author     Garnel
+/// \date       2026/10/15
+/// \version    2.3
+/// \copyright  Apache License, Version 2.0
+///
+
+#include "json_reader.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <thread>
+
+#include <fcntl.h>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+///
+/// \namespace  json_lite
+///
+namespace json_lite
+{
+    const size_t NO_BLOCK = 2;      ///< no block is held by the parser
+
+    ///
+    /// \struct     read_ahead_state
+    /// \brief      The thread reading ahead and the blocks it shares with the parser
+    ///
+    struct read_ahead_state
+    {
+        read_ahead_state()
+            :held(NO_BLOCK),
+             stop(false)
+        {
+            lengths[0] = lengths[1] = 0;
+            ready[0] = ready[1] = false;
+        }
+
+        std::thread worker;                 ///< the thread
+        std::mutex mutex;                   ///< guards everything below
+        std::condition_variable filled;     ///< a block is read
+        std::condition_variable freed;      ///< a block is given back, or the reader stops
+        size_t lengths[2];                  ///< the lengths of the blocks read
+        bool ready[2];                      ///< if the block is read and not returned yet
+        size_t held;                        ///< the block returned to the parser, or NO_BLOCK
+        bool stop;                          ///< if the reader is destroyed
+    };
+
+    // json_reader
+    json_reader::json_reader(const std::string &file_name, size_t _block_size, bool _read_ahead)
+        :fd(-1),
+         block_size(_block_size ? _block_size : READ_BLOCK_SIZE),
+         next(0),
+         end(false),
+         good(true),
+         state(NULL),
+         compression(COMPRESS_NONE),
+         decoder(NULL),
+         input_pos(0),
+         input_end(false)
+    {
+#ifdef _WIN32
+        fd = ::_open(file_name.c_str(), _O_RDONLY | _O_BINARY);
+#else
+        fd = ::open(file_name.c_str(), O_RDONLY);
+#endif
+        if (fd < 0)
+        {
+            throw "The file cannot be opened!";
+        }
+#ifdef POSIX_FADV_SEQUENTIAL
+        posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+
+        // the magic bytes, kept in input for the first block
+        char magic[4];
+        input.assign(magic, magic + this->read_file(magic, sizeof(magic)));
+        compression = detect_compression(input.empty() ? magic : &input[0], input.size());
+        if (compression != COMPRESS_NONE)
+        {
+            decoder = json_decoder::create(compression);
+            if (!decoder)
+            {
+#ifdef _WIN32
+                ::_close(fd);
+#else
+                ::close(fd);
+#endif
+                throw "The compression of the file is not supported!";
+            }
+        }
+
+        blocks[0].resize(block_size);
+        if (_read_ahead)
+        {
+            blocks[1].resize(block_size);
+            state = new read_ahead_state;
+            state->worker = std::thread(&json_reader::read_ahead, this);
+        }
+    }
+
+    // ~json_reader
+    json_reader::~json_reader()
+    {
+        if (state)
+        {
+            {
+                std::lock_guard<std::mutex> lock(state->mutex);
+                state->stop = true;
+            }
+            state->freed.notify_all();
+            state->worker.join();
+            delete state;
+        }
+        delete decoder;
+#ifdef _WIN32
+        ::_close(fd);
+#else
+        ::close(fd);
+#endif
+    }
+
+    // next_block
+    size_t json_reader::next_block(const char *&data)
+    {
+        if (!state)
+        {
+            if (end)
+                return 0;
+            size_t length = this->read_block(0);
+            end = length < block_size;
+            data = &blocks[0][0];
+            return length;
+        }
+
+        std::unique_lock<std::mutex> lock(state->mutex);
+        if (state->held != NO_BLOCK)  //give back the previous block to the thread
+        {
+            state->held = NO_BLOCK;
+            state->freed.notify_one();
+        }
+        if (end)
+            return 0;
+
+        while (!state->ready[next])
+            state->filled.wait(lock);
+        size_t length = state->lengths[next];
+        state->ready[next] = false;
+        state->held = next;
+        end = length < block_size;
+        data = &blocks[next][0];
+        next ^= 1;
+        return length;
+    }
+
+    // get_block_size
+    size_t json_reader::get_block_size() const
+    {
+        return block_size;
+    }
+
+    // get_compression
+    json_compression json_reader::get_compression() const
+    {
+        return compression;
+    }
+
+    // is_good
+    bool json_reader::is_good() const
+    {
+        if (!state)
+            return good;
+        std::lock_guard<std::mutex> lock(state->mutex);
+        return good;
+    }
+
+    // read_block
+    size_t json_reader::read_block(size_t i)
+    {
+        char *data = &blocks[i][0];
+        if (decoder)
+            return this->decode_block(data);
+
+        // the magic bytes come first
+        size_t length = std::min(input.size() - input_pos, block_size);
+        if (length)
+            memcpy(data, &input[input_pos], length);
+        input_pos += length;
+        return length + this->read_file(data + length, block_size - length);
+    }
+
+    // read_file
+    size_t json_reader::read_file(char *data, size_t length)
+    {
+        size_t done = 0;
+        while (done < length)
+        {
+#ifdef _WIN32
+            int count = ::_read(fd, data + done, (unsigned int)(length - done));
+#else
+            ssize_t count = ::read(fd, data + done, length - done);
+#endif
+            if (count < 0 && errno == EINTR)
+                continue;
+            if (count < 0)
+                this->set_failed();
+            if (count <= 0)
+                break;
+            done += count;
+        }
+        return done;
+    }
+
+    // decode_block
+    size_t json_reader::decode_block(char *data)
+    {
+        char *out = data,
+             *out_end = data + block_size;
+        while (out < out_end)
+        {
+            if (input_pos == input.size())
+            {
+                if (input_end)
+                    break;
+                input.resize(COMPRESSED_BLOCK_SIZE);
+                input.resize(this->read_file(&input[0], input.size()));
+                input_pos = 0;
+                input_end = input.size() < COMPRESSED_BLOCK_SIZE;
+                continue;
+            }
+
+            const char *in = &input[0] + input_pos,
+                       *in_end = &input[0] + input.size();
+            char *before = out;
+            if (!decoder->decode(in, in_end, out, out_end))
+            {
+                this->set_failed();  //corrupt
+                break;
+            }
+            bool progress = in != &input[0] + input_pos || out != before;
+            input_pos = in - &input[0];
+            if (!progress && input_pos < input.size())  //input left that goes nowhere
+            {
+                this->set_failed();
+                break;
+            }
+        }
+
+        // the file ends in the middle of a member or frame
+        if (out < out_end && input_end && input_pos == input.size() && !decoder->is_end())
+            this->set_failed();
+        return out - data;
+    }
+
+    // read_ahead
+    void json_reader::read_ahead()
+    {
+        for (size_t i = 0; ; i ^= 1)
+        {
+            {
+                // wait until the block is neither waiting to be parsed nor being parsed
+                std::unique_lock<std::mutex> lock(state->mutex);
+                while (!state->stop && (state->ready[i] || state->held == i))
+                    state->freed.wait(lock);
+                if (state->stop)
+                    return;
+            }
+
+            size_t length = this->read_block(i);
+            {
+                std::lock_guard<std::mutex> lock(state->mutex);
+                state->lengths[i] = length;
+                state->ready[i] = true;
+            }
+            state->filled.notify_one();
+
+            if (length < block_size)  //the end of the file
+                return;
+        }
+    }
+
+    // set_failed
+    void json_reader::set_failed()
+    {
+        if (state)
+        {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            good = false;
+        }
+        else
+            good = false;
+    }
+}
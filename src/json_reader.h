@@ -0,0 +1,160 @@
+///////////////////////////////////////////////////////////////////////////////
+///  Copyright 2012 Garnel
+///
+///  Licensed under the Apache License, Version 2.0 (the "License");
+///  you may not use this file except in compliance with the License.
+///  You may obtain a copy of the License at
+///
+///    http://www.apache.org/licenses/LICENSE-2.0
+///
+///  Unless required by applicable law or agreed to in writing, software
+///  distributed under the License is distributed on an "AS IS" BASIS,
+///  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///////////////////////////////////////////////////////////////////////////////
+
+///
+/// \file       json_reader.h
+/// The declaration of json_reader, reading a file ahead of json_parser
+/// \author     Garnel
+/// \date       2026/10/15
+/// \version    2.3
+/// \copyright  Apache License, Version 2.0
+///
+
+#ifndef JSON_LITE_READER
+#define JSON_LITE_READER
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "json_compress.h"
+
+namespace json_lite
+{
+    const size_t READ_BLOCK_SIZE = 1024 * 1024;         ///< the default size of a block
+    const size_t COMPRESSED_BLOCK_SIZE = 256 * 1024;    ///< the size of each read of a compressed file
+
+    struct read_ahead_state;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// json_reader
+    ///////////////////////////////////////////////////////////////////////////
+
+    ///
+    /// \class  json_reader
+    /// \brief  Read a file in large blocks, the next block ahead on a thread
+    ///
+    /// There are two blocks: while json_parser parses one, a thread reads
+    /// the file into the other, so the parse waits for the disk only when
+    /// the disk is slower than the parse. The file is read sequentially,
+    /// which is told to the kernel by posix_fadvise where it exists.
+    ///
+    /// A file compressed with gzip or zstd is told by its magic bytes and
+    /// decompressed into the blocks, on the thread reading ahead, so the
+    /// decompression goes on while the parse does. See json_compress.h for
+    /// the libraries compiled in.
+    ///
+    /// \note   See json_parser(json_reader &_reader)
+    ///
+    class json_reader
+    {
+    public:
+        ///
+        /// \fn         json_reader
+        /// \brief      The constructor of json_reader
+        /// \param      file_name       The json file name
+        /// \param      _block_size     The size of each block, default value is READ_BLOCK_SIZE
+        /// \param      _read_ahead     Read the next block on a thread, otherwise when it is needed
+        /// \exception  char*           If the file cannot be opened, or its compression
+        ///                             is not supported, throw a message
+        ///
+        json_reader(const std::string &file_name, size_t _block_size = READ_BLOCK_SIZE, bool _read_ahead = true);
+
+        ///
+        /// \fn         ~json_reader
+        /// \brief      Stop the thread and close the file
+        ///
+        ~json_reader();
+
+        ///
+        /// \fn         next_block
+        /// \brief      Return the next block of the file, giving back the previous one
+        /// \param      data    The first character of the block
+        /// \warning    The block is valid until the next call
+        /// \return     The length of the block, 0 at the end of the file
+        ///
+        size_t next_block(const char *&data);
+
+        ///
+        /// \fn         get_block_size
+        /// \brief      Return the size of each block
+        ///
+        size_t get_block_size() const;
+
+        ///
+        /// \fn         get_compression
+        /// \brief      Return the compression of the file
+        ///
+        json_compression get_compression() const;
+
+        ///
+        /// \fn         is_good
+        /// \brief      If no read has failed, and a compressed file is neither corrupt nor truncated
+        ///
+        bool is_good() const;
+
+    private:
+        json_reader(const json_reader&);                ///< copy is not allowed
+        json_reader& operator=(const json_reader&);     ///< copy is not allowed
+
+        ///
+        /// \fn         read_block
+        /// \brief      Read the file into a block, as full as the file allows
+        /// \return     The length read, less than the block size at the end of the file
+        ///
+        size_t read_block(size_t i);
+
+        ///
+        /// \fn         read_file
+        /// \brief      Read the file as much as the length, unless it ends
+        ///
+        size_t read_file(char *data, size_t length);
+
+        ///
+        /// \fn         decode_block
+        /// \brief      Decompress the file into a block, as full as the file allows
+        ///
+        size_t decode_block(char *data);
+
+        ///
+        /// \fn         read_ahead
+        /// \brief      The thread reading the blocks in turn
+        ///
+        void read_ahead();
+
+        ///
+        /// \fn         set_failed
+        /// \brief      Record a failed read or a corrupt file
+        ///
+        void set_failed();
+
+    private:
+        int fd;                         ///< the file descriptor of the json file
+        size_t block_size;              ///< the size of each block
+        std::vector<char> blocks[2];    ///< the blocks, parsed and read in turn
+        size_t next;                    ///< the block to return next
+        bool end;                       ///< if the last block is returned
+        bool good;                      ///< if no read has failed
+        read_ahead_state *state;        ///< the thread reading ahead, NULL to read when needed
+        json_compression compression;   ///< the compression of the file
+        json_decoder *decoder;          ///< the decoder of a compressed file, or NULL
+        std::vector<char> input;        ///< the bytes read from the file and not used yet
+        size_t input_pos;               ///< the first byte of input not used yet
+        bool input_end;                 ///< if the whole file is read into input
+    };
+}
+
+#endif // JSON_LITE_READER
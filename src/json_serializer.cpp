@@ -0,0 +1,415 @@
+///////////////////////////////////////////////////////////////////////////////
+///  Copyright 2012 Garnel
+///
+///  Licensed under the Apache License, Version 2.0 (the "License");
+///  you may not use this file except in compliance with the License.
+///  You may obtain a copy of the License at
+///
+///    http://www.apache.org/licenses/LICENSE-2.0
+///
+///  Unless required by applicable law or agreed to in writing, software
+///  distributed under the License is distributed on an "AS IS" BASIS,
+///  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///////////////////////////////////////////////////////////////////////////////
+
+///
+/// \file       json_serializer.cpp
+/// The implementation of class json_buffer and json_serializer
+/// \author     Garnel
+/// \date       2026/10/15
+/// \version    2.3
+/// \copyright  Apache License, Version 2.0
+///
+
+#include "json_serializer.h"
+#include "json_index.h"
+
+#include <cerrno>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+///
+/// \namespace  json_lite
+///
+namespace json_lite
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // json_format
+    ///////////////////////////////////////////////////////////////////////////
+
+    // json_format
+    json_format::json_format(bool _pretty, char _indent_char, int _indent_width)
+        :pretty(_pretty),
+         indent_char(_indent_char),
+         indent_width(_indent_width)
+    {
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    // json_buffer
+    ///////////////////////////////////////////////////////////////////////////
+
+    // json_buffer
+    json_buffer::json_buffer()
+        :stream(NULL),
+         fd(-1),
+         good(true),
+         compression(COMPRESS_NONE),
+         encoder(NULL),
+         finished(false)
+    {
+    }
+
+    json_buffer::json_buffer(std::ostream &_stream, json_compression _compression, int level)
+        :stream(&_stream),
+         fd(-1),
+         good(true),
+         compression(_compression),
+         encoder(NULL),
+         finished(false)
+    {
+        data.reserve(OUTPUT_BUFFER_SIZE);
+        if (compression != COMPRESS_NONE)
+        {
+            encoder = json_encoder::create(compression, level);
+            good = encoder && encoder->is_good();
+        }
+    }
+
+    json_buffer::json_buffer(int _fd, json_compression _compression, int level)
+        :stream(NULL),
+         fd(_fd),
+         good(true),
+         compression(_compression),
+         encoder(NULL),
+         finished(false)
+    {
+        data.reserve(OUTPUT_BUFFER_SIZE);
+        if (compression != COMPRESS_NONE)
+        {
+            encoder = json_encoder::create(compression, level);
+            good = encoder && encoder->is_good();
+        }
+    }
+
+    // ~json_buffer
+    json_buffer::~json_buffer()
+    {
+        this->finish();
+        delete encoder;
+    }
+
+    // put
+    void json_buffer::put(char c)
+    {
+        data += c;
+        if (data.size() >= OUTPUT_BUFFER_SIZE && (stream || fd >= 0))
+            this->write_out(ENCODE_NONE);
+    }
+
+    // write
+    void json_buffer::write(const char *str, size_t length)
+    {
+        data.append(str, length);
+        if (data.size() >= OUTPUT_BUFFER_SIZE && (stream || fd >= 0))
+            this->write_out(ENCODE_NONE);
+    }
+
+    // fill
+    void json_buffer::fill(char c, size_t count)
+    {
+        data.append(count, c);
+        if (data.size() >= OUTPUT_BUFFER_SIZE && (stream || fd >= 0))
+            this->write_out(ENCODE_NONE);
+    }
+
+    // write_escaped
+    void json_buffer::write_escaped(const char *str, size_t length)
+    {
+        static const char hex[] = "0123456789abcdef";
+        const char *p = str,
+                   *end = str + length;
+        while (p < end)
+        {
+            const char *span = p;
+            p = find_quote_or_escape(p, end);
+            data.append(span, p - span);
+            if (p == end)
+                break;
+
+            char escaped[6] = {'\\', *p, 0, 0, 0, 0};
+            size_t escaped_length = 2;
+            switch (*p)
+            {
+            case '\"':
+            case '\\':
+                break;
+            case '\b':
+                escaped[1] = 'b';
+                break;
+            case '\f':
+                escaped[1] = 'f';
+                break;
+            case '\n':
+                escaped[1] = 'n';
+                break;
+            case '\r':
+                escaped[1] = 'r';
+                break;
+            case '\t':
+                escaped[1] = 't';
+                break;
+            default:
+                escaped[1] = 'u';
+                escaped[2] = '0';
+                escaped[3] = '0';
+                escaped[4] = hex[(*p >> 4) & 0xF];
+                escaped[5] = hex[*p & 0xF];
+                escaped_length = 6;
+                break;
+            }
+            data.append(escaped, escaped_length);
+            p++;
+        }
+        if (data.size() >= OUTPUT_BUFFER_SIZE && (stream || fd >= 0))
+            this->write_out(ENCODE_NONE);
+    }
+
+    // flush
+    bool json_buffer::flush()
+    {
+        if (this->write_out(ENCODE_FLUSH) && stream && !stream->flush())
+            good = false;
+        return good;
+    }
+
+    // finish
+    bool json_buffer::finish()
+    {
+        if (this->write_out(ENCODE_END) && stream && !stream->flush())
+            good = false;
+        return good;
+    }
+
+    // get_string
+    const std::string& json_buffer::get_string() const
+    {
+        return data;
+    }
+
+    // clear
+    void json_buffer::clear()
+    {
+        data.clear();
+    }
+
+    // is_good
+    bool json_buffer::is_good() const
+    {
+        return good;
+    }
+
+    // write_out
+    bool json_buffer::write_out(json_encode_mode mode)
+    {
+        if (!stream && fd < 0)
+            return good;
+        if (compression == COMPRESS_NONE)
+        {
+            this->write_raw(data.data(), data.size());
+            data.clear();
+            return good;
+        }
+
+        if (!encoder || finished)  //not supported, or written after finish
+        {
+            good = good && data.empty();
+            data.clear();
+            return good;
+        }
+        if (data.empty() && mode == ENCODE_NONE)
+            return good;
+
+        // compress into packed, written each time it is full
+        packed.resize(OUTPUT_BUFFER_SIZE);
+        const char *in = data.data(),
+                   *in_end = in + data.size();
+        for (bool done = false; !done && encoder->is_good(); )
+        {
+            char *out = &packed[0];
+            done = encoder->encode(in, in_end, out, &packed[0] + packed.size(), mode);
+            this->write_raw(packed.data(), out - &packed[0]);
+        }
+        if (!encoder->is_good())
+            good = false;
+        finished = mode == ENCODE_END;
+        data.clear();
+        return good;
+    }
+
+    // write_raw
+    void json_buffer::write_raw(const char *bytes, size_t length)
+    {
+        if (stream)
+        {
+            if (length && !stream->write(bytes, length))
+                good = false;
+            return;
+        }
+
+        const char *p = bytes,
+                   *end = bytes + length;
+        while (p < end)
+        {
+#ifdef _WIN32
+            int written = ::_write(fd, p, (unsigned int)(end - p));
+#else
+            ssize_t written = ::write(fd, p, end - p);
+#endif
+            if (written < 0 && errno == EINTR)
+                continue;
+            if (written <= 0)
+            {
+                good = false;
+                break;
+            }
+            p += written;
+        }
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    // json_serializer
+    ///////////////////////////////////////////////////////////////////////////
+
+    // json_serializer
+    json_serializer::json_serializer(json_buffer &_out, const json_format &_format)
+        :out(_out),
+         format(_format)
+    {
+    }
+
+    // write
+    void json_serializer::write(const json_value *value, int indent_level)
+    {
+        assert(value);
+        const json_value *cur = value;
+        int level = indent_level;
+        bool indent = true;     // the element starts with its indentation
+        while (true)
+        {
+            json_type _type = cur->type;
+            if ((_type == JSON_OBJECT || _type == JSON_ARRAY) && cur->first_child)
+            {
+                // go into the object or array
+                if (indent)
+                    this->write_indent(level);
+                out.put(_type == JSON_OBJECT ? '{' : '[');
+                level++;
+                cur = cur->first_child;
+            }
+            else
+            {
+                // empty object or array will be printed directly as "{}","[]"
+                if (indent)
+                    this->write_indent(level);
+                this->write_scalar(cur);
+
+                // go up until there is a next element, closing objects and arrays
+                while (true)
+                {
+                    if (cur == value)
+                        return;
+
+                    // the value of a pair goes on with the next label
+                    const json_value *elem = cur->parent->type == JSON_STRING ? cur->parent : cur;
+                    if (elem->next)
+                    {
+                        out.put(',');
+                        cur = elem->next;
+                        break;
+                    }
+
+                    cur = elem->parent;
+                    level--;
+                    if (format.pretty)
+                    {
+                        out.put('\n');
+                        this->write_indent(level);
+                    }
+                    out.put(cur->type == JSON_OBJECT ? '}' : ']');
+                }
+            }
+
+            // cur is the next label or element in the object or array
+            if (format.pretty)
+                out.put('\n');
+            if (cur->parent->type == JSON_OBJECT)
+            {
+                // the label
+                this->write_indent(level);
+                this->write_string(cur->value, cur->value_length);
+                out.put(':');
+                if (format.pretty)
+                    out.put(' ');
+
+                // objects and arrays in a pair begin on the next line
+                cur = cur->first_child;
+                indent = (cur->type == JSON_OBJECT || cur->type == JSON_ARRAY) && cur->first_child;
+                if (indent && format.pretty)
+                    out.put('\n');
+            }
+            else
+                indent = true;
+        }
+    }
+
+    // write_indent
+    void json_serializer::write_indent(int indent_level)
+    {
+        if (format.pretty && indent_level > 0 && format.indent_width > 0)
+            out.fill(format.indent_char, (size_t)indent_level * format.indent_width);
+    }
+
+    // write_string
+    void json_serializer::write_string(const char *str, size_t length)
+    {
+        out.put('\"');
+        out.write_escaped(str, length);
+        out.put('\"');
+    }
+
+    // write_scalar
+    void json_serializer::write_scalar(const json_value *elem)
+    {
+        switch (elem->type)
+        {
+        case JSON_STRING:
+            this->write_string(elem->value, elem->value_length);
+            break;
+        case JSON_NUMBER:
+            if (elem->value_length)  //the text is kept
+                out.write(elem->value, elem->value_length);
+            else
+            {
+                std::string text = number_text(elem->number);
+                out.write(text.data(), text.size());
+            }
+            break;
+        case JSON_OBJECT:
+            out.write("{}", 2);
+            break;
+        case JSON_ARRAY:
+            out.write("[]", 2);
+            break;
+        default:  //true, false and null
+            out.write(elem->value, elem->value_length);
+            break;
+        }
+    }
+}
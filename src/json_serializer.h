@@ -0,0 +1,248 @@
+///////////////////////////////////////////////////////////////////////////////
+///  Copyright 2012 Garnel
+///
+///  Licensed under the Apache License, Version 2.0 (the "License");
+///  you may not use this file except in compliance with the License.
+///  You may obtain a copy of the License at
+///
+///    http://www.apache.org/licenses/LICENSE-2.0
+///
+///  Unless required by applicable law or agreed to in writing, software
+///  distributed under the License is distributed on an "AS IS" BASIS,
+///  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///////////////////////////////////////////////////////////////////////////////
+
+///
+/// \file       json_serializer.h
+/// The declaration of json_format, json_buffer and json_serializer
+/// \author     Garnel
+/// \date       2026/10/15
+/// \version    2.3
+/// \copyright  Apache License, Version 2.0
+///
+
+#ifndef JSON_LITE_SERIALIZER
+#define JSON_LITE_SERIALIZER
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+
+#include "json_compress.h"
+#include "json_lite.h"
+
+namespace json_lite
+{
+    const size_t OUTPUT_BUFFER_SIZE = 64 * 1024;    ///< the bytes gathered before a write
+
+    ///
+    /// \struct json_format
+    /// \brief  How json is printed
+    ///
+    struct json_format
+    {
+        ///
+        /// \fn         json_format
+        /// \brief      The constructor of json_format
+        /// \param      _pretty         Break lines and indent, or print everything on one line
+        /// \param      _indent_char    The character of indentation, '\\t' or ' '
+        /// \param      _indent_width   The characters of indentation for each level
+        ///
+        json_format(bool _pretty = true, char _indent_char = '\t', int _indent_width = 1);
+
+        bool pretty;            ///< break lines and indent
+        char indent_char;       ///< the character of indentation
+        int indent_width;       ///< the characters of indentation for each level
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// json_buffer
+    ///////////////////////////////////////////////////////////////////////////
+
+    ///
+    /// \class  json_buffer
+    /// \brief  A growable byte buffer for json output
+    ///
+    /// The output is gathered in memory. A buffer over a stream or a file
+    /// descriptor writes it in blocks of OUTPUT_BUFFER_SIZE, and at flush()
+    /// or destruction. Every buffer is independent, so threads printing into
+    /// their own buffers never share any state.
+    ///
+    /// The output to a stream or a file descriptor can be compressed with gzip
+    /// or zstd, see json_compress.h for the libraries compiled in. The
+    /// compressed stream is ended by finish() or the destructor.
+    ///
+    class json_buffer
+    {
+    public:
+        ///
+        /// \fn         json_buffer
+        /// \brief      A buffer keeping everything in memory, see get_string
+        ///
+        json_buffer();
+
+        ///
+        /// \overload   json_buffer(std::ostream &_stream, json_compression _compression, int level)
+        /// \brief      A buffer writing to a stream
+        /// \param      _stream         The stream, opened in binary mode if compressed
+        /// \param      _compression    The compression of the output, default value is COMPRESS_NONE
+        /// \param      level           The level of compression, 0 for the default of the library
+        /// \note       If the compression is not supported, nothing is written and is_good is false
+        ///
+        json_buffer(std::ostream &_stream, json_compression _compression = COMPRESS_NONE, int level = 0);
+
+        ///
+        /// \overload   json_buffer(int _fd, json_compression _compression, int level)
+        /// \brief      A buffer writing to a file descriptor, see json_buffer(std::ostream &_stream, ...)
+        ///
+        json_buffer(int _fd, json_compression _compression = COMPRESS_NONE, int level = 0);
+
+        ///
+        /// \fn         ~json_buffer
+        /// \brief      Write what is left, see finish
+        ///
+        ~json_buffer();
+
+        ///
+        /// \fn         put
+        /// \brief      Append a character
+        ///
+        void put(char c);
+
+        ///
+        /// \fn         write
+        /// \brief      Append some characters
+        ///
+        void write(const char *str, size_t length);
+
+        ///
+        /// \fn         fill
+        /// \brief      Append a character several times
+        ///
+        void fill(char c, size_t count);
+
+        ///
+        /// \fn         write_escaped
+        /// \brief      Append a string escaped to put it between quotations in json
+        /// \note       Clean spans are copied at once
+        ///
+        void write_escaped(const char *str, size_t length);
+
+        ///
+        /// \fn         flush
+        /// \brief      Write the characters gathered to the stream or file descriptor
+        /// \note       A compressed stream is flushed so far, at some cost of compression
+        /// \return     false if some write fails
+        ///
+        bool flush();
+
+        ///
+        /// \fn         finish
+        /// \brief      Write the characters gathered and end a compressed stream
+        /// \warning    Nothing can be written to a compressed stream after it
+        /// \return     false if some write fails
+        ///
+        bool finish();
+
+        ///
+        /// \fn         get_string
+        /// \brief      Return the characters gathered and not written yet
+        ///
+        const std::string& get_string() const;
+
+        ///
+        /// \fn         clear
+        /// \brief      Drop the characters gathered, keeping the memory
+        ///
+        void clear();
+
+        ///
+        /// \fn         is_good
+        /// \brief      If no write has failed
+        ///
+        bool is_good() const;
+
+    private:
+        json_buffer(const json_buffer&);              ///< copy is not allowed
+        json_buffer& operator=(const json_buffer&);   ///< copy is not allowed
+
+        ///
+        /// \fn         write_out
+        /// \brief      Write the characters gathered, compressed if required
+        /// \param      mode    How much a compressed stream should push out
+        ///
+        bool write_out(json_encode_mode mode);
+
+        ///
+        /// \fn         write_raw
+        /// \brief      Write some bytes to the stream or file descriptor
+        ///
+        void write_raw(const char *bytes, size_t length);
+
+    private:
+        std::string data;               ///< the characters gathered
+        std::ostream *stream;           ///< the stream written to, or NULL
+        int fd;                         ///< the file descriptor written to, or -1
+        bool good;                      ///< if no write has failed
+        json_compression compression;   ///< the compression of the output
+        json_encoder *encoder;          ///< the encoder of a compressed output, or NULL
+        std::string packed;             ///< the compressed bytes to write
+        bool finished;                  ///< if the compressed stream is ended
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// json_serializer
+    ///////////////////////////////////////////////////////////////////////////
+
+    ///
+    /// \class  json_serializer
+    /// \brief  Print json trees into a json_buffer
+    /// \note   Trees of any depth are printed without recursion
+    ///
+    class json_serializer
+    {
+    public:
+        ///
+        /// \fn         json_serializer
+        /// \brief      The constructor of json_serializer
+        /// \param      _out        The buffer to print into
+        /// \param      _format     How to print
+        ///
+        json_serializer(json_buffer &_out, const json_format &_format = json_format());
+
+        ///
+        /// \fn         write
+        /// \brief      Print a json element and all its children
+        /// \param      value           The json element
+        /// \param      indent_level    The levels of indentation, default value is 0
+        ///
+        void write(const json_value *value, int indent_level = 0);
+
+        ///
+        /// \fn         write_indent
+        /// \brief      Print the indentation of a level, if the format is pretty
+        ///
+        void write_indent(int indent_level);
+
+        ///
+        /// \fn         write_string
+        /// \brief      Print a string between quotations
+        ///
+        void write_string(const char *str, size_t length);
+
+    private:
+        ///
+        /// \fn         write_scalar
+        /// \brief      Print a string, number, true, false, null, or an empty object or array
+        ///
+        void write_scalar(const json_value *elem);
+
+    private:
+        json_buffer &out;       ///< the buffer to print into
+        json_format format;     ///< how to print
+    };
+}
+
+#endif // JSON_LITE_SERIALIZER
@@ -0,0 +1,141 @@
+///////////////////////////////////////////////////////////////////////////////
+///  Copyright 2012 Garnel
+///
+///  Licensed under the Apache License, Version 2.0 (the "License");
+///  you may not use this file except in compliance with the License.
+///  You may obtain a copy of the License at
+///
+///    http://www.apache.org/licenses/LICENSE-2.0
+///
+///  Unless required by applicable law or agreed to in writing, software
+///  distributed under the License is distributed on an "AS IS" BASIS,
+///  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///////////////////////////////////////////////////////////////////////////////
+
+///
+/// \file       json_stats.cpp
+/// The implementation of json_parse_stats
+/// \author     Garnel
+/// \date       2026/10/15
+/// \version    2.3
+/// \copyright  Apache License, Version 2.0
+///
+
+#include "json_stats.h"
+
+#include <chrono>
+
+///
+/// \namespace  json_lite
+///
+namespace json_lite
+{
+    // is_stats_enabled
+    bool is_stats_enabled()
+    {
+#ifdef JSON_LITE_STATS
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    // stats_clock
+    double stats_clock()
+    {
+        return std::chrono::duration<double>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    // json_parse_stats
+    ///////////////////////////////////////////////////////////////////////////
+
+    // json_parse_stats
+    json_parse_stats::json_parse_stats()
+    {
+        this->reset();
+    }
+
+    // reset
+    void json_parse_stats::reset()
+    {
+        documents = 0;
+        bytes = 0;
+        refills = 0;
+        for (size_t i = 0; i < JSON_TYPE_COUNT; i++)
+            values[i] = 0;
+        labels = 0;
+        string_bytes = 0;
+        number_bytes = 0;
+        max_depth = 0;
+        read_time = 0;
+        index_time = 0;
+        parse_time = 0;
+    }
+
+    // operator+=
+    json_parse_stats& json_parse_stats::operator+=(const json_parse_stats &other)
+    {
+        documents += other.documents;
+        bytes += other.bytes;
+        refills += other.refills;
+        for (size_t i = 0; i < JSON_TYPE_COUNT; i++)
+            values[i] += other.values[i];
+        labels += other.labels;
+        string_bytes += other.string_bytes;
+        number_bytes += other.number_bytes;
+        if (other.max_depth > max_depth)
+            max_depth = other.max_depth;
+        read_time += other.read_time;
+        index_time += other.index_time;
+        parse_time += other.parse_time;
+        return *this;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    // json_parser::stats_scope
+    ///////////////////////////////////////////////////////////////////////////
+
+    // stats_scope
+    json_parser::stats_scope::stats_scope(json_parser &_parser)
+        :parser(_parser),
+         stats(_parser.stats && _parser.stats_scopes++ == 0 ? _parser.stats : NULL),
+         offset(_parser.buffer_offset + (_parser.current_char - _parser.buffer_begin)),
+         start(stats ? stats_clock() : 0)
+    {
+    }
+
+    // ~stats_scope
+    json_parser::stats_scope::~stats_scope()
+    {
+        if (parser.stats)  //every call is counted in stats_scopes
+            parser.stats_scopes--;
+        if (stats)
+        {
+            stats->bytes += parser.buffer_offset + (parser.current_char - parser.buffer_begin) - offset;
+            stats->parse_time += stats_clock() - start;
+        }
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    // stats_timer
+    ///////////////////////////////////////////////////////////////////////////
+
+    // stats_timer
+    stats_timer::stats_timer(json_parse_stats *_stats, double json_parse_stats::*_phase)
+        :stats(_stats),
+         phase(_phase),
+         start(_stats ? stats_clock() : 0)
+    {
+    }
+
+    // ~stats_timer
+    stats_timer::~stats_timer()
+    {
+        if (stats)
+            stats->*phase += stats_clock() - start;
+    }
+}
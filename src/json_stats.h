@@ -0,0 +1,188 @@
+///////////////////////////////////////////////////////////////////////////////
+///  Copyright 2012 Garnel
+///
+///  Licensed under the Apache License, Version 2.0 (the "License");
+///  you may not use this file except in compliance with the License.
+///  You may obtain a copy of the License at
+///
+///    http://www.apache.org/licenses/LICENSE-2.0
+///
+///  Unless required by applicable law or agreed to in writing, software
+///  distributed under the License is distributed on an "AS IS" BASIS,
+///  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///////////////////////////////////////////////////////////////////////////////
+
+///
+/// \file       json_stats.h
+/// The counters and timers of json_parser
+/// \author     Garnel
+/// \date       2026/10/15
+/// \version    2.3
+/// \copyright  Apache License, Version 2.0
+///
+/// The counters are compiled in with JSON_LITE_STATS. Without it, every
+/// counting statement of the parser compiles to nothing, and the stats
+/// given to json_parser::set_stats stay zero.
+///
+
+#ifndef JSON_LITE_PARSE_STATS
+#define JSON_LITE_PARSE_STATS
+
+#include <cstddef>
+#include <ios>
+#include <stdint.h>
+
+#include "json_lite.h"
+
+namespace json_lite
+{
+    const size_t JSON_TYPE_COUNT = JSON_NULL + 1;   ///< the number of json_type
+
+    ///
+    /// \fn         is_stats_enabled
+    /// \brief      If the counters are compiled in, see JSON_LITE_STATS
+    ///
+    bool is_stats_enabled();
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// json_parse_stats
+    ///////////////////////////////////////////////////////////////////////////
+
+    ///
+    /// \struct json_parse_stats
+    /// \brief  What json_parser has done, added up over its parses
+    ///
+    /// The values are counted as they are parsed, so the counts are the same
+    /// for run(handler) as for run(). When a tree is built, every value and
+    /// every label is a json_value allocated.
+    ///
+    /// The times are in seconds. parse_time is the time of the calls of
+    /// run, next_document, run_indexed and run_parallel, including
+    /// read_time and index_time.
+    ///
+    /// \note   A stats can be shared by the parsers of a json_document or
+    ///         of a stream, one after another, but not at the same time
+    ///
+    struct json_parse_stats
+    {
+        ///
+        /// \fn         json_parse_stats
+        /// \brief      Everything is zero
+        ///
+        json_parse_stats();
+
+        ///
+        /// \fn         reset
+        /// \brief      Set everything to zero
+        ///
+        void reset();
+
+        ///
+        /// \fn         operator+=
+        /// \brief      Add the counts and times of another stats, max_depth is the larger
+        ///
+        json_parse_stats& operator+=(const json_parse_stats &other);
+
+        uint64_t documents;                 ///< the json parsed without error
+        uint64_t bytes;                     ///< the bytes of input consumed
+        uint64_t refills;                   ///< the blocks read from a file or a json_reader,
+                                            ///< after the first one read by the constructor
+        uint64_t values[JSON_TYPE_COUNT];   ///< the values parsed, by json_type
+        uint64_t labels;                    ///< the labels of pairs
+        uint64_t string_bytes;              ///< the bytes of strings and labels, decoded
+        uint64_t number_bytes;              ///< the bytes of the text of numbers
+        size_t max_depth;                   ///< the deepest nesting of objects and arrays
+        double read_time;                   ///< reading blocks, or waiting for a json_reader
+        double index_time;                  ///< building the structural index, or splitting an array
+        double parse_time;                  ///< the parse calls as a whole
+    };
+
+    ///
+    /// \class  stats_timer
+    /// \brief  Add the time of a scope to a phase of a stats, if there is one
+    ///
+    class stats_timer
+    {
+    public:
+        ///
+        /// \fn         stats_timer
+        /// \param      _stats  The stats, NULL to time nothing
+        /// \param      _phase  read_time, index_time or parse_time
+        ///
+        stats_timer(json_parse_stats *_stats, double json_parse_stats::*_phase);
+
+        ///
+        /// \fn         ~stats_timer
+        /// \brief      Add the time passed to the phase
+        ///
+        ~stats_timer();
+
+    private:
+        stats_timer(const stats_timer&);                ///< copy is not allowed
+        stats_timer& operator=(const stats_timer&);     ///< copy is not allowed
+
+        json_parse_stats *stats;            ///< the stats, or NULL
+        double json_parse_stats::*phase;    ///< the time added to
+        double start;                       ///< the time when the scope begins
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// json_parser::stats_scope
+    ///////////////////////////////////////////////////////////////////////////
+
+    ///
+    /// \class  json_parser::stats_scope
+    /// \brief  Count the bytes and the time of a parse call into the stats of the parser
+    /// \note   A call made by another, like run() when run_indexed falls back to it,
+    ///         is counted by the outer call only
+    ///
+    class json_parser::stats_scope
+    {
+    public:
+        ///
+        /// \fn         stats_scope
+        /// \brief      Begin a parse call of a parser
+        ///
+        stats_scope(json_parser &_parser);
+
+        ///
+        /// \fn         ~stats_scope
+        /// \brief      Add the bytes consumed and the time passed to the stats
+        ///
+        ~stats_scope();
+
+    private:
+        stats_scope(const stats_scope&);                ///< copy is not allowed
+        stats_scope& operator=(const stats_scope&);     ///< copy is not allowed
+
+        json_parser &parser;        ///< the parser
+        json_parse_stats *stats;    ///< the stats, NULL for an inner call or no stats
+        std::streamoff offset;      ///< the offset of the input when the call begins
+        double start;               ///< the time when the call begins
+    };
+
+    ///
+    /// \fn         stats_clock
+    /// \brief      The seconds of a steady clock
+    ///
+    double stats_clock();
+}
+
+///
+/// The counting of the parser, on its member stats. A statement runs only
+/// if the parser has stats, and is not compiled without JSON_LITE_STATS.
+///
+#ifdef JSON_LITE_STATS
+#define JSON_LITE_STAT(statement) do { if (stats) { statement; } } while (0)
+#define JSON_LITE_STAT_TIME(phase) \
+    json_lite::stats_timer stats_timer_##phase(stats, &json_lite::json_parse_stats::phase)
+#define JSON_LITE_STAT_PARSE() json_lite::json_parser::stats_scope stats_parse_scope(*this)
+#else
+#define JSON_LITE_STAT(statement) ((void)0)
+#define JSON_LITE_STAT_TIME(phase) ((void)0)
+#define JSON_LITE_STAT_PARSE() ((void)0)
+#endif
+
+#endif // JSON_LITE_PARSE_STATS
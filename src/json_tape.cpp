@@ -0,0 +1,501 @@
+///////////////////////////////////////////////////////////////////////////////
+///  Copyright 2012 Garnel
+///
+///  Licensed under the Apache License, Version 2.0 (the "License");
+///  you may not use this file except in compliance with the License.
+///  You may obtain a copy of the License at
+///
+///    http://www.apache.org/licenses/LICENSE-2.0
+///
+///  Unless required by applicable law or agreed to in writing, software
+///  distributed under the License is distributed on an "AS IS" BASIS,
+///  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///////////////////////////////////////////////////////////////////////////////
+
+///
+/// \file       json_tape.cpp
+/// The implementation of class json_tape and json_tape_value
+/// \author     Garnel
+/// \date       2026/10/15
+/// \version    2.3
+/// \copyright  Apache License, Version 2.0
+///
+
+#include "json_tape.h"
+
+#include <cstring>
+
+///
+/// \namespace  json_lite
+///
+namespace json_lite
+{
+    const int TAPE_TAG_SHIFT = 56;                                          ///< the tag is in the high 8 bits
+    const uint64_t TAPE_PAYLOAD_MASK = ((uint64_t)1 << TAPE_TAG_SHIFT) - 1; ///< the payload is in the others
+
+    ///
+    /// \fn         tape_word
+    /// \brief      Pack a tag and a payload into a word
+    ///
+    inline uint64_t tape_word(char tag, uint64_t payload)
+    {
+        return ((uint64_t)(unsigned char)tag << TAPE_TAG_SHIFT) | (payload & TAPE_PAYLOAD_MASK);
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    // json_tape_value
+    ///////////////////////////////////////////////////////////////////////////
+
+    // json_tape_value
+    json_tape_value::json_tape_value()
+        :tape(NULL),
+         index(0),
+         end(0),
+         kind(ELEMENT)
+    {
+    }
+
+    json_tape_value::json_tape_value(const json_tape *_tape, size_t _index, size_t _end, role _role)
+        :tape(_tape),
+         index(_index),
+         end(_end),
+         kind(_role)
+    {
+    }
+
+    // is_valid
+    bool json_tape_value::is_valid() const
+    {
+        return tape != NULL;
+    }
+
+    // get_type
+    json_type json_tape_value::get_type() const
+    {
+        assert(tape);
+        switch (tape->get_tag(index))
+        {
+        case '{':
+            return JSON_OBJECT;
+        case '[':
+            return JSON_ARRAY;
+        case '0':
+            return JSON_NUMBER;
+        case 't':
+            return JSON_TRUE;
+        case 'f':
+            return JSON_FALSE;
+        case 'n':
+            return JSON_NULL;
+        default:
+            return JSON_STRING;
+        }
+    }
+
+    // get_value
+    std::string json_tape_value::get_value() const
+    {
+        assert(tape);
+        uint32_t length;
+        switch (tape->get_tag(index))
+        {
+        case 'k':
+        case '"':
+        case '0':
+            {
+                const char *str = tape->get_string(index, length);
+                return std::string(str, length);
+            }
+        case 't':
+            return "true";
+        case 'f':
+            return "false";
+        case 'n':
+            return "null";
+        default:
+            return "";
+        }
+    }
+
+    // get_number_type
+    json_number_type json_tape_value::get_number_type() const
+    {
+        return this->get_number().type;
+    }
+
+    // is_integer
+    bool json_tape_value::is_integer() const
+    {
+        return this->get_number().type != NUMBER_DOUBLE;
+    }
+
+    // get_int64
+    int64_t json_tape_value::get_int64() const
+    {
+        json_number number = this->get_number();
+        switch (number.type)
+        {
+        case NUMBER_INT64:
+            return number.i;
+        case NUMBER_UINT64:
+            return (int64_t)number.u;
+        default:
+            return (int64_t)number.d;
+        }
+    }
+
+    // get_uint64
+    uint64_t json_tape_value::get_uint64() const
+    {
+        json_number number = this->get_number();
+        switch (number.type)
+        {
+        case NUMBER_INT64:
+            return (uint64_t)number.i;
+        case NUMBER_UINT64:
+            return number.u;
+        default:
+            return (uint64_t)number.d;
+        }
+    }
+
+    // get_double
+    double json_tape_value::get_double() const
+    {
+        json_number number = this->get_number();
+        switch (number.type)
+        {
+        case NUMBER_INT64:
+            return (double)number.i;
+        case NUMBER_UINT64:
+            return (double)number.u;
+        default:
+            return number.d;
+        }
+    }
+
+    // get_number
+    json_number json_tape_value::get_number() const
+    {
+        assert(tape && tape->get_tag(index) == '0');
+        uint32_t length;
+        const char *str = tape->get_string(index, length);
+        json_number number;
+        to_number(str, length, number);  //out of the range of double, it is infinity
+        return number;
+    }
+
+    // get_next
+    json_tape_value json_tape_value::get_next() const
+    {
+        // the value of a label has no next element, like in the tree
+        if (!tape || kind == MEMBER)
+            return json_tape_value();
+
+        size_t next = tape->skip(index);
+        if (next >= end)
+            return json_tape_value();
+        return json_tape_value(tape, next, end, kind);
+    }
+
+    // get_first_child
+    json_tape_value json_tape_value::get_first_child() const
+    {
+        if (!tape)
+            return json_tape_value();
+
+        switch (tape->get_tag(index))
+        {
+        case 'k':
+            return json_tape_value(tape, index + 1, tape->skip(index + 1), MEMBER);
+        case '{':
+        case '[':
+            {
+                // the children end at the matching '}' or ']'
+                size_t close = tape->skip(index) - 1;
+                if (index + 1 == close)  //empty
+                    return json_tape_value();
+                return json_tape_value(tape, index + 1, close,
+                    tape->get_tag(index) == '{' ? LABEL : ELEMENT);
+            }
+        default:
+            return json_tape_value();
+        }
+    }
+
+    // get_child_by_label
+    json_tape_value json_tape_value::get_child_by_label(const std::string &label) const
+    {
+        if (!tape)
+            return json_tape_value();
+
+        // every string in the element and its next elements is in [index, end),
+        // in the order json_value::get_child_by_label walks them
+        for (size_t i = index; i < end; i++)
+        {
+            char tag = tape->get_tag(i);
+            if (tag != 'k' && tag != '\"')
+                continue;
+
+            uint32_t length;
+            const char *str = tape->get_string(i, length);
+            if (length == label.size() && memcmp(str, label.data(), length) == 0)
+                return tag == 'k' ? json_tape_value(tape, i + 1, tape->skip(i + 1), MEMBER)
+                    : json_tape_value();  //a string value has no child
+        }
+        return json_tape_value();
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    // json_tape
+    ///////////////////////////////////////////////////////////////////////////
+
+    // json_tape
+    json_tape::json_tape()
+    {
+    }
+
+    // build
+    void json_tape::build(const json_value *root)
+    {
+        tape.clear();
+        strings.clear();
+        if (!root)
+            return;
+
+        // the tape positions of the open objects and arrays
+        std::vector<size_t> open;
+        const json_value *cur = root;
+        while (true)
+        {
+            // the element itself
+            json_type _type = cur->get_type();
+            switch (_type)
+            {
+            case JSON_OBJECT:
+            case JSON_ARRAY:
+                open.push_back(tape.size());
+                tape.push_back(0);  //patched when it is closed
+                break;
+            case JSON_STRING:
+                {
+                    const json_value *parent = cur->get_parent();
+                    bool is_label = cur != root && parent && parent->get_type() == JSON_OBJECT;
+                    tape.push_back(tape_word(is_label ? 'k' : '"', this->append_string(cur->get_value())));
+                }
+                break;
+            case JSON_NUMBER:
+                tape.push_back(tape_word('0', this->append_string(cur->get_value())));
+                break;
+            case JSON_TRUE:
+                tape.push_back(tape_word('t', 0));
+                break;
+            case JSON_FALSE:
+                tape.push_back(tape_word('f', 0));
+                break;
+            case JSON_NULL:
+                tape.push_back(tape_word('n', 0));
+                break;
+            default:
+                break;
+            }
+
+            if (cur->get_first_child())
+            {
+                cur = cur->get_first_child();
+                continue;
+            }
+
+            // go up until there is a next element, closing objects and arrays
+            while (true)
+            {
+                _type = cur->get_type();
+                if (_type == JSON_OBJECT || _type == JSON_ARRAY)
+                {
+                    size_t start = open.back();
+                    open.pop_back();
+                    tape.push_back(tape_word(_type == JSON_OBJECT ? '}' : ']', start));
+                    tape[start] = tape_word(_type == JSON_OBJECT ? '{' : '[', tape.size());
+                }
+                if (cur == root || cur->get_next())
+                    break;
+                cur = cur->get_parent();
+            }
+            if (cur == root)
+                break;
+            cur = cur->get_next();
+        }
+    }
+
+    // parse
+    bool json_tape::parse(json_parser &parser)
+    {
+        json_parse_result result;
+        bool ok = this->parse(parser, result);
+        if (result.failed)
+            parser.print_error(result);
+        return ok;
+    }
+
+    bool json_tape::parse(json_parser &parser, json_parse_result &result)
+    {
+        tape.clear();
+        strings.clear();
+        tape_builder builder(*this);
+        if (parser.run(builder, result))
+            return true;
+        tape.clear();
+        strings.clear();
+        return false;
+    }
+
+    // get_root
+    json_tape_value json_tape::get_root() const
+    {
+        if (tape.empty())
+            return json_tape_value();
+        return json_tape_value(this, 0, this->skip(0), json_tape_value::ELEMENT);
+    }
+
+    // get_size
+    size_t json_tape::get_size() const
+    {
+        return tape.size();
+    }
+
+    // append_string
+    uint64_t json_tape::append_string(const std::string &str)
+    {
+        uint64_t offset = strings.size();
+        uint32_t length = (uint32_t)str.size();
+        strings.resize(offset + sizeof(length) + length);
+        memcpy(&strings[offset], &length, sizeof(length));
+        if (length)
+            memcpy(&strings[offset + sizeof(length)], str.data(), length);
+        return offset;
+    }
+
+    // get_tag
+    char json_tape::get_tag(size_t index) const
+    {
+        return (char)(tape[index] >> TAPE_TAG_SHIFT);
+    }
+
+    // get_payload
+    uint64_t json_tape::get_payload(size_t index) const
+    {
+        return tape[index] & TAPE_PAYLOAD_MASK;
+    }
+
+    // skip
+    size_t json_tape::skip(size_t index) const
+    {
+        switch (this->get_tag(index))
+        {
+        case '{':
+        case '[':
+            return (size_t)this->get_payload(index);
+        case 'k':
+            return this->skip(index + 1);
+        default:
+            return index + 1;
+        }
+    }
+
+    // get_string
+    const char* json_tape::get_string(size_t index, uint32_t &length) const
+    {
+        const char *p = &strings[(size_t)this->get_payload(index)];
+        memcpy(&length, p, sizeof(length));
+        return p + sizeof(length);
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    // json_tape::tape_builder
+    ///////////////////////////////////////////////////////////////////////////
+
+    // tape_builder
+    json_tape::tape_builder::tape_builder(json_tape &_tape)
+        :tape(_tape)
+    {
+    }
+
+    // on_start_object
+    bool json_tape::tape_builder::on_start_object()
+    {
+        return this->open_container();
+    }
+
+    // on_end_object
+    bool json_tape::tape_builder::on_end_object()
+    {
+        return this->close_container('{', '}');
+    }
+
+    // on_start_array
+    bool json_tape::tape_builder::on_start_array()
+    {
+        return this->open_container();
+    }
+
+    // on_end_array
+    bool json_tape::tape_builder::on_end_array()
+    {
+        return this->close_container('[', ']');
+    }
+
+    // on_key
+    bool json_tape::tape_builder::on_key(const std::string &key)
+    {
+        tape.tape.push_back(tape_word('k', tape.append_string(key)));
+        return true;
+    }
+
+    // on_string
+    bool json_tape::tape_builder::on_string(const std::string &str)
+    {
+        tape.tape.push_back(tape_word('\"', tape.append_string(str)));
+        return true;
+    }
+
+    // on_number
+    bool json_tape::tape_builder::on_number(const std::string &text)
+    {
+        tape.tape.push_back(tape_word('0', tape.append_string(text)));
+        return true;
+    }
+
+    // on_bool
+    bool json_tape::tape_builder::on_bool(bool b)
+    {
+        tape.tape.push_back(tape_word(b ? 't' : 'f', 0));
+        return true;
+    }
+
+    // on_null
+    bool json_tape::tape_builder::on_null()
+    {
+        tape.tape.push_back(tape_word('n', 0));
+        return true;
+    }
+
+    // open_container
+    bool json_tape::tape_builder::open_container()
+    {
+        open.push_back(tape.tape.size());
+        tape.tape.push_back(0);  //patched when it is closed
+        return true;
+    }
+
+    // close_container
+    bool json_tape::tape_builder::close_container(char open_tag, char close_tag)
+    {
+        size_t start = open.back();
+        open.pop_back();
+        tape.tape.push_back(tape_word(close_tag, start));
+        tape.tape[start] = tape_word(open_tag, tape.tape.size());
+        return true;
+    }
+}
@@ -0,0 +1,324 @@
+///////////////////////////////////////////////////////////////////////////////
+///  Copyright 2012 Garnel
+///
+///  Licensed under the Apache License, Version 2.0 (the "License");
+///  you may not use this file except in compliance with the License.
+///  You may obtain a copy of the License at
+///
+///    http://www.apache.org/licenses/LICENSE-2.0
+///
+///  Unless required by applicable law or agreed to in writing, software
+///  distributed under the License is distributed on an "AS IS" BASIS,
+///  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///////////////////////////////////////////////////////////////////////////////
+
+///
+/// \file       json_tape.h
+/// The declaration of json_tape and json_tape_value
+/// \author     Garnel
+/// \date       2026/10/15
+/// \version    2.3
+/// \copyright  Apache License, Version 2.0
+///
+
+#ifndef JSON_LITE_TAPE
+#define JSON_LITE_TAPE
+
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+#include "json_handler.h"
+#include "json_lite.h"
+
+namespace json_lite
+{
+    class json_tape;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// json_tape_value
+    ///////////////////////////////////////////////////////////////////////////
+
+    ///
+    /// \class  json_tape_value
+    /// \brief  A read-only element in a json_tape
+    /// \note   It is only a position in the tape, cheap to copy.
+    ///         It walks the tape like json_value walks the tree: the children of
+    ///         an object are its labels, and the only child of a label is its value.
+    ///
+    class json_tape_value
+    {
+    public:
+        ///
+        /// \fn         json_tape_value
+        /// \brief      Construct an invalid element, like a NULL json_value
+        ///
+        json_tape_value();
+
+        ///
+        /// \fn         is_valid
+        /// \brief      If the element exists
+        ///
+        bool is_valid() const;
+
+        ///
+        /// \fn         get_type
+        /// \brief      Return the type of the element
+        /// \note       Labels are JSON_STRING
+        ///
+        json_type get_type() const;
+
+        ///
+        /// \fn         get_value
+        /// \brief      Return the value of the element
+        /// \warning    Objects and arrays have NO value, the value will be a empty string
+        ///
+        std::string get_value() const;
+
+        ///
+        /// \fn         get_number_type
+        /// \brief      Return how the number is stored, see json_value::get_number_type
+        /// \note       The tape keeps the text of a number, it is converted by
+        ///             to_number at each call
+        /// \warning    Only works for numbers
+        ///
+        json_number_type get_number_type() const;
+
+        ///
+        /// \fn         is_integer
+        /// \brief      If the number is an integer (int64_t or uint64_t)
+        /// \warning    Only works for numbers
+        ///
+        bool is_integer() const;
+
+        ///
+        /// \fn         get_int64
+        /// \brief      Return the number as int64_t
+        /// \note       A double is truncated, a uint64_t beyond int64_t wraps
+        /// \warning    Only works for numbers
+        ///
+        int64_t get_int64() const;
+
+        ///
+        /// \fn         get_uint64
+        /// \brief      Return the number as uint64_t
+        /// \note       A double is truncated, a negative int64_t wraps
+        /// \warning    Only works for numbers
+        ///
+        uint64_t get_uint64() const;
+
+        ///
+        /// \fn         get_double
+        /// \brief      Return the number as double
+        /// \warning    Only works for numbers
+        ///
+        double get_double() const;
+
+        ///
+        /// \fn         get_next
+        /// \brief      Get the next element, invalid if it is the last one
+        ///
+        json_tape_value get_next() const;
+
+        ///
+        /// \fn         get_first_child
+        /// \brief      Get the first child of the element, invalid if it has none
+        ///
+        json_tape_value get_first_child() const;
+
+        ///
+        /// \fn         get_child_by_label
+        /// \brief      Get the label's child
+        /// \param      label   The label to search
+        /// \note       Search the element, its children and the next elements,
+        ///             the same as json_value::get_child_by_label: if a string (not
+        ///             a label of some pair) equal to the label comes first, the
+        ///             element is invalid too
+        /// \return     The child of the label, invalid if the label doesn't exist
+        ///
+        json_tape_value get_child_by_label(const std::string &label) const;
+
+    private:
+        friend class json_tape;
+
+        ///
+        /// \enum   role
+        /// \brief  Where the element is, which decides its next element
+        ///
+        enum role
+        {
+            ELEMENT,    ///< the root or an element of an array
+            LABEL,      ///< a label of an object
+            MEMBER      ///< the value of a label
+        };
+
+        json_tape_value(const json_tape *_tape, size_t _index, size_t _end, role _role);
+
+        ///
+        /// \fn         get_number
+        /// \brief      Convert the text of the number
+        ///
+        json_number get_number() const;
+
+    private:
+        const json_tape *tape;  ///< the tape of the element, NULL if invalid
+        size_t index;           ///< the position of the element in the tape
+        size_t end;             ///< the end of the element and its next elements
+        role kind;              ///< where the element is
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// json_tape
+    ///////////////////////////////////////////////////////////////////////////
+
+    ///
+    /// \class  json_tape
+    /// \brief  An immutable json document in a contiguous tape of 64-bit words
+    ///
+    /// Each word holds a tag in its high 8 bits and a payload in the others.
+    /// '{' and '[' point past their matching '}' and ']' so a whole object or
+    /// array is skipped in one step, labels ('k'), strings ('"') and numbers
+    /// ('0') point into one string buffer, 't', 'f' and 'n' need no payload.
+    /// Siblings are next to each other in memory instead of linked on the heap.
+    ///
+    class json_tape
+    {
+    public:
+        ///
+        /// \fn         json_tape
+        /// \brief      Construct an empty tape
+        ///
+        json_tape();
+
+        ///
+        /// \fn         build
+        /// \brief      Copy a json tree into the tape, replacing the previous one
+        /// \param      root    The root of the json tree, NULL for an empty tape
+        ///
+        void build(const json_value *root);
+
+        ///
+        /// \fn         parse
+        /// \brief      Parse a json into the tape, replacing the previous one
+        /// \note       The words are appended from the events of the parser, no
+        ///             tree is built. An error is printed, and leaves the tape empty.
+        /// \return     true for success, false for failure
+        ///
+        bool parse(json_parser &parser);
+
+        ///
+        /// \overload   parse(json_parser &parser, json_parse_result &result)
+        /// \brief      Parse a json into the tape, giving back an error instead of printing it
+        /// \param      result      The error and its position, if the parse fails
+        ///
+        bool parse(json_parser &parser, json_parse_result &result);
+
+        ///
+        /// \fn         get_root
+        /// \brief      Return the root of the json, invalid if the tape is empty
+        ///
+        json_tape_value get_root() const;
+
+        ///
+        /// \fn         get_size
+        /// \brief      Return the number of words in the tape
+        ///
+        size_t get_size() const;
+
+    private:
+        friend class json_tape_value;
+
+        ///
+        /// \fn         append_string
+        /// \brief      Append a string to the string buffer
+        /// \return     The offset of the string in the buffer
+        ///
+        uint64_t append_string(const std::string &str);
+
+        ///
+        /// \fn         get_tag
+        /// \brief      Return the tag of the word at index
+        ///
+        char get_tag(size_t index) const;
+
+        ///
+        /// \fn         get_payload
+        /// \brief      Return the payload of the word at index
+        ///
+        uint64_t get_payload(size_t index) const;
+
+        ///
+        /// \fn         skip
+        /// \brief      Return the position after the element at index
+        /// \note       A label is skipped with its value
+        ///
+        size_t skip(size_t index) const;
+
+        ///
+        /// \fn         get_string
+        /// \brief      Return a string in the string buffer and its length
+        ///
+        const char* get_string(size_t index, uint32_t &length) const;
+
+        ///
+        /// \class      tape_builder
+        /// \brief      The handler appending the words of parse()
+        ///
+        class tape_builder;
+
+    private:
+        std::vector<uint64_t> tape;     ///< the words
+        std::vector<char> strings;      ///< the strings, each after its 32-bit length
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// json_tape::tape_builder
+    ///////////////////////////////////////////////////////////////////////////
+
+    ///
+    /// \class  json_tape::tape_builder
+    /// \brief  The handler appending the words of json_tape::parse
+    /// \note   An object or array is patched with the end of its words when it is closed
+    ///
+    class json_tape::tape_builder : public json_handler
+    {
+    public:
+        ///
+        /// \fn         tape_builder
+        /// \brief      The constructor of tape_builder
+        /// \param      _tape   The tape to append to
+        ///
+        tape_builder(json_tape &_tape);
+
+        bool on_start_object();
+        bool on_end_object();
+        bool on_start_array();
+        bool on_end_array();
+        bool on_key(const std::string &key);
+        bool on_string(const std::string &str);
+        bool on_number(const std::string &text);
+        bool on_bool(bool b);
+        bool on_null();
+
+    private:
+        ///
+        /// \fn         open_container
+        /// \brief      Append the word of a '{' or '[', patched by close_container
+        ///
+        bool open_container();
+
+        ///
+        /// \fn         close_container
+        /// \brief      Append the word of a '}' or ']' and patch the opening one
+        ///
+        bool close_container(char open_tag, char close_tag);
+
+    private:
+        json_tape &tape;            ///< the tape appended to
+        std::vector<size_t> open;   ///< the positions of the open objects and arrays
+    };
+}
+
+#endif // JSON_LITE_TAPE
@@ -0,0 +1,314 @@
+///////////////////////////////////////////////////////////////////////////////
+///  Copyright 2012 Garnel
+///
+///  Licensed under the Apache License, Version 2.0 (the "License");
+///  you may not use this file except in compliance with the License.
+///  You may obtain a copy of the License at
+///
+///    http://www.apache.org/licenses/LICENSE-2.0
+///
+///  Unless required by applicable law or agreed to in writing, software
+///  distributed under the License is distributed on an "AS IS" BASIS,
+///  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///////////////////////////////////////////////////////////////////////////////
+
+///
+/// \file       json_writer.cpp
+/// The implementation of class json_writer
+/// \author     Garnel
+/// \date       2026/10/15
+/// \version    2.3
+/// \copyright  Apache License, Version 2.0
+///
+
+#include "json_writer.h"
+
+#include <cassert>
+#include <cstring>
+
+///
+/// \namespace  json_lite
+///
+namespace json_lite
+{
+    // json_writer
+    json_writer::json_writer(json_buffer &_out, const json_format &_format, int _indent_level)
+        :out(_out),
+         format(_format),
+         printer(_out, _format),
+         indent_level(_indent_level),
+         top_count(0)
+    {
+    }
+
+    // begin_object
+    void json_writer::begin_object()
+    {
+        this->begin_container(true);
+    }
+
+    // end_object
+    void json_writer::end_object()
+    {
+        this->end_container(true);
+    }
+
+    // begin_array
+    void json_writer::begin_array()
+    {
+        this->begin_container(false);
+    }
+
+    // end_array
+    void json_writer::end_array()
+    {
+        this->end_container(false);
+    }
+
+    // key
+    void json_writer::key(const char *str, size_t length)
+    {
+        assert(!stack.empty() && stack.back().object && "a key is only allowed in an object");
+        assert(!stack.back().has_key && "the previous key has no value");
+        if (stack.empty())
+            return;
+
+        frame &top = stack.back();
+        if (!top.opened)
+        {
+            // the value of a pair with a child begins on the next line
+            if (format.pretty)
+                out.put('\n');
+            printer.write_indent(top.level);
+            out.put('{');
+            top.opened = true;
+        }
+        if (top.count++)
+            out.put(',');
+        if (format.pretty)
+            out.put('\n');
+        printer.write_indent(top.level + 1);
+        printer.write_string(str, length);
+        out.put(':');
+        if (format.pretty)
+            out.put(' ');
+        top.has_key = true;
+    }
+
+    void json_writer::key(const char *str)
+    {
+        assert(str);
+        this->key(str, strlen(str));
+    }
+
+    void json_writer::key(const std::string &str)
+    {
+        this->key(str.data(), str.size());
+    }
+
+    // value
+    void json_writer::value(const char *str, size_t length)
+    {
+        this->write_scalar(str, length, true);
+    }
+
+    void json_writer::value(const char *str)
+    {
+        assert(str);
+        this->write_scalar(str, strlen(str), true);
+    }
+
+    void json_writer::value(const std::string &str)
+    {
+        this->write_scalar(str.data(), str.size(), true);
+    }
+
+    void json_writer::value(bool b)
+    {
+        if (b)
+            this->write_scalar("true", 4, false);
+        else
+            this->write_scalar("false", 5, false);
+    }
+
+    void json_writer::value(int i)
+    {
+        this->value((long long)i);
+    }
+
+    void json_writer::value(unsigned int u)
+    {
+        this->value((unsigned long long)u);
+    }
+
+    void json_writer::value(long i)
+    {
+        this->value((long long)i);
+    }
+
+    void json_writer::value(unsigned long u)
+    {
+        this->value((unsigned long long)u);
+    }
+
+    void json_writer::value(long long i)
+    {
+        json_number number;
+        number.type = NUMBER_INT64;
+        number.i = (int64_t)i;
+        this->write_number(number);
+    }
+
+    void json_writer::value(unsigned long long u)
+    {
+        json_number number;
+        number.type = NUMBER_UINT64;
+        number.u = (uint64_t)u;
+        this->write_number(number);
+    }
+
+    void json_writer::value(double d)
+    {
+        json_number number;
+        number.type = NUMBER_DOUBLE;
+        number.d = d;
+        this->write_number(number);
+    }
+
+    void json_writer::value(const json_value *elem)
+    {
+        assert(elem);
+        json_type type = elem->get_type();
+        bool container = (type == JSON_OBJECT || type == JSON_ARRAY) && elem->get_first_child();
+
+        // the serializer prints the indentation itself
+        int level = stack.empty() ? indent_level : stack.back().level + 1;
+        if (this->begin_value(false))
+        {
+            if (!container)
+                level = 0;
+            else if (format.pretty)
+                out.put('\n');
+        }
+        printer.write(elem, level);
+    }
+
+    // null
+    void json_writer::null()
+    {
+        this->write_scalar("null", 4, false);
+    }
+
+    // get_depth
+    size_t json_writer::get_depth() const
+    {
+        return stack.size();
+    }
+
+    // is_complete
+    bool json_writer::is_complete() const
+    {
+        return stack.empty() && top_count > 0;
+    }
+
+    // begin_value
+    bool json_writer::begin_value(bool indent)
+    {
+        if (stack.empty())
+        {
+            if (top_count++)
+                out.put('\n');
+            if (indent)
+                printer.write_indent(indent_level);
+            return false;
+        }
+
+        frame &top = stack.back();
+        if (top.object)
+        {
+            // the key has printed everything before the value
+            assert(top.has_key && "a value in an object needs a key");
+            top.has_key = false;
+            return true;
+        }
+
+        if (!top.opened)
+        {
+            if (format.pretty)
+                out.put('\n');
+            printer.write_indent(top.level);
+            out.put('[');
+            top.opened = true;
+        }
+        if (top.count++)
+            out.put(',');
+        if (format.pretty)
+            out.put('\n');
+        if (indent)
+            printer.write_indent(top.level + 1);
+        return false;
+    }
+
+    // begin_container
+    void json_writer::begin_container(bool object)
+    {
+        bool in_pair = this->begin_value(false);
+        frame elem;
+        elem.object = object;
+        elem.opened = !in_pair;
+        elem.has_key = false;
+        elem.count = 0;
+        elem.level = stack.empty() ? indent_level : stack.back().level + 1;
+
+        // '{' or '[' of a pair waits for the first child, empty ones stay on the line of the key
+        if (elem.opened)
+        {
+            printer.write_indent(elem.level);
+            out.put(object ? '{' : '[');
+        }
+        stack.push_back(elem);
+    }
+
+    // end_container
+    void json_writer::end_container(bool object)
+    {
+        assert(!stack.empty() && "nothing to close");
+        assert(stack.back().object == object && "closing an object with ']' or an array with '}'");
+        assert(!stack.back().has_key && "the last key has no value");
+        if (stack.empty())
+            return;
+
+        frame top = stack.back();
+        stack.pop_back();
+        if (!top.opened)
+            out.write(object ? "{}" : "[]", 2);
+        else
+        {
+            if (top.count && format.pretty)
+            {
+                out.put('\n');
+                printer.write_indent(top.level);
+            }
+            out.put(object ? '}' : ']');
+        }
+    }
+
+    // write_scalar
+    void json_writer::write_scalar(const char *str, size_t length, bool quoted)
+    {
+        this->begin_value(true);
+        if (quoted)
+            printer.write_string(str, length);
+        else
+            out.write(str, length);
+    }
+
+    // write_number
+    void json_writer::write_number(const json_number &number)
+    {
+        std::string text = number_text(number);
+        this->write_scalar(text.data(), text.size(), false);
+    }
+}
@@ -0,0 +1,254 @@
+///////////////////////////////////////////////////////////////////////////////
+///  Copyright 2012 Garnel
+///
+///  Licensed under the Apache License, Version 2.0 (the "License");
+///  you may not use this file except in compliance with the License.
+///  You may obtain a copy of the License at
+///
+///    http://www.apache.org/licenses/LICENSE-2.0
+///
+///  Unless required by applicable law or agreed to in writing, software
+///  distributed under the License is distributed on an "AS IS" BASIS,
+///  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///////////////////////////////////////////////////////////////////////////////
+
+///
+/// \file       json_writer.h
+/// The declaration of json_writer, printing json without building a tree
+/// \author     Garnel
+/// \date       2026/10/15
+/// \version    2.3
+/// \copyright  Apache License, Version 2.0
+///
+
+#ifndef JSON_LITE_WRITER
+#define JSON_LITE_WRITER
+
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+#include "json_serializer.h"
+
+namespace json_lite
+{
+    ///////////////////////////////////////////////////////////////////////////
+    /// json_writer
+    ///////////////////////////////////////////////////////////////////////////
+
+    ///
+    /// \class  json_writer
+    /// \brief  Print json as it is produced, without building json_value
+    ///
+    /// The calls follow the json text: begin_object, then key and a value
+    /// for every pair, then end_object. Everything goes into a json_buffer
+    /// with the escaping and layout of json_serializer, so a writer prints
+    /// the same text as a tree of the same json.
+    ///
+    /// Values at the top level are separated by a newline, so a writer in
+    /// the compact format prints a json per line.
+    ///
+    /// \note   The nesting of the calls is checked by assertions in debug builds
+    ///
+    class json_writer
+    {
+    public:
+        ///
+        /// \fn         json_writer
+        /// \brief      The constructor of json_writer
+        /// \param      _out            The buffer to print into
+        /// \param      _format         How to print
+        /// \param      _indent_level   The levels of indentation of the top level, default value is 0
+        ///
+        json_writer(json_buffer &_out, const json_format &_format = json_format(), int _indent_level = 0);
+
+        ///
+        /// \fn         begin_object
+        /// \brief      Open an object, followed by pairs of key and value
+        ///
+        void begin_object();
+
+        ///
+        /// \fn         end_object
+        /// \brief      Close the innermost object
+        ///
+        void end_object();
+
+        ///
+        /// \fn         begin_array
+        /// \brief      Open an array, followed by its elements
+        ///
+        void begin_array();
+
+        ///
+        /// \fn         end_array
+        /// \brief      Close the innermost array
+        ///
+        void end_array();
+
+        ///
+        /// \fn         key
+        /// \brief      Print the key of the next pair in the innermost object
+        /// \param      str     The key, not escaped
+        /// \param      length  The length of the key
+        ///
+        void key(const char *str, size_t length);
+
+        ///
+        /// \overload   key(const char *str)
+        /// \brief      Print a key ending with '\\0'
+        ///
+        void key(const char *str);
+
+        ///
+        /// \overload   key(const std::string &str)
+        ///
+        void key(const std::string &str);
+
+        ///
+        /// \fn         value
+        /// \brief      Print a string
+        /// \param      str     The string, not escaped
+        /// \param      length  The length of the string
+        ///
+        void value(const char *str, size_t length);
+
+        ///
+        /// \overload   value(const char *str)
+        /// \brief      Print a string ending with '\\0'
+        ///
+        void value(const char *str);
+
+        ///
+        /// \overload   value(const std::string &str)
+        ///
+        void value(const std::string &str);
+
+        ///
+        /// \overload   value(bool b)
+        /// \brief      Print true or false
+        ///
+        void value(bool b);
+
+        ///
+        /// \overload   value(int i)
+        /// \note       Every integer type has its overload, so int64_t, uint64_t and
+        ///             size_t are never ambiguous, whatever type they are defined as
+        ///
+        void value(int i);
+
+        ///
+        /// \overload   value(unsigned int u)
+        ///
+        void value(unsigned int u);
+
+        ///
+        /// \overload   value(long i)
+        ///
+        void value(long i);
+
+        ///
+        /// \overload   value(unsigned long u)
+        ///
+        void value(unsigned long u);
+
+        ///
+        /// \overload   value(long long i)
+        ///
+        void value(long long i);
+
+        ///
+        /// \overload   value(unsigned long long u)
+        ///
+        void value(unsigned long long u);
+
+        ///
+        /// \overload   value(double d)
+        /// \brief      Print a double in the shortest text converting back to it
+        /// \note       Infinity and nan are printed as null
+        ///
+        void value(double d);
+
+        ///
+        /// \overload   value(const json_value *elem)
+        /// \brief      Print a json element and all its children
+        ///
+        void value(const json_value *elem);
+
+        ///
+        /// \fn         null
+        /// \brief      Print null
+        ///
+        void null();
+
+        ///
+        /// \fn         get_depth
+        /// \brief      Return the number of objects and arrays open
+        ///
+        size_t get_depth() const;
+
+        ///
+        /// \fn         is_complete
+        /// \brief      If a value is printed at the top level and everything is closed
+        ///
+        bool is_complete() const;
+
+    private:
+        ///
+        /// \fn         begin_value
+        /// \brief      Print what comes before a value: ',', newline and indentation
+        /// \param      indent  If the indentation of an element is printed
+        /// \return     true if the value is the value of a pair
+        ///
+        bool begin_value(bool indent);
+
+        ///
+        /// \fn         begin_container
+        /// \brief      Open an object or array
+        ///
+        void begin_container(bool object);
+
+        ///
+        /// \fn         end_container
+        /// \brief      Close an object or array
+        ///
+        void end_container(bool object);
+
+        ///
+        /// \fn         write_scalar
+        /// \brief      Print a string, number, true, false or null
+        ///
+        void write_scalar(const char *str, size_t length, bool quoted);
+
+        ///
+        /// \fn         write_number
+        /// \brief      Print a native number
+        ///
+        void write_number(const json_number &number);
+
+    private:
+        ///
+        /// \struct frame
+        /// \brief  An object or array open
+        ///
+        struct frame
+        {
+            bool object;        ///< an object or an array
+            bool opened;        ///< if '{' or '[' is printed, the value of a pair waits for its first child
+            bool has_key;       ///< if the key of a pair is printed and its value is not
+            size_t count;       ///< the pairs or elements printed
+            int level;          ///< the levels of indentation of '{' or '['
+        };
+
+        json_buffer &out;               ///< the buffer to print into
+        json_format format;             ///< how to print
+        json_serializer printer;        ///< the printer of json_value and strings
+        std::vector<frame> stack;       ///< the objects and arrays open
+        int indent_level;               ///< the levels of indentation of the top level
+        size_t top_count;               ///< the values printed at the top level
+    };
+}
+
+#endif // JSON_LITE_WRITER
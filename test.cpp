@@ -1,108 +1,1187 @@
+#include <clocale>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
 #include <iostream>
+#include <sstream>
+#include <vector>
 #include "src/json_lite.h"
+#include "src/json_tape.h"
+#include "src/json_cursor.h"
+#include "src/json_parallel.h"
+#include "src/json_serializer.h"
+#include "src/json_writer.h"
+#include "src/json_push.h"
+#include "src/json_reader.h"
+#include "src/json_stats.h"
+#include "src/json_pointer.h"
+#include "src/json_projection.h"
 
 using namespace std;
 using namespace json_lite;
 
-void test(string);
-string get_filename(string);
+string test_dir = "tests";    // the json_checker files, or the first argument
+int failures = 0;             // the checks failed
+
+bool test(string);
+void check(bool ok, const string &what);
+string to_text(const json_value *value);
 void test_locate_label();
 void test_get_by_label();
+void test_parse_memory();
+void test_parse_indexed();
+void test_document();
+void test_deep_nesting();
+void test_tape();
+void test_get_member();
+void test_numbers();
+void test_escapes();
+void test_key_interning();
+void test_sax();
+void test_cursor();
+void test_ndjson();
+void test_parallel_ndjson();
+void test_parallel_array();
+void test_serializer();
+void test_writer();
+void test_push();
+void test_reader();
+void test_compressed();
+void test_parse_result();
+void test_error_position();
+void test_stats();
+void test_json_pointer();
+void test_projection();
 
 int main(int argc, char** argv)
 {
+    if (argc > 1)
+        test_dir = argv[1];
+
     //get_child_by_label
     test_get_by_label();
-    system("pause");
-    return 0;
 
+    //parse json text in memory
+    test_parse_memory();
+
+    //parse json text with the structural index
+    test_parse_indexed();
+
+    //parse json into an arena reused by every parse
+    test_document();
+
+    //deep and long json without recursion
+    test_deep_nesting();
+
+    //read-only tape
+    test_tape();
+
+    //get_member
+    test_get_member();
+
+    //native numbers
+    test_numbers();
+
+    //decoded strings
+    test_escapes();
+
+    //repeated labels share one copy
+    test_key_interning();
+
+    //events without a tree
+    test_sax();
+
+    //pull the fields needed
+    test_cursor();
+
+    //a json per line
+    test_ndjson();
+
+    //a json per line on many threads
+    test_parallel_ndjson();
+
+    //a large array on many threads
+    test_parallel_array();
+
+    //print into a buffer
+    test_serializer();
+
+    //print without a tree
+    test_writer();
+
+    //json fed in chunks
+    test_push();
+
+    //read a file ahead of the parse
+    test_reader();
+
+    //gzip and zstd streams
+    test_compressed();
+
+    //errors given back instead of printed
+    test_parse_result();
+
+    //the same position of an error from a file, a reader and memory
+    test_error_position();
+
+    //what the parser does
+    test_stats();
+
+    //JSON Pointer
+    test_json_pointer();
+
+    //some paths extracted in one pass
+    test_projection();
 
     //locate_element_by_label
     test_locate_label();
     cout << endl;
 
-    // supposed to be passed 
+    // supposed to be passed
+    char name[20];
+    for (int i = 1; i <= 3; i++)
+    {
+        sprintf(name, "pass%d.json", i);
+        if (!test(test_dir + "/" + name))
+            failures++;
+    }
+
+    // supposed to be failed
+    for (int i = 1; i <= 33; i++)
+    {
+        sprintf(name, "fail%d.json", i);
+        if (test(test_dir + "/" + name))
+            failures++;
+    }
+
+    cout << failures << " of the tests failed" << endl;
+    return failures ? 1 : 0;
+}
+
+bool test(string input)
+{
+    cout << "parsing " << input << " :" << endl;
     try
     {
-        test("tests\\pass1.json");
-        test("tests\\pass2.json");
-        test("tests\\pass3.json");
+        // the depth of nesting of json_checker, fail18.json is deeper
+        json_parser parser(input);
+        parser.set_max_depth(19);
+        json_value *doc = parser.run();
+        if (doc)
+        {
+            delete doc;
+            cout << "successful~\n" << endl;
+            return true;
+        }
     }
     catch (const char* errmsg)
     {
         cout << errmsg << endl;
     }
-    
-    // supposed to be failed 
-    char temp[20];
-    for (int i = 1; i <= 33; i++)
+    cout << endl;
+    return false;
+}
+
+// check, counting a check failed into failures
+void check(bool ok, const string &what)
+{
+    if (ok)
+        return;
+    cout << "FAILED: " << what << endl;
+    failures++;
+}
+
+// to_text, the compact json of an element, "NULL" for none
+string to_text(const json_value *value)
+{
+    if (!value)
+        return "NULL";
+    ostringstream stream;
+    stream << *value;
+    return stream.str();
+}
+
+
+void test_locate_label()
+{
+    json_parser parser(test_dir + "/pass1.json");
+    parser.locate_element_by_label("integer");
+
+    string next;
+    for (int i = 0; i < 10; i++)
+        next += parser.get_char();
+    cout << "The next 10 characters: " << next << endl;
+    check(next == "1234567890", "locate_element_by_label");
+}
+
+
+void test_get_by_label()
+{
+    json_parser parser(test_dir + "/pass1.json");
+    json_value *doc = parser.run();
+    check(doc != NULL, "parse pass1.json");
+    if (doc)
+    {
+        json_value* elem = doc->get_child_by_label("object with 1 member");
+        check(elem && to_text(elem) == "[\"array with 1 element\"]", "get_child_by_label");
+        delete doc;
+    }
+}
+
+
+void test_parse_memory()
+{
+    const char text[] = "{\"name\": \"json_lite\", \"tags\": [1, 2, 3]}";
+    json_parser parser(text, sizeof(text) - 1);
+    json_value *doc = parser.run();
+    check(to_text(doc) == "{\"name\":\"json_lite\",\"tags\":[1,2,3]}", "parse from memory");
+    delete doc;
+}
+
+
+void test_parse_indexed()
+{
+    const char text[] = "[\"escaped \\\" quote\", {\"a\": [true, false, null]}, -1.5e3]";
+    json_parser parser(text, sizeof(text) - 1);
+    json_value *doc = parser.run_indexed();
+    check(to_text(doc) == "[\"escaped \\\" quote\",{\"a\":[true,false,null]},-1500.0]", "run_indexed");
+    delete doc;
+
+    // the same result as run(), for every prefix of a json and some errors
+    const string valid = "{\"a\": [1, -2.5e3, \"s\\\"]\"], \"b\": {\"c\": true, \"d\": null}, \"e\": false}";
+    vector<string> texts;
+    for (size_t i = 0; i <= valid.size(); i++)
+        texts.push_back(valid.substr(0, i));
+    const char *errors[] = {"{\"a\" \"b\"}", "{ \"", "[1 2]", "[1,]", "{\"a\":}", "[tru]", "[1x]", "{1: 2}",
+        "[\"a\\u12\"]", "[01]", "[1] 2", "[\"\t\"]", "{\"a\": 1,}", "[,1]", "\"a\"", "[\"a\" : 1]"};
+    texts.insert(texts.end(), errors, errors + sizeof(errors) / sizeof(errors[0]));
+    for (size_t i = 0; i < texts.size(); i++)
+    {
+        json_parse_result results[2];
+        json_parser serial(texts[i].data(), texts[i].size()),
+                    indexed(texts[i].data(), texts[i].size());
+        json_value *docs[2] = {serial.run(results[0]), indexed.run_indexed(results[1])};
+        check(to_text(docs[0]) == to_text(docs[1]) && results[0].failed == results[1].failed
+            && results[0].error == results[1].error && results[0].offset == results[1].offset,
+            "run_indexed as run() for " + texts[i]);
+        delete docs[0];
+        delete docs[1];
+    }
+}
+
+
+void test_document()
+{
+    const char text[] = "{\"id\": 1, \"names\": [\"a\", \"b\"]}";
+    json_document document;
+    size_t capacity = 0;
+    for (int i = 0; i < 3; i++)
+    {
+        json_parser parser(text, sizeof(text) - 1);
+        json_value *doc = document.parse(parser);
+        check(to_text(doc) == "{\"id\":1,\"names\":[\"a\",\"b\"]}", "json_document::parse");
+        if (i == 0)
+            capacity = document.get_arena().get_capacity();
+    }
+    // the arena is reused, not grown
+    check(document.get_arena().get_capacity() == capacity, "the arena is reused");
+}
+
+
+void test_deep_nesting()
+{
+    string deep = string(100000, '[') + string(100000, ']');
+    json_parser parser(deep.c_str(), deep.size());
+    json_value *doc = parser.run();
+    check(doc != NULL, "100000 nested arrays");
+    delete doc;
+
+    // the same json fails fast with a max depth
+    json_parser limited(deep.c_str(), deep.size());
+    limited.set_max_depth(20);
+    json_parse_result result;
+    doc = limited.run(result);
+    check(!doc && result.error == TOO_DEEP_NESTING && result.offset == 21, "max depth 20");
+    delete doc;
+}
+
+
+void test_tape()
+{
+    const char text[] = "{\"id\": 1, \"names\": [\"a\", \"b\"], \"empty\": {}}";
+    json_parser parser(text, sizeof(text) - 1);
+    json_tape tape;
+    check(tape.parse(parser), "json_tape::parse");
+
+    json_tape_value root = tape.get_root();
+    check(root.get_type() == JSON_OBJECT, "the tape root");
+    check(root.get_child_by_label("id").get_value() == "1", "the tape label \"id\"");
+    string names;
+    json_tape_value array = root.get_child_by_label("names");
+    for (json_tape_value elem = array.get_first_child(); elem.is_valid(); elem = elem.get_next())
+        names += elem.get_value() + " ";
+    check(names == "a b ", "the tape array");
+    check(!root.get_child_by_label("empty").get_first_child().is_valid(), "the tape empty object");
+    check(!root.get_child_by_label("none").is_valid(), "the tape missing label");
+    check(tape.get_size() == 12, "the words of the tape");
+
+    // the same words as a tape built from the tree, numbers keep their text
+    const char nested[] = "[{\"a\": [1, {\"b\": null}], \"c\": \"x\"}, [], [[true, false]], -2.50]";
+    json_parser tree_parser(nested, sizeof(nested) - 1);
+    json_value *doc = tree_parser.run();
+    json_tape built;
+    built.build(doc);
+    delete doc;
+    json_parser tape_parser(nested, sizeof(nested) - 1);
+    check(tape.parse(tape_parser) && tape.get_size() == built.get_size(), "the tape parsed as the tape built");
+    json_tape_value parsed_elem = tape.get_root().get_first_child(),
+                    built_elem = built.get_root().get_first_child();
+    check(parsed_elem.get_child_by_label("b").get_type() == JSON_NULL
+        && parsed_elem.get_next().get_next().get_first_child().get_first_child().get_next().get_type() == JSON_FALSE
+        && built_elem.get_child_by_label("c").get_value() == parsed_elem.get_child_by_label("c").get_value(),
+        "the elements of the tape parsed");
+    check(parsed_elem.get_next().get_next().get_next().get_value() == "-2.50", "a number of the tape");
+
+    // the numbers converted like json_value does
+    json_tape_value number = parsed_elem.get_next().get_next().get_next();
+    check(!number.is_integer() && number.get_double() == -2.5 && number.get_int64() == -2,
+        "the double of a tape number");
+    json_tape_value integer = parsed_elem.get_first_child().get_first_child().get_first_child();
+    check(integer.is_integer() && integer.get_number_type() == NUMBER_INT64 && integer.get_int64() == 1
+        && integer.get_uint64() == 1 && integer.get_double() == 1.0, "the integer of a tape number");
+
+    // a string value equal to the label comes first, like json_value::get_child_by_label
+    const char strings[] = "[\"id\", {\"id\": 1}]";
+    json_parser strings_parser(strings, sizeof(strings) - 1);
+    json_parser strings_tree(strings, sizeof(strings) - 1);
+    doc = strings_tree.run();
+    check(tape.parse(strings_parser) && !tape.get_root().get_child_by_label("id").is_valid()
+        && doc && !doc->get_child_by_label("id"), "a string value before the label in the tape");
+    delete doc;
+
+    // an error leaves the tape empty
+    const char bad[] = "{\"id\": [1, 2}";
+    json_parser other(bad, sizeof(bad) - 1);
+    json_parse_result result;
+    check(!tape.parse(other, result) && result.error == INVALID_CHARACTER && !tape.get_root().is_valid(),
+        "the tape of a json with an error");
+}
+
+
+void test_get_member()
+{
+    const char text[] = "{\"nested\": {\"id\": 2}, \"a\": 1, \"b\": 2, \"c\": 3, \"d\": 4,"
+                        " \"e\": 5, \"f\": 6, \"g\": 7, \"id\": 1}";
+    json_parser parser(text, sizeof(text) - 1);
+    json_value *doc = parser.run();
+    check(doc != NULL, "parse for get_member");
+    if (doc)
+    {
+        // get_child_by_label finds the nested one first, get_member does not
+        check(doc->get_child_by_label("id")->get_value() == "2", "get_child_by_label searches the subtree");
+        check(doc->get_member("id")->get_value() == "1", "get_member");
+        doc->add_pair("h", new json_value(JSON_NUMBER, "8"));
+        check(doc->get_member("h") && doc->get_member("h")->get_value() == "8", "get_member after add_pair");
+        check(doc->get_member("x") == NULL, "get_member of a missing label");
+        delete doc;
+    }
+}
+
+
+void test_numbers()
+{
+    const char text[] = "[42, -9223372036854775808, 18446744073709551615, 0.1, 1.5e300, 1e400]";
+    json_parser parser(text, sizeof(text) - 1);
+    json_value *doc = parser.run();
+    check(doc != NULL, "parse numbers");
+    if (!doc)
+        return;
+
+    json_value *elem = doc->get_first_child();
+    check(elem->is_integer() && elem->get_int64() == 42, "42");
+    elem = elem->get_next();
+    check(elem->is_integer() && elem->get_int64() == INT64_MIN, "INT64_MIN");
+    elem = elem->get_next();
+    check(elem->is_integer() && elem->get_uint64() == UINT64_MAX, "UINT64_MAX");
+    elem = elem->get_next();
+    check(!elem->is_integer() && elem->get_double() == 0.1, "0.1");
+    elem = elem->get_next();
+    check(elem->get_double() == 1.5e300, "1.5e300");
+    elem = elem->get_next();
+    check(elem->get_value() == "1e400", "a number out of the range of double keeps its text");
+    check(to_text(doc) == "[42,-9223372036854775808,18446744073709551615,0.1,1.5e+300,1e400]",
+        "numbers printed");
+    delete doc;
+
+    // correctly rounded past the fast path: halfway cases, the smallest
+    // normal and subnormal doubles, and more digits than a double has
+    const char hard[] = "[9007199254740993.0, 2.2250738585072011e-308, 4.9406564584124654e-324,"
+                        " 2.4703282292062328e-324, 1.7976931348623157e308, 8.533e68,"
+                        " 0.1000000000000000055511151231257827021181583404541015625000001]";
+    json_parser hard_parser(hard, sizeof(hard) - 1);
+    doc = hard_parser.run();
+    check(doc != NULL, "parse numbers past the fast path");
+    if (!doc)
+        return;
+    const double expected[] = {9007199254740992.0, 2.2250738585072009e-308, 4.9406564584124654e-324,
+                               4.9406564584124654e-324, 1.7976931348623157e308, 8.533e68, 0.1};
+    elem = doc->get_first_child();
+    for (size_t i = 0; elem; elem = elem->get_next(), i++)
+        check(elem->get_double() == expected[i], "number rounded " + elem->get_value());
+
+    // the same text in a locale with a decimal comma, if there is one
+    if (setlocale(LC_ALL, "de_DE.UTF-8") || setlocale(LC_ALL, "de_DE") || setlocale(LC_ALL, "fr_FR.UTF-8"))
+    {
+        json_parser locale_parser(hard, sizeof(hard) - 1);
+        json_value *other = locale_parser.run();
+        check(other && to_text(other) == to_text(doc), "numbers in a locale with a decimal comma");
+        delete other;
+        setlocale(LC_ALL, "C");
+    }
+    check(to_text(doc) == "[9007199254740992.0,2.225073858507201e-308,4.94065645841247e-324,"
+        "4.94065645841247e-324,1.7976931348623157e+308,8.533e+68,0.1]", "numbers rounded printed");
+    delete doc;
+
+    // 17 to 20 significant digits, like the floats of telemetry, the same as strtod
+    const char *floats[] = {"-73.985678100000005", "40.748440000000002", "179.99999999999997",
+                            "1.0000000000000002", "7.2057594037927933e16", "2.9999999999999996e-300",
+                            "123456789012345678.9", "0.30000000000000004441"};
+    for (size_t i = 0; i < sizeof(floats) / sizeof(floats[0]); i++)
+    {
+        json_number number;
+        check(to_number(floats[i], strlen(floats[i]), number) && number.type == NUMBER_DOUBLE
+            && number.d == strtod(floats[i], NULL), string("number rounded ") + floats[i]);
+    }
+
+    // -0 keeps its sign
+    const char zero[] = "[-0]";
+    json_parser zero_parser(zero, sizeof(zero) - 1);
+    doc = zero_parser.run();
+    check(doc && !doc->get_first_child()->is_integer() && to_text(doc) == "[-0.0]", "-0");
+    delete doc;
+}
+
+
+void test_escapes()
+{
+    const char text[] = "[\"tab\\there\", \"\\u00e9\\ud83d\\ude00\"]";
+    json_parser parser(text, sizeof(text) - 1);
+    json_value *doc = parser.run();
+    check(doc != NULL, "parse escapes");
+    if (doc)
+    {
+        check(doc->get_first_child()->get_value() == "tab\there", "\\t decoded");
+        check(doc->get_last_child()->get_value() == "\xc3\xa9\xf0\x9f\x98\x80", "\\u and a surrogate pair decoded");
+        check(to_text(doc) == "[\"tab\\there\",\"\xc3\xa9\xf0\x9f\x98\x80\"]", "escapes printed");
+        delete doc;
+    }
+}
+
+
+void test_key_interning()
+{
+    const char text[] = "[{\"id\": 1, \"name\": \"a\"}, {\"id\": 2, \"name\": \"b\"},"
+                        " {\"id\": 3, \"name\": \"c\", \"tag\": \"id\"}]";
+    json_parser parser(text, sizeof(text) - 1);
+    json_document document;
+    json_value *doc = document.parse(parser);
+    check(doc != NULL, "parse with interned labels");
+    if (doc)
+    {
+        check(document.get_key_table().get_size() == 3, "different labels");
+        check(doc->get_last_child()->get_member("name")->get_value() == "c", "get_member of an interned label");
+    }
+}
+
+
+///
+/// \class  id_finder
+/// \brief  Find the first "id" and stop the parse
+///
+class id_finder : public json_handler
+{
+public:
+    id_finder() :found(false), next_is_id(false) {}
+
+    bool on_key(const string &key)
+    {
+        next_is_id = key == "id";
+        return true;
+    }
+
+    bool on_number(const string &text)
+    {
+        if (!next_is_id)
+            return true;
+        id = text;
+        found = true;
+        return false;  //stop
+    }
+
+    bool found;
+    bool next_is_id;
+    string id;
+};
+
+void test_sax()
+{
+    const char text[] = "{\"name\": \"a\", \"id\": 42, \"rest\": [1, 2, 3]}";
+    json_parser parser(text, sizeof(text) - 1);
+    id_finder finder;
+    check(parser.run(finder) && finder.found && finder.id == "42", "run(handler) stopped at the id");
+}
+
+
+void test_cursor()
+{
+    const char text[] = "{\"payload\": {\"big\": [1, [2, \"]\"]]}, \"id\": 42, \"tags\": [\"a\", \"b\"]}";
+    json_parser parser(text, sizeof(text) - 1);
+    json_cursor cursor(parser);
+    string id, tags;
+    if (cursor.enter_object())
     {
-        memset(temp, 0, 20);
-        sprintf(temp, "tests\\fail%d.json", i);
-        try
+        while (cursor.next_token() == TOKEN_KEY)
         {
-            test(temp);
+            const string &key = cursor.get_value();
+            if (key == "id" && cursor.next_token() == TOKEN_NUMBER)
+                id = cursor.get_value();
+            else if (key == "tags" && cursor.enter_array())
+            {
+                while (cursor.next_token() == TOKEN_STRING)
+                    tags += cursor.get_value();
+            }
+            else
+                cursor.skip_value();
         }
-        catch (const char* errmsg)
+    }
+    check(id == "42" && tags == "ab", "json_cursor");
+    check(cursor.next_token() == TOKEN_END, "json_cursor at the end");
+
+    // an error is given back and not printed
+    const char bad[] = "{\"id\": [1, }";
+    json_parser bad_parser(bad, sizeof(bad) - 1);
+    json_cursor bad_cursor(bad_parser);
+    ostringstream printed;
+    streambuf *out = cout.rdbuf(printed.rdbuf());
+    bad_cursor.enter_object();
+    json_token token = bad_cursor.next_token();
+    if (token == TOKEN_KEY && bad_cursor.enter_array())
+        while ((token = bad_cursor.next_token()) == TOKEN_NUMBER)
+            ;
+    cout.rdbuf(out);
+    check(token == TOKEN_ERROR && bad_cursor.get_result().failed
+        && bad_cursor.get_result().error == INVALID_CHARACTER && printed.str().empty(), "json_cursor error result");
+}
+
+
+void test_ndjson()
+{
+    const char text[] = "{\"id\": 1}\n{\"id\": tru}\n[2, 3]\n{\"id\": 4}\n";
+    json_parser parser(text, sizeof(text) - 1);
+    json_document document;
+    string docs;
+    int errors = 0;
+    while (!parser.is_end())
+    {
+        json_value *doc = document.parse_next(parser);
+        if (doc)
+            docs += to_text(doc) + "\n";
+        else
+            errors++;
+    }
+    check(docs == "{\"id\":1}\n[2,3]\n{\"id\":4}\n" && errors == 1, "NDJSON with an error");
+
+    // a json cut short doesn't take the next line with it, in memory, from a
+    // file, and from a reader whose blocks end inside the json
+    const char cut[] = "{\"a\":1\n{\"b\":2}\n{\"c\":3}\n{\"d\": [1, 2, 3, 4, 5, 6\n[7]\n";
+    {
+        ofstream file("ndjson.json");
+        file << cut;
+    }
+    json_reader reader("ndjson.json", 5, false);
+    json_parser memory_parser(cut, sizeof(cut) - 1),
+                file_parser("ndjson.json"),
+                reader_parser(reader);
+    json_parser *parsers[] = {&memory_parser, &file_parser, &reader_parser};
+    for (int i = 0; i < 3; i++)
+    {
+        docs.clear();
+        json_parse_result result;
+        int lines = 0;
+        while (!parsers[i]->is_end())
         {
-            cout << errmsg << endl;
+            json_value *doc = parsers[i]->next_document(result);
+            docs += doc ? to_text(doc) + "\n" : "";
+            lines = result.failed ? lines * 10 + result.line : lines;
+            delete doc;
         }
+        check(docs == "{\"b\":2}\n{\"c\":3}\n[7]\n" && lines == 25, "NDJSON with a json cut short");
+    }
+    remove("ndjson.json");
+}
+
+
+///
+/// \class  id_summer
+/// \brief  Sum the "id" of every record
+///
+class id_summer : public json_record_handler
+{
+public:
+    id_summer() :sum(0) {}
+
+    bool on_record(json_value *record)
+    {
+        json_value *id = record->get_member("id");
+        if (id)
+            sum += id->get_int64();
+        return true;
+    }
+
+    int64_t sum;
+};
+
+void test_parallel_ndjson()
+{
+    string text;
+    for (int i = 1; i <= 1000; i++)
+    {
+        ostringstream line;
+        line << "{\"id\": " << i << ", \"tags\": [\"a\", \"b\"]}\n";
+        text += line.str();
     }
 
-    system("pause");
-    return 0;
+    json_parallel_reader reader(4, 1024);
+    id_summer summer;
+    reader.run(text.data(), text.size(), summer);
+    check(reader.get_records() == 1000 && summer.sum == 500500, "json_parallel_reader");
+
+    // the errors are given back in order, at their place in the whole input
+    text.replace(text.find("{\"id\": 10,"), 1, "[");
+    text.replace(text.find("{\"id\": 700,"), 1, "x");
+    json_parser parser(text.data(), text.size());
+    json_parse_result result;
+    vector<json_parse_result> expected;
+    while (!parser.is_end())
+    {
+        json_value *record = parser.next_document(result);
+        if (record)
+            delete record;
+        else
+            expected.push_back(result);
+    }
+
+    ostringstream printed;
+    streambuf *out = cout.rdbuf(printed.rdbuf());
+    reader.run(text.data(), text.size(), summer);
+    cout.rdbuf(out);
+    const vector<json_parse_result> &failures = reader.get_error_results();
+    bool same = failures.size() == 2 && expected.size() == 2;
+    for (size_t i = 0; same && i < failures.size(); i++)
+        same = failures[i].error == expected[i].error && failures[i].offset == expected[i].offset
+            && failures[i].line == expected[i].line && failures[i].column == expected[i].column;
+    check(same && reader.get_errors() == 2 && reader.get_records() == 998 && printed.str().empty(),
+        "json_parallel_reader error results");
 }
 
-void test(string input)
+
+void test_parallel_array()
 {
-    cout << "parsing " << input << " :" << endl;
-    string output = "output\\";
-    json_parser parser(input);
+    string text = "[";
+    for (int i = 1; i <= 20000; i++)
+    {
+        ostringstream element;
+        element << (i > 1 ? ", " : "") << "{\"id\": " << i << ", \"name\": \"a, [b]\"}";
+        text += element.str();
+    }
+    text += "]";
+
+    json_parser parser(text.data(), text.size());
+    json_value *doc = parser.run_parallel(4);
+    check(doc != NULL, "run_parallel");
+    if (doc)
+    {
+        int64_t count = 0, sum = 0;
+        for (json_value *elem = doc->get_first_child(); elem; elem = elem->get_next(), count++)
+            sum += elem->get_member("id")->get_int64();
+        check(count == 20000 && sum == 200010000, "the elements of run_parallel in order");
+        check(doc->get_last_child()->get_member("name")->get_value() == "a, [b]", "a string cut by run_parallel");
+        delete doc;
+    }
+    check(parser.get_parallel_ranges() > 1, "run_parallel on many threads");
+
+    // into an arena and a key table, the labels interned once for every range
+    json_arena arena;
+    json_key_table keys(arena);
+    json_parser arena_parser(text.data(), text.size());
+    arena_parser.set_arena(&arena);
+    arena_parser.set_key_table(&keys);
+    doc = arena_parser.run_parallel(4);
+    check(doc && arena_parser.get_parallel_ranges() > 1 && keys.get_size() == 2, "run_parallel with an arena and a key table");
+    if (doc)
+    {
+        json_value *last = doc->get_last_child();
+        check(doc->get_arena() == &arena && last->get_arena() == &arena
+            && last->get_member("id")->get_arena() == &arena
+            && last->get_member("id")->get_int64() == 20000,
+            "the elements of run_parallel in the arena");
+    }
+
+    // an error inside a range, with the elements of the ranges in their arenas
+    string literal = text;
+    literal.replace(literal.find("{\"id\": 10000,") + 7, 5, "tru  ");
+    json_parser literal_parser(literal.data(), literal.size());
+    literal_parser.set_arena(&arena);
+    literal_parser.set_key_table(&keys);
+    json_parse_result result;
+    check(!literal_parser.run_parallel(result, 4) && result.failed && result.error == ERROR_IN_TRUE,
+        "an error of run_parallel in an arena");
+
+    // an error is found again by run() on this thread
+    text[text.size() / 2] = '}';
+    json_parser bad_parser(text.data(), text.size());
+    check(!bad_parser.run_parallel(result, 4) && result.failed && bad_parser.get_parallel_ranges() == 0,
+        "an error of run_parallel");
+}
+
+
+void test_serializer()
+{
+    const char text[] = "{\"name\": \"json\\tlite\", \"tags\": [1, 2.5, {}], \"empty\": []}";
+    const char compact_text[] = "{\"name\":\"json\\tlite\",\"tags\":[1,2.5,{}],\"empty\":[]}";
+    json_parser parser(text, sizeof(text) - 1);
     json_value *doc = parser.run();
+    check(doc != NULL, "parse for json_serializer");
     if (doc)
     {
-        //doc->output(output + get_filename(input));
-        ofstream fout((output + get_filename(input)).c_str());
-        fout << *doc;
-        fout.close();
+        json_buffer buffer;
+        json_serializer compact(buffer, json_format(false));
+        compact.write(doc);
+        check(buffer.get_string() == compact_text, "json_serializer compact");
+
+        buffer.clear();
+        json_serializer pretty(buffer, json_format(true, ' ', 2));
+        pretty.write(doc);
+        check(buffer.get_string() == "{\n  \"name\": \"json\\tlite\",\n  \"tags\": \n  [\n    1,\n    2.5,\n"
+            "    {}\n  ],\n  \"empty\": []\n}", "json_serializer pretty");
+
+        ostringstream stream;
+        doc->output(stream, json_format(false));
+        check(stream.str() == compact_text, "json_value::output");
         delete doc;
-        doc = NULL;
-        cout << "successful~\n" << endl;
-        return;
     }
-    cout << endl;
 }
 
-string get_filename(string path)
+
+void test_writer()
 {
-    string::size_type pos = path.rfind('\\');
-    return string(path, pos + 1, string::npos);
+    json_buffer buffer;
+    json_writer writer(buffer, json_format(true, ' ', 2));
+    writer.begin_object();
+    writer.key("name");
+    writer.value("json\tlite");
+    writer.key("version");
+    writer.value(2.3);
+    writer.key("tags");
+    writer.begin_array();
+    for (int i = 1; i <= 3; i++)
+        writer.value(i);
+    writer.end_array();
+    writer.key("empty");
+    writer.begin_object();
+    writer.end_object();
+    writer.key("parsed");
+    writer.null();
+    writer.end_object();
+
+    // what is written parses back to the same json
+    string text = buffer.get_string();
+    json_parser parser(text.data(), text.size());
+    json_value *doc = parser.run();
+    check(to_text(doc) == "{\"name\":\"json\\tlite\",\"version\":2.3,\"tags\":[1,2,3],\"empty\":{},\"parsed\":null}",
+        "json_writer output");
+    delete doc;
+
+    // every integer type, without a cast
+    json_buffer integers;
+    json_writer integer_writer(integers, json_format(false));
+    integer_writer.begin_array();
+    integer_writer.value((short)-1);
+    integer_writer.value(2u);
+    integer_writer.value(-3L);
+    integer_writer.value(4UL);
+    integer_writer.value(-5LL);
+    integer_writer.value(18446744073709551615ULL);
+    integer_writer.value((size_t)7);
+    integer_writer.value((int64_t)INT64_MIN);
+    integer_writer.value((uint64_t)9);
+    integer_writer.end_array();
+    check(integers.get_string() == "[-1,2,-3,4,-5,18446744073709551615,7,-9223372036854775808,9]",
+        "json_writer integers");
 }
 
 
-void test_locate_label()
+void test_push()
 {
-    json_parser parser("tests\\pass1.json");
-    parser.locate_element_by_label("integer");
+    // the chunks end in a label, a number, a string, an escape character and true
+    const char *chunks[] = {"{\"na", "me\": \"js", "on\\u00", "e9 \\", "\"lite\\\"\", \"ids\": [1", "2, 3], \"ok\": tr", "ue}"};
+    json_push_parser parser;
+    json_push_status status = PUSH_NEED_MORE;
+    for (size_t i = 0; i < sizeof(chunks) / sizeof(chunks[0]); i++)
+        status = parser.feed(chunks[i], strlen(chunks[i]));
+    check(status == PUSH_DONE && parser.finish() == PUSH_DONE, "json_push_parser done");
 
-    cout << "The next 10 characters: ";
-    int i = 10;
-    while (i--)
-        cout << parser.get_char();
-    cout << endl;
+    json_value *doc = parser.release_root();
+    check(to_text(doc) == "{\"name\":\"json\xc3\xa9 \\\"lite\\\"\",\"ids\":[12,3],\"ok\":true}", "json_push_parser tree");
+    delete doc;
+
+    // an error is given back like run() gives it, and not printed
+    const char *bad[] = {"{\"ids\": [1, 2", "], \"ok\": tr", "ux}"};
+    string whole;
+    ostringstream printed;
+    streambuf *out = cout.rdbuf(printed.rdbuf());
+    parser.reset();
+    for (size_t i = 0; i < sizeof(bad) / sizeof(bad[0]); i++)
+    {
+        status = parser.feed(bad[i], strlen(bad[i]));
+        whole += bad[i];
+    }
+    cout.rdbuf(out);
+    json_parser whole_parser(whole.data(), whole.size());
+    json_parse_result expected;
+    delete whole_parser.run(expected);
+    const json_parse_result &result = parser.get_result();
+    check(status == PUSH_ERROR && result.failed && result.error == ERROR_IN_TRUE
+        && result.error == expected.error && result.offset == expected.offset
+        && printed.str().empty() && !parser.release_root(), "json_push_parser error result");
+
+    // the same result as run(), for texts fed in random chunks: the cases found
+    // before, then texts joined from pieces
+    vector<string> corpus;
+    corpus.push_back("[f-alse]");
+    corpus.push_back("[t}ue]");
+    corpus.push_back("[nu l]");
+    corpus.push_back(string("[1\0]", 4));
+    corpus.push_back(string("[-\0]", 4));
+    const char *pieces[] = {"{", "}", "[", "]", ",", ":", " ", "\n", "\"a\"", "\"\\u12g\"", "\"\\x\"",
+                            "1", "-2.5e3", "01", "1.2.3", "1e", "--1", "tru", "true", "null", "fals",
+                            "f", "t", "n", "-", "alse", "ue", "l", "e", ".", "x", "\""};
+    size_t count = sizeof(pieces) / sizeof(pieces[0]);
+    unsigned int seed = 17;
+    for (int i = 0; i < 3000; i++)
+    {
+        string text;
+        for (int k = 0; k < 10; k++)
+        {
+            seed = seed * 1103515245 + 12345;
+            text += (seed >> 16) % 13 == 0 ? string(1, '\0') : string(pieces[(seed >> 16) % count]);
+        }
+        corpus.push_back(text);
+    }
+
+    bool same = true;
+    for (size_t i = 0; i < corpus.size(); i++)
+    {
+        const string &text = corpus[i];
+        json_parser whole_text(text.data(), text.size());
+        delete whole_text.run(expected);
+
+        parser.reset();
+        status = PUSH_NEED_MORE;
+        for (size_t pos = 0; pos < text.size() && (status == PUSH_NEED_MORE || status == PUSH_DONE); )
+        {
+            seed = seed * 1103515245 + 12345;
+            size_t length = min(text.size() - pos, (size_t)(seed >> 16) % 5 + 1);
+            status = parser.feed(text.data() + pos, length);
+            pos += length;
+        }
+        if (status == PUSH_NEED_MORE || status == PUSH_DONE)
+            parser.finish();
+        delete parser.release_root();
+
+        const json_parse_result &pushed = parser.get_result();
+        if (pushed.failed != expected.failed || (expected.failed && (pushed.error != expected.error
+            || pushed.offset != expected.offset || pushed.line != expected.line || pushed.column != expected.column)))
+        {
+            cout << "json_push_parser differs from run() for " << text << endl;
+            same = false;
+        }
+    }
+    check(same, "json_push_parser errors the same as run()");
 }
 
 
-void test_get_by_label()
+void test_reader()
 {
-    json_parser parser("tests\\pass1.json");
+    {
+        ofstream file("reader.json");
+        file << "[";
+        for (int i = 1; i <= 1000; i++)
+            file << (i > 1 ? ", " : "") << "{\"id\": " << i << ", \"name\": \"reader\"}";
+        file << "]";
+    }
+
+    // small blocks, so that strings and numbers are cut between blocks
+    json_reader reader("reader.json", 100);
+    json_parser parser(reader);
     json_value *doc = parser.run();
+    check(doc != NULL, "parse from json_reader");
     if (doc)
     {
-        json_value* elem = doc->get_child_by_label("object with 1 member");
-        if (elem != NULL)
-            elem->output();
+        int64_t count = 0, sum = 0;
+        for (json_value *elem = doc->get_first_child(); elem; elem = elem->get_next(), count++)
+            sum += elem->get_member("id")->get_int64();
+        check(count == 1000 && sum == 500500, "the elements read by json_reader");
         delete doc;
     }
-    cout << endl;
-}
\ No newline at end of file
+    remove("reader.json");
+}
+
+
+void test_compressed()
+{
+    const json_compression compressions[] = {COMPRESS_GZIP, COMPRESS_ZSTD};
+    const char *names[] = {"gzip", "zstd"};
+    for (int k = 0; k < 2; k++)
+    {
+        if (!is_compression_supported(compressions[k]))
+        {
+            cout << names[k] << ": not compiled in" << endl;
+            continue;
+        }
+
+        {
+            ofstream file("compressed.json", ios::binary);
+            json_buffer buffer(file, compressions[k]);
+            json_writer writer(buffer, json_format(false));
+            writer.begin_array();
+            for (int i = 1; i <= 1000; i++)
+            {
+                writer.begin_object();
+                writer.key("id");
+                writer.value(i);
+                writer.end_object();
+            }
+            writer.end_array();
+        }
+
+        json_reader reader("compressed.json", 100);
+        json_parser parser(reader);
+        json_value *doc = parser.run();
+        check(doc != NULL, string("parse ") + names[k]);
+        if (doc)
+        {
+            int64_t count = 0, sum = 0;
+            for (json_value *elem = doc->get_first_child(); elem; elem = elem->get_next(), count++)
+                sum += elem->get_member("id")->get_int64();
+            check(count == 1000 && sum == 500500, string("the elements of ") + names[k]);
+            check(reader.get_compression() == compressions[k] && reader.is_good(), string("the stream of ") + names[k]);
+            delete doc;
+        }
+        remove("compressed.json");
+    }
+}
+
+
+void test_parse_result()
+{
+    const char *texts[] = {
+        "{\"id\": 1, \"tags\": [\"a\", \"b\"]}",
+        "{\"id\": 1,\n \"tags\": [\"a\", \"b\",]}",
+        "{\"id\": 01}",
+        "[1, 2] x",
+        "[nul]"
+    };
+    // the error, line, column and offset of each, -1 for none
+    const int expected[][4] = {
+        {-1, 0, 0, 0},
+        {EXTRA_COMMA, 2, 20, 29},
+        {LEADING_ZERO, 1, 9, 8},
+        {EXTRA_CONTENT_AFTER_JSON, 1, 8, 7},
+        {ERROR_IN_NULL, 1, 6, 5}
+    };
+    for (size_t i = 0; i < sizeof(texts) / sizeof(texts[0]); i++)
+    {
+        json_parser parser(texts[i], strlen(texts[i]));
+        json_parse_result result;
+        json_value *doc = parser.run(result);
+        if (expected[i][0] < 0)
+            check(doc && !result.failed, string("no error in ") + texts[i]);
+        else
+            check(!doc && result.failed && result.error == expected[i][0] && result.line == expected[i][1]
+                && result.column == expected[i][2] && result.offset == (size_t)expected[i][3],
+                string("the error of ") + texts[i]);
+        delete doc;
+    }
+}
+
+
+void test_error_position()
+{
+    string text = "[\n";
+    for (int i = 0; i < 6000; i++)
+        text += "  {\"id\": 1},\n";
+    text += "  {\"id\": 01}\n]";
+    {
+        ofstream file("position.json", ios::binary);
+        file << text;
+    }
+
+    // the error is many buffers and blocks into the text
+    json_parse_result results[3];
+    {
+        json_parser parser("position.json");
+        delete parser.run(results[0]);
+    }
+    {
+        json_reader reader("position.json", 333);
+        json_parser parser(reader);
+        delete parser.run(results[1]);
+    }
+    {
+        json_parser parser(text.data(), text.size());
+        delete parser.run(results[2]);
+    }
+    const char *names[] = {"file", "reader", "memory"};
+    for (int i = 0; i < 3; i++)
+        check(results[i].error == LEADING_ZERO && results[i].line == 6002 && results[i].column == 11
+            && results[i].offset == 78012, string("the error position from ") + names[i]);
+    remove("position.json");
+
+    // a '\\0' in the text is not the end of input
+    const string nul("[1]\0", 4);
+    json_parser parser(nul.data(), nul.size());
+    json_parse_result result;
+    delete parser.run(result);
+    check(result.failed && result.error == EXTRA_CONTENT_AFTER_JSON, "a '\\0' after the json");
+}
+
+
+void test_stats()
+{
+    if (!is_stats_enabled())
+    {
+        cout << "stats: not compiled in" << endl;
+        return;
+    }
+
+    const char text[] = "{\"id\": 1, \"tags\": [\"a\", \"bc\"], \"ok\": true, \"next\": {\"pi\": 3.14, \"none\": null}}";
+    json_parse_stats stats;
+    json_parser parser(text, sizeof(text) - 1);
+    parser.set_stats(&stats);
+    delete parser.run();
+
+    check(stats.documents == 1 && stats.bytes == sizeof(text) - 1 && stats.max_depth == 2, "stats of the document");
+    const uint64_t values[JSON_TYPE_COUNT] = {2, 2, 2, 1, 1, 0, 1};  //by json_type
+    for (size_t i = 0; i < JSON_TYPE_COUNT; i++)
+        check(stats.values[i] == values[i], "stats of the values");
+    check(stats.labels == 6 && stats.string_bytes == 21 && stats.number_bytes == 5, "stats of labels and text");
+}
+
+
+void test_json_pointer()
+{
+    const char text[] = "{\"items\": [{\"id\": 1}, {\"id\": 2}, {\"id\": 3, \"a/b\": {\"m~n\": true}}], "
+        "\"\": 0, \"10\": \"ten\", \"id\": \"top\"}";
+    json_parser parser(text, sizeof(text) - 1);
+    json_value *doc = parser.run();
+    check(doc != NULL, "parse for json_pointer");
+    if (!doc)
+        return;
+
+    const char *pointers[][2] = {
+        {"/items/2/id", "3"},
+        {"/items/2/a~1b/m~0n", "true"},
+        {"/", "0"},
+        {"/10", "\"ten\""},
+        {"/id", "\"top\""},
+        {"/items/3", "NULL"},
+        {"/items/-", "NULL"},
+        {"/items/01", "NULL"},
+        {"/items/0/id/x", "NULL"},
+        {"items", "NULL"},
+        {"/a~2", "NULL"}
+    };
+    for (size_t i = 0; i < sizeof(pointers) / sizeof(pointers[0]); i++)
+        check(to_text(doc->get_pointer(pointers[i][0])) == pointers[i][1], string("the pointer ") + pointers[i][0]);
+    check(doc->get_pointer("") == doc, "the empty pointer");
+
+    // compiled once, resolved in every document
+    json_pointer id("/items/1/id");
+    int64_t sum = 0;
+    for (int i = 0; i < 3; i++)
+    {
+        json_parser other(text, sizeof(text) - 1);
+        json_value *copy = other.run();
+        sum += id.resolve(copy)->get_int64();
+        delete copy;
+    }
+    check(sum == 6, "a compiled pointer");
+    delete doc;
+}
+
+
+void test_projection()
+{
+    json_projection projection;
+    const char *paths[] = {"/user/id", "/items/1/price", "/tags", "/tags/0", "/a~1b", "/missing", "/user/id/x"};
+    for (size_t i = 0; i < sizeof(paths) / sizeof(paths[0]); i++)
+        projection.add_path(paths[i]);
+    check(!projection.add_path("user") && projection.size() == 7, "an invalid path is not added");
+
+    // the events skipped are not decoded, "{]" in a string is not a bracket
+    const char text[] =
+        "{\"skip\": {\"deep\": [1, {\"x\": \"{]\"}], \"id\": 0}, \"user\": {\"name\": \"ann\", \"id\": 7},"
+        " \"items\": [{\"price\": 1.5}, {\"price\": 2.5, \"note\": \"\\\"\"}], \"tags\": [\"a\", \"b\"], \"a/b\": null}\n"
+        "{\"user\": {\"id\": 8}, \"items\": [true]}\n"
+        "{\"user\": {\"id\": }}\n"
+        "[1, 2]\n";
+    const char *expected[] = {
+        "7|2.5|[\"a\",\"b\"]|\"a\"|null|NULL|NULL|",
+        "8|NULL|NULL|NULL|NULL|NULL|NULL|",
+        "error",
+        "NULL|NULL|NULL|NULL|NULL|NULL|NULL|"
+    };
+    json_parser parser(text, sizeof(text) - 1);
+    json_parse_result result;
+    size_t count = 0;
+    for (; !parser.is_end() && count < 4; count++)
+    {
+        string values = "error";
+        if (projection.next_document(parser, result))
+        {
+            values.clear();
+            for (size_t i = 0; i < projection.size(); i++)
+                values += to_text(projection.get_value(i)) + "|";
+        }
+        else
+            check(result.error == INVALID_CHARACTER && result.line == 3, "the error of a projection");
+        check(values == expected[count], "the projection of a json");
+    }
+    check(count == 4 && parser.is_end(), "the jsons projected");
+
+    // the rest is skipped once every path is found, but still must be closed
+    json_projection id;
+    id.add_path("/id");
+    const char bad[] = "{\"id\": 1, \"rest\": [1, 2";
+    json_parser other(bad, sizeof(bad) - 1);
+    check(!id.run(other, result) && result.error == UNCLOSED_OBJECT && !id.get_value(0), "an unclosed json projected");
+
+    // a json cut short in a stream doesn't take the next lines with it
+    const char cut[] = "{\"id\": 1, \"rest\": [1,\n{\"id\": 2}\n{\"id\": 3}\n";
+    json_parser stream(cut, sizeof(cut) - 1);
+    string ids;
+    while (!stream.is_end())
+        ids += id.next_document(stream, result) ? to_text(id.get_value(0)) : "error";
+    check(ids == "error23", "a json cut short projected");
+
+    // labels of the same length and a segment shared by two paths
+    json_projection same;
+    same.add_path("/ab/x");
+    same.add_path("/ba");
+    same.add_path("/ab/y");
+    const char labels[] = "{\"ba\": 1, \"aa\": 2, \"ab\": {\"y\": 3, \"x\": 4}}";
+    json_parser label_parser(labels, sizeof(labels) - 1);
+    check(same.run(label_parser, result) && to_text(same.get_value(0)) == "4"
+        && to_text(same.get_value(1)) == "1" && to_text(same.get_value(2)) == "3", "the labels of a projection");
+}